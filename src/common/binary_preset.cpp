@@ -0,0 +1,316 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "binary_preset.h"
+
+#include "embedded_data.h"
+#include "load_save.h"
+
+#include <cstring>
+
+namespace {
+  const char kPresetMagic[] = "VPRB";
+  constexpr int kPresetMagicSize = 4;
+  constexpr int kPresetHeaderSize = kPresetMagicSize + 2 * sizeof(int32) + 2 * sizeof(int64);
+  constexpr int kChunkEntrySize = 2 * sizeof(int64);
+  // Newest version whose upgrade code rewrites audio fields as text. LoadSave converts sample buffers before
+  // 0.3.7 and WavetableCreator converts wavetable audio through 0.3.8.
+  const char kLastAudioUpgradeVersion[] = "0.3.8";
+
+  struct PresetChunk {
+    int64 offset;
+    int64 size;
+  };
+
+  struct PresetLayout {
+    std::vector<PresetChunk> chunks;
+    int64 state_offset;
+    int64 state_size;
+  };
+
+  bool isAudioField(const std::string& key) {
+    return key == "samples" || key == "samples_stereo" || key == "audio_file" || key == "wave_data";
+  }
+
+  bool chunkInBounds(int64 offset, int64 size, size_t total) {
+    return offset >= 0 && size >= 0 && offset <= (int64)total && size <= (int64)total - offset;
+  }
+
+  bool readLayout(const void* data, size_t size, PresetLayout& layout) {
+    if (!BinaryPreset::isBinary(data, size) || size < kPresetHeaderSize)
+      return false;
+
+    MemoryInputStream stream(data, size, false);
+    stream.skipNextBytes(kPresetMagicSize);
+    int version = stream.readInt();
+    int num_chunks = stream.readInt();
+    layout.state_offset = stream.readInt64();
+    layout.state_size = stream.readInt64();
+
+    if (version < 1 || version > BinaryPreset::kFormatVersion || num_chunks < 0)
+      return false;
+    if (!chunkInBounds(kPresetHeaderSize, (int64)num_chunks * kChunkEntrySize, size))
+      return false;
+    if (!chunkInBounds(layout.state_offset, layout.state_size, size))
+      return false;
+
+    layout.chunks.resize(num_chunks);
+    for (PresetChunk& chunk : layout.chunks) {
+      chunk.offset = stream.readInt64();
+      chunk.size = stream.readInt64();
+      if (!chunkInBounds(chunk.offset, chunk.size, size))
+        return false;
+    }
+    return true;
+  }
+
+  bool parseState(const void* data, const PresetLayout& layout, json& state) {
+    try {
+      const char* start = static_cast<const char*>(data) + layout.state_offset;
+      state = json::from_msgpack(start, static_cast<size_t>(layout.state_size));
+      return true;
+    }
+    catch (const json::exception& e) {
+      return false;
+    }
+  }
+
+  // Moves base64 audio fields into chunks, leaving the chunk index in the tree.
+  bool extractChunks(json& value, std::vector<MemoryBlock>& chunks) {
+    if (value.is_array()) {
+      for (json& element : value) {
+        if (!extractChunks(element, chunks))
+          return false;
+      }
+      return true;
+    }
+    if (!value.is_object())
+      return true;
+
+    for (auto field = value.begin(); field != value.end(); ++field) {
+      json& child = field.value();
+      if (!isAudioField(field.key())) {
+        if (!extractChunks(child, chunks))
+          return false;
+        continue;
+      }
+
+      if (child.is_number_integer())
+        return false;
+      if (!child.is_string() || child.get_ref<const std::string&>().empty())
+        continue;
+
+      const std::string& encoded = child.get_ref<const std::string&>();
+      MemoryOutputStream decoded;
+      Base64::convertFromBase64(decoded, encoded);
+      if (Base64::toBase64(decoded.getData(), decoded.getDataSize()).toStdString() != encoded)
+        continue;
+
+      child = (int)chunks.size();
+      chunks.push_back(decoded.getMemoryBlock());
+    }
+    return true;
+  }
+
+  // Swaps chunk indices in audio fields for whatever replace returns.
+  template <typename Replace>
+  bool restoreChunks(json& value, int num_chunks, Replace replace) {
+    if (value.is_array()) {
+      for (json& element : value) {
+        if (!restoreChunks(element, num_chunks, replace))
+          return false;
+      }
+      return true;
+    }
+    if (!value.is_object())
+      return true;
+
+    for (auto field = value.begin(); field != value.end(); ++field) {
+      json& child = field.value();
+      if (!isAudioField(field.key()) || !child.is_number_integer()) {
+        if (!restoreChunks(child, num_chunks, replace))
+          return false;
+        continue;
+      }
+
+      int index = child;
+      if (index < 0 || index >= num_chunks)
+        return false;
+      child = replace(index);
+    }
+    return true;
+  }
+
+  int64 alignOffset(int64 offset) {
+    int64 alignment = BinaryPreset::kChunkAlignment;
+    return ((offset + alignment - 1) / alignment) * alignment;
+  }
+} // namespace
+
+bool BinaryPreset::isBinary(const File& file) {
+  FileInputStream stream(file);
+  if (!stream.openedOk())
+    return false;
+
+  char magic[kPresetMagicSize];
+  if (stream.read(magic, kPresetMagicSize) != kPresetMagicSize)
+    return false;
+  return isBinary(magic, kPresetMagicSize);
+}
+
+bool BinaryPreset::isBinary(const void* data, size_t size) {
+  return data && size >= kPresetMagicSize && memcmp(data, kPresetMagic, kPresetMagicSize) == 0;
+}
+
+MemoryBlock BinaryPreset::fromJson(const json& state) {
+  json tree = state;
+  std::vector<MemoryBlock> chunks;
+  if (!extractChunks(tree, chunks))
+    return MemoryBlock();
+
+  std::vector<uint8_t> packed = json::to_msgpack(tree);
+  int64 state_offset = kPresetHeaderSize + (int64)chunks.size() * kChunkEntrySize;
+  int64 offset = alignOffset(state_offset + (int64)packed.size());
+
+  MemoryOutputStream stream;
+  stream.write(kPresetMagic, kPresetMagicSize);
+  stream.writeInt(kFormatVersion);
+  stream.writeInt((int)chunks.size());
+  stream.writeInt64(state_offset);
+  stream.writeInt64((int64)packed.size());
+
+  for (const MemoryBlock& chunk : chunks) {
+    stream.writeInt64(offset);
+    stream.writeInt64((int64)chunk.getSize());
+    offset = alignOffset(offset + (int64)chunk.getSize());
+  }
+
+  stream.write(packed.data(), packed.size());
+  for (const MemoryBlock& chunk : chunks) {
+    stream.writeRepeatedByte(0, (size_t)(alignOffset(stream.getPosition()) - stream.getPosition()));
+    stream.write(chunk.getData(), chunk.getSize());
+  }
+
+  return stream.getMemoryBlock();
+}
+
+bool BinaryPreset::toJson(const void* data, size_t size, json& state) {
+  PresetLayout layout;
+  if (!readLayout(data, size, layout) || !parseState(data, layout, state))
+    return false;
+
+  const char* bytes = static_cast<const char*>(data);
+  return restoreChunks(state, (int)layout.chunks.size(), [&](int index) {
+    const PresetChunk& chunk = layout.chunks[index];
+    return json(Base64::toBase64(bytes + chunk.offset, (size_t)chunk.size).toStdString());
+  });
+}
+
+bool BinaryPreset::readState(const void* data, size_t size, json& state) {
+  PresetLayout layout;
+  return readLayout(data, size, layout) && parseState(data, layout, state);
+}
+
+bool BinaryPreset::readState(const File& file, json& state) {
+  MemoryMappedFile mapped(file, MemoryMappedFile::readOnly);
+  return readState(mapped.getData(), mapped.getSize(), state);
+}
+
+bool BinaryPreset::writeFile(const File& file, const json& state) {
+  MemoryBlock data = fromJson(state);
+  if (data.getSize() == 0)
+    return false;
+
+  TemporaryFile temporary(file);
+  if (!temporary.getFile().replaceWithData(data.getData(), data.getSize()))
+    return false;
+  return temporary.overwriteTargetFileWithTemporary();
+}
+
+bool BinaryPreset::convertFile(const File& source, const File& destination) {
+  if (isBinary(source)) {
+    MemoryBlock data;
+    json state;
+    if (!source.loadFileAsData(data) || !toJson(data.getData(), data.getSize(), state))
+      return false;
+    return destination.replaceWithText(state.dump());
+  }
+
+  try {
+    json state = json::parse(source.loadFileAsString().toStdString(), nullptr);
+    return writeFile(destination, state);
+  }
+  catch (const json::exception& e) {
+    return false;
+  }
+}
+
+BinaryPreset::~BinaryPreset() {
+  close();
+}
+
+bool BinaryPreset::open(const File& file) {
+  close();
+
+  mapped_file_ = std::make_unique<MemoryMappedFile>(file, MemoryMappedFile::readOnly);
+  const void* data = mapped_file_->getData();
+  size_t size = mapped_file_->getSize();
+
+  PresetLayout layout;
+  if (!readLayout(data, size, layout) || !parseState(data, layout, state_)) {
+    close();
+    return false;
+  }
+
+  // Old presets go through upgrade code that edits the base64 text, so they get text back.
+  bool upgrade = !state_.count("synth_version") || !state_["synth_version"].is_string() ||
+                 LoadSave::compareVersionStrings(state_["synth_version"].get<std::string>(),
+                                                 kLastAudioUpgradeVersion) <= 0;
+
+  const char* bytes = static_cast<const char*>(data);
+  bool restored = false;
+  if (upgrade) {
+    restored = restoreChunks(state_, (int)layout.chunks.size(), [&](int index) {
+      const PresetChunk& chunk = layout.chunks[index];
+      return json(Base64::toBase64(bytes + chunk.offset, (size_t)chunk.size).toStdString());
+    });
+  }
+  else {
+    vital::EmbeddedData& embedded_data = vital::EmbeddedData::instance();
+    std::vector<int> ids;
+    for (const PresetChunk& chunk : layout.chunks)
+      ids.push_back(embedded_data.add(bytes + chunk.offset, (size_t)chunk.size));
+    embedded_ids_ = ids;
+
+    restored = restoreChunks(state_, (int)ids.size(), [&](int index) {
+      return vital::EmbeddedData::reference(ids[index]);
+    });
+  }
+
+  if (!restored) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void BinaryPreset::close() {
+  for (int id : embedded_ids_)
+    vital::EmbeddedData::instance().remove(id);
+  embedded_ids_.clear();
+  state_ = json();
+  mapped_file_ = nullptr;
+}
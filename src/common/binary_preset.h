@@ -0,0 +1,64 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "json/json.h"
+
+#include <memory>
+#include <vector>
+
+using json = nlohmann::json;
+
+// Binary alternative to the json preset format. The state tree is stored as MessagePack and every base64 audio
+// field is moved into a raw little endian chunk. Opening a preset maps the file and registers the chunks as
+// embedded data so loaders read audio in place. Conversion to and from json is lossless.
+class BinaryPreset {
+  public:
+    static constexpr int kFormatVersion = 1;
+    static constexpr int kChunkAlignment = 16;
+
+    static bool isBinary(const File& file);
+    static bool isBinary(const void* data, size_t size);
+
+    // Audio fields whose base64 text wouldn't come back identical stay inline as text.
+    static MemoryBlock fromJson(const json& state);
+    static bool toJson(const void* data, size_t size, json& state);
+
+    // Reads the state tree alone with audio fields left as chunk indices, for metadata.
+    static bool readState(const void* data, size_t size, json& state);
+    static bool readState(const File& file, json& state);
+
+    static bool writeFile(const File& file, const json& state);
+    static bool convertFile(const File& source, const File& destination);
+
+    BinaryPreset() = default;
+    ~BinaryPreset();
+
+    bool open(const File& file);
+    void close();
+
+    // State with audio fields referring to the mapped chunks. Only valid while this preset is open.
+    const json& getState() const { return state_; }
+
+  private:
+    std::unique_ptr<MemoryMappedFile> mapped_file_;
+    std::vector<int> embedded_ids_;
+    json state_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BinaryPreset)
+};
@@ -173,14 +173,43 @@ namespace vital {
   template <size_t bits>
   class FFT {
     public:
+      // Some backends keep a scratch buffer, so a worker thread transforming alongside others
+      // holds one of these for the duration of its work to use its own instance.
+      class ThreadInstance {
+        public:
+          ThreadInstance() : fourier_transform_(bits), previous_(threadTransform()) {
+            threadTransform() = &fourier_transform_;
+          }
+          ~ThreadInstance() { threadTransform() = previous_; }
+
+        private:
+          FourierTransform fourier_transform_;
+          FourierTransform* previous_;
+      };
+
       static FourierTransform* transform() {
-        static FFT<bits> instance;
-        return &instance.fourier_transform_;
+        FourierTransform* thread_transform = threadTransform();
+        if (thread_transform)
+          return thread_transform;
+        return &sharedInstance().fourier_transform_;
       }
 
+      // Builds the shared instance so the first caller, which may be the audio thread, doesn't allocate.
+      static void prepare() { sharedInstance(); }
+
     private:
       FFT() : fourier_transform_(bits) { }
 
+      static FFT<bits>& sharedInstance() {
+        static FFT<bits> instance;
+        return instance;
+      }
+
+      static FourierTransform*& threadTransform() {
+        static thread_local FourierTransform* transform = nullptr;
+        return transform;
+      }
+
       FourierTransform fourier_transform_;
   };
 
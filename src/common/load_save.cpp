@@ -15,6 +15,7 @@
  */
 
 #include "load_save.h"
+#include "binary_preset.h"
 #include "modulation_connection_processor.h"
 #include "sound_engine.h"
 #include "midi_manager.h"
@@ -45,6 +46,42 @@ namespace {
 
     return Time(year, month, day, hour, minute);
   }
+
+  class AudioFileStreamReader : public vital::SampleStream::Reader {
+    public:
+      AudioFileStreamReader(AudioFormatReader* reader) : reader_(reader) { }
+
+      int64_t length() const override { return reader_->lengthInSamples; }
+      int sampleRate() const override { return static_cast<int>(reader_->sampleRate); }
+      bool stereo() const override { return reader_->numChannels > 1; }
+
+      void read(vital::mono_float* left, vital::mono_float* right, int64_t start, int num_samples) override {
+        int num_channels = right ? 2 : 1;
+        vital::mono_float* destinations[] = { left, right };
+        reader_->read(destinations, num_channels, start, num_samples);
+      }
+
+    private:
+      std::unique_ptr<AudioFormatReader> reader_;
+  };
+
+  // Presets store the absolute path of streamed audio. Where that doesn't exist, e.g. on another machine, the
+  // file is looked up by name in the sample folders.
+  File findStreamFile(const std::string& path) {
+    if (File::isAbsolutePath(path) && File(path).existsAsFile())
+      return File(path);
+
+    String file_name = String(path).fromLastOccurrenceOf("/", false, false).fromLastOccurrenceOf("\\", false, false);
+    if (file_name.isEmpty())
+      return File();
+
+    for (const File& directory : LoadSave::getSampleDirectories()) {
+      Array<File> matches = directory.findChildFiles(File::findFiles, true, file_name);
+      if (!matches.isEmpty())
+        return matches[0];
+    }
+    return File();
+  }
 } // namespace
 
 const std::string LoadSave::kUserDirectoryName = "User";
@@ -172,6 +209,9 @@ void LoadSave::loadModulations(SynthBase* synth, const json& modulations) {
   vital::ModulationConnectionBank& modulation_bank = synth->getModulationBank();
   int index = 0;
   for (const json& modulation : modulations) {
+    if (index >= vital::kMaxModulationConnections)
+      break;
+
     std::string source = modulation["source"];
     std::string destination = modulation["destination"];
     vital::ModulationConnection* connection = modulation_bank.atIndex(index);
@@ -198,7 +238,42 @@ void LoadSave::loadModulations(SynthBase* synth, const json& modulations) {
 void LoadSave::loadSample(SynthBase* synth, const json& json_sample) {
   vital::Sample* sample = synth->getSample();
   if (sample)
-    sample->jsonToState(json_sample);
+    loadSampleState(sample, json_sample);
+}
+
+bool LoadSave::loadSampleState(vital::Sample* sample, const json& data) {
+  if (data.count("stream_file") == 0) {
+    sample->jsonToState(data);
+    return true;
+  }
+
+  std::string path = data["stream_file"];
+  File file = findStreamFile(path);
+  if (file.existsAsFile() && loadSampleStream(sample, file)) {
+    if (data.count("name"))
+      sample->setName(data["name"].get<std::string>());
+    return true;
+  }
+
+  writeErrorLog("Streamed sample file not found: " + path);
+  sample->jsonToState(data);
+  return false;
+}
+
+bool LoadSave::loadSampleStream(vital::Sample* sample, const File& file) {
+  AudioFormatManager format_manager;
+  format_manager.registerBasicFormats();
+  AudioFormatReader* format_reader = format_manager.createReaderFor(file);
+  if (format_reader == nullptr)
+    return false;
+
+  std::unique_ptr<AudioFileStreamReader> reader = std::make_unique<AudioFileStreamReader>(format_reader);
+  if (reader->length() <= 0 || reader->sampleRate() <= 0)
+    return false;
+
+  sample->loadStream(std::move(reader), file.getFullPathName().toStdString());
+  sample->setName(file.getFileNameWithoutExtension().toStdString());
+  return true;
 }
 
 void LoadSave::loadWavetables(SynthBase* synth, const json& wavetables) {
@@ -208,8 +283,10 @@ void LoadSave::loadWavetables(SynthBase* synth, const json& wavetables) {
   int i = 0;
   for (const json& wavetable : wavetables) {
     WavetableCreator* wavetable_creator = synth->getWavetableCreator(i);
-    wavetable_creator->jsonToState(wavetable);
-    wavetable_creator->render();
+    if (wavetable_creator->stateToJson() != wavetable) {
+      wavetable_creator->jsonToState(wavetable);
+      wavetable_creator->render();
+    }
     i++;
   }
 }
@@ -1024,7 +1101,7 @@ json LoadSave::updateFromOldVersion(json state) {
   return state;
 }
 
-bool LoadSave::jsonToState(SynthBase* synth, std::map<std::string, String>& save_info, json data) {
+bool LoadSave::updateState(json& data) {
   std::string version = data["synth_version"];
   
   int compare_feature_versions = compareFeatureVersionStrings(version, ProjectInfo::versionString);
@@ -1034,20 +1111,33 @@ bool LoadSave::jsonToState(SynthBase* synth, std::map<std::string, String>& save
   int compare_versions = compareVersionStrings(version, ProjectInfo::versionString);
   if (compare_versions < 0 || data["settings"].count("sub_octave"))
     data = updateFromOldVersion(data);
-  
+
+  return true;
+}
+
+void LoadSave::loadEngineState(SynthBase* synth, std::map<std::string, String>& save_info, const json& data) {
   json settings = data["settings"];
   json modulations = settings["modulations"];
-  json sample = settings["sample"];
-  json wavetables = settings["wavetables"];
   json lfos = settings["lfos"];
 
   loadControls(synth, settings);
   loadModulations(synth, modulations);
-  loadSample(synth, sample);
-  loadWavetables(synth, wavetables);
   loadLfos(synth, lfos);
   loadSaveState(save_info, data);
   synth->checkOversampling();
+}
+
+bool LoadSave::jsonToState(SynthBase* synth, std::map<std::string, String>& save_info, json data) {
+  if (!updateState(data))
+    return false;
+  
+  json settings = data["settings"];
+  json sample = settings["sample"];
+  json wavetables = settings["wavetables"];
+
+  loadSample(synth, sample);
+  loadWavetables(synth, wavetables);
+  loadEngineState(synth, save_info, data);
   
   return true;
 }
@@ -1055,6 +1145,13 @@ bool LoadSave::jsonToState(SynthBase* synth, std::map<std::string, String>& save
 String LoadSave::getAuthorFromFile(const File& file) {
   static constexpr int kMaxCharacters = 40;
   static constexpr int kMinSize = 60;
+  if (BinaryPreset::isBinary(file)) {
+    json state;
+    if (BinaryPreset::readState(file, state))
+      return getAuthor(state);
+    return "";
+  }
+
   FileInputStream file_stream(file);
 
   if (file_stream.getTotalLength() < kMinSize)
@@ -1093,6 +1190,13 @@ String LoadSave::getAuthorFromFile(const File& file) {
 
 String LoadSave::getStyleFromFile(const File& file) {
   static constexpr int kMinSize = 5000;
+  if (BinaryPreset::isBinary(file)) {
+    json state;
+    if (BinaryPreset::readState(file, state) && state.count("preset_style") && state["preset_style"].is_string())
+      return state["preset_style"].get<std::string>();
+    return "";
+  }
+
   FileInputStream file_stream(file);
 
   if (file_stream.getTotalLength() < kMinSize)
@@ -1181,6 +1285,25 @@ File LoadSave::getFavoritesFile() {
 #endif
 }
 
+File LoadSave::getPresetIndexFile() {
+#if defined(JUCE_DATA_STRUCTURES_H_INCLUDED)
+  PropertiesFile::Options config_options;
+  config_options.applicationName = "Vial";
+  config_options.osxLibrarySubFolder = "Application Support";
+  config_options.filenameSuffix = "presetindex";
+
+#ifdef LINUX
+  config_options.folderName = "." + String(ProjectInfo::projectName).toLowerCase();
+#else
+  config_options.folderName = String(ProjectInfo::projectName).toLowerCase();
+#endif
+
+  return config_options.getDefaultFile();
+#else
+  return File();
+#endif
+}
+
 File LoadSave::getDefaultSkin() {
 #if defined(JUCE_DATA_STRUCTURES_H_INCLUDED)
   PropertiesFile::Options config_options;
@@ -1630,6 +1753,27 @@ int LoadSave::getOversamplingAmount() {
   return data["oversampling_amount"];
 }
 
+File LoadSave::getWavetableCacheDirectory() {
+  json data = getConfigJson();
+
+  if (!data.count("wavetable_cache_directory"))
+    return File();
+
+  std::string path = data["wavetable_cache_directory"];
+  if (path.empty() || !File::isAbsolutePath(path))
+    return File();
+  return File(path);
+}
+
+bool LoadSave::shouldStreamLongSamples() {
+  json data = getConfigJson();
+
+  if (!data.count("stream_long_samples"))
+    return false;
+
+  return data["stream_long_samples"];
+}
+
 float LoadSave::loadWindowSize() {
   static constexpr float kMinWindowSize = 0.25f;
   
@@ -26,6 +26,7 @@
 using json = nlohmann::json;
 
 namespace vital {
+  class Sample;
   class StringLayout;
 }
 
@@ -76,12 +77,16 @@ class LoadSave {
     static void loadControls(SynthBase* synth, const json& data);
     static void loadModulations(SynthBase* synth, const json& modulations);
     static void loadSample(SynthBase* synth, const json& sample);
+    static bool loadSampleState(vital::Sample* sample, const json& data);
+    static bool loadSampleStream(vital::Sample* sample, const File& file);
     static void loadWavetables(SynthBase* synth, const json& wavetables);
     static void loadLfos(SynthBase* synth, const json& lfos);
     static void loadSaveState(std::map<std::string, String>& save_info, json data);
 
     static void initSaveInfo(std::map<std::string, String>& save_info);
     static json updateFromOldVersion(json state);
+    static bool updateState(json& state);
+    static void loadEngineState(SynthBase* synth, std::map<std::string, String>& save_info, const json& state);
     static bool jsonToState(SynthBase* synth, std::map<std::string, String>& save_info, json state);
 
     static String getAuthorFromFile(const File& file);
@@ -94,6 +99,7 @@ class LoadSave {
     static void writeErrorLog(String error_log);
     static json getConfigJson();
     static File getFavoritesFile();
+    static File getPresetIndexFile();
     static File getDefaultSkin();
     static json getFavoritesJson();
     static void addFavorite(const File& new_favorite);
@@ -120,6 +126,8 @@ class LoadSave {
     static bool displayHzFrequency();
     static bool authenticated();
     static int getOversamplingAmount();
+    static File getWavetableCacheDirectory();
+    static bool shouldStreamLongSamples();
     static float loadWindowSize();
     static String loadVersion();
     static String loadContentVersion();
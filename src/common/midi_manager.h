@@ -80,7 +80,7 @@ class MidiManager : public MidiInputCallback {
     class Listener {
       public:
         virtual ~Listener() { }
-        virtual void valueChangedThroughMidi(const std::string& name, vital::mono_float value) = 0;
+        virtual void valueChangedThroughMidi(int id, vital::mono_float value) = 0;
         virtual void pitchWheelMidiChanged(vital::mono_float value) = 0;
         virtual void modWheelMidiChanged(vital::mono_float value) = 0;
         virtual void presetChangedThroughMidi(File preset) = 0;
@@ -96,6 +96,7 @@ class MidiManager : public MidiInputCallback {
     void midiInput(int control, vital::mono_float value);
     void processMidiMessage(const MidiMessage &midi_message, int sample_position = 0);
     bool isMidiMapped(const std::string& name) const;
+    bool isMidiControlled(int control) const { return armed_value_ || midi_learn_map_.count(control); }
 
     void setSampleRate(double sample_rate);
     void removeNextBlockOfMessages(MidiBuffer& buffer, int num_samples);
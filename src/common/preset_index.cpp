@@ -0,0 +1,406 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "preset_index.h"
+#include "binary_preset.h"
+#include "asset_cache.h"
+#include "load_save.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr char kIndexMagic[4] = { 'V', 'P', 'I', 'X' };
+
+  std::string hashData(const MemoryBlock& data) {
+    return vital::AssetKey().add(data.getData(), data.getSize()).toString();
+  }
+
+  std::string getStringField(const json& state, const std::string& field) {
+    if (state.count(field) && state[field].is_string())
+      return state[field];
+    return "";
+  }
+
+  std::vector<std::string> tokenize(const String& text) {
+    StringArray words;
+    words.addTokens(text.toLowerCase(), " \t\r\n", "");
+    words.removeEmptyStrings();
+
+    std::set<std::string> unique_words;
+    for (const String& word : words)
+      unique_words.insert(word.toStdString());
+    return std::vector<std::string>(unique_words.begin(), unique_words.end());
+  }
+
+  void parseEntry(const MemoryBlock& data, PresetIndex::Entry& entry) {
+    std::string comments;
+    try {
+      json state;
+      if (!BinaryPreset::readState(data.getData(), data.getSize(), state)) {
+        std::string text(static_cast<const char*>(data.getData()), data.getSize());
+        state = json::parse(text, nullptr, false);
+      }
+      if (state.is_object()) {
+        entry.author = getStringField(state, "author");
+        entry.style = String(getStringField(state, "preset_style")).toLowerCase().toStdString();
+        comments = getStringField(state, "comments");
+      }
+    }
+    catch (const json::exception& e) {
+    }
+
+    String text = String(entry.name) + " " + String(entry.author) + " " + String(entry.style) + " " + String(comments);
+    entry.tokens = tokenize(text);
+  }
+
+  void writeStrings(OutputStream& output, const std::vector<std::string>& strings) {
+    output.writeInt(static_cast<int>(strings.size()));
+    for (const std::string& string : strings)
+      output.writeString(string);
+  }
+
+  bool readCount(InputStream& input, int& count) {
+    count = input.readInt();
+    return count >= 0 && count <= input.getNumBytesRemaining();
+  }
+
+  bool readStrings(InputStream& input, std::vector<std::string>& strings) {
+    int count = 0;
+    if (!readCount(input, count))
+      return false;
+
+    strings.clear();
+    strings.reserve(count);
+    for (int i = 0; i < count; ++i)
+      strings.push_back(input.readString().toStdString());
+    return true;
+  }
+
+  bool readMagic(InputStream& input) {
+    char magic[sizeof(kIndexMagic)] = { };
+    return input.read(magic, sizeof(kIndexMagic)) == sizeof(kIndexMagic) &&
+           memcmp(magic, kIndexMagic, sizeof(kIndexMagic)) == 0;
+  }
+
+  bool isInFolder(const std::string& path, const std::string& folder) {
+    std::string separator = String(File::getSeparatorString()).toStdString();
+    return path.size() > folder.size() + separator.size() && path.compare(0, folder.size(), folder) == 0 &&
+           path.compare(folder.size(), separator.size(), separator) == 0;
+  }
+} // namespace
+
+constexpr int PresetIndex::kFormatVersion;
+
+bool PresetIndex::Entry::matches(const StringArray& search_tokens) const {
+  for (const String& search_token : search_tokens) {
+    std::string search = search_token.toStdString();
+    bool found = false;
+    for (const std::string& token : tokens) {
+      if (token.find(search) != std::string::npos) {
+        found = true;
+        break;
+      }
+    }
+
+    if (!found)
+      return false;
+  }
+  return true;
+}
+
+PresetIndex::Entry PresetIndex::readEntry(const File& preset) {
+  Entry entry;
+  entry.name = preset.getFileNameWithoutExtension().toStdString();
+  entry.modified = preset.getLastModificationTime().toMilliseconds();
+  entry.size = preset.getSize();
+
+  MemoryBlock data;
+  if (preset.loadFileAsData(data))
+    entry.hash = hashData(data);
+  parseEntry(data, entry);
+  return entry;
+}
+
+std::shared_ptr<const PresetIndex::EntryMap> PresetIndex::entries() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_;
+}
+
+bool PresetIndex::hasScanned() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return scanned_;
+}
+
+bool PresetIndex::getPresets(const File& folder, Array<File>& presets) {
+  std::shared_ptr<const EntryMap> entries;
+  std::vector<std::string> roots;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!scanned_)
+      return false;
+    entries = entries_;
+    roots = roots_;
+  }
+
+  presets.clear();
+  if (folder == File()) {
+    for (auto& entry : *entries)
+      presets.add(File(entry.first));
+    return true;
+  }
+
+  std::string folder_path = folder.getFullPathName().toStdString();
+  bool indexed = false;
+  for (const std::string& root : roots)
+    indexed = indexed || folder_path == root || isInFolder(folder_path, root);
+  if (!indexed)
+    return false;
+
+  auto entry = entries->lower_bound(folder_path + String(File::getSeparatorString()).toStdString());
+  for (; entry != entries->end() && isInFolder(entry->first, folder_path); ++entry)
+    presets.add(File(entry->first));
+  return true;
+}
+
+bool PresetIndex::update(const std::vector<File>& roots, const std::function<bool()>& should_exit) {
+  std::lock_guard<std::mutex> update_lock(update_mutex_);
+
+  std::shared_ptr<const EntryMap> old_entries;
+  std::vector<std::string> old_roots;
+  std::set<std::string> invalid_directories;
+  bool scanned = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    old_entries = entries_;
+    old_roots = roots_;
+    scanned = scanned_;
+    invalid_directories.swap(invalid_directories_);
+  }
+
+  DirectoryMap old_directories = directories_;
+  for (const std::string& invalid_directory : invalid_directories)
+    old_directories.erase(invalid_directory);
+
+  DirectoryMap directories;
+  std::shared_ptr<EntryMap> entries = std::make_shared<EntryMap>();
+  std::vector<std::string> root_paths;
+  int num_changes = 0;
+  for (const File& root : roots) {
+    if (root.isDirectory()) {
+      root_paths.push_back(root.getFullPathName().toStdString());
+      scanDirectory(root, old_directories, *old_entries, directories, *entries, num_changes, should_exit);
+    }
+  }
+
+  if (should_exit && should_exit()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    invalid_directories_.insert(invalid_directories.begin(), invalid_directories.end());
+    return false;
+  }
+
+  // Readers compare snapshots to see if anything changed so keep the old one when nothing did.
+  bool changed = !scanned || num_changes || entries->size() != old_entries->size() || root_paths != old_roots;
+  directories_ = std::move(directories);
+  if (changed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_ = entries;
+    roots_ = root_paths;
+    scanned_ = true;
+  }
+  return changed;
+}
+
+void PresetIndex::scanDirectory(const File& directory, const DirectoryMap& old_directories,
+                                const EntryMap& old_entries, DirectoryMap& directories, EntryMap& entries,
+                                int& num_changes, const std::function<bool()>& should_exit) {
+  std::string path = directory.getFullPathName().toStdString();
+  if ((should_exit && should_exit()) || directories.count(path))
+    return;
+
+  int64 modified = directory.getLastModificationTime().toMilliseconds();
+  auto old_directory = old_directories.find(path);
+  bool unchanged = old_directory != old_directories.end() && old_directory->second.modified == modified;
+
+  Directory& scanned_directory = directories[path];
+  if (unchanged)
+    scanned_directory = old_directory->second;
+  else {
+    scanned_directory.modified = modified;
+    Array<File> children;
+    directory.findChildFiles(children, File::findFiles, false, String("*.") + vital::kPresetExtension);
+    for (const File& child : children)
+      scanned_directory.files.push_back(child.getFullPathName().toStdString());
+
+    children.clear();
+    directory.findChildFiles(children, File::findDirectories, false);
+    for (const File& child : children)
+      scanned_directory.subdirectories.push_back(child.getFullPathName().toStdString());
+    num_changes++;
+  }
+
+  for (const std::string& file_path : scanned_directory.files) {
+    if (should_exit && should_exit())
+      return;
+
+    auto old_entry = old_entries.find(file_path);
+    if (unchanged && old_entry != old_entries.end()) {
+      entries[file_path] = old_entry->second;
+      continue;
+    }
+
+    File file(file_path);
+    int64 file_modified = file.getLastModificationTime().toMilliseconds();
+    int64 file_size = file.getSize();
+    if (old_entry != old_entries.end() && old_entry->second.modified == file_modified &&
+        old_entry->second.size == file_size) {
+      entries[file_path] = old_entry->second;
+      continue;
+    }
+
+    Entry entry;
+    entry.name = file.getFileNameWithoutExtension().toStdString();
+    entry.modified = file_modified;
+    entry.size = file_size;
+
+    MemoryBlock data;
+    if (file.loadFileAsData(data))
+      entry.hash = hashData(data);
+
+    if (old_entry != old_entries.end() && old_entry->second.hash == entry.hash) {
+      entries[file_path] = old_entry->second;
+      entries[file_path].modified = file_modified;
+      entries[file_path].size = file_size;
+    }
+    else {
+      parseEntry(data, entry);
+      entries[file_path] = std::move(entry);
+    }
+    num_changes++;
+  }
+
+  std::vector<std::string> subdirectories = scanned_directory.subdirectories;
+  for (const std::string& subdirectory : subdirectories) {
+    scanDirectory(File(subdirectory), old_directories, old_entries, directories, entries,
+                  num_changes, should_exit);
+  }
+}
+
+void PresetIndex::invalidate(const File& file) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  invalid_directories_.insert(file.getParentDirectory().getFullPathName().toStdString());
+  if (file.isDirectory())
+    invalid_directories_.insert(file.getFullPathName().toStdString());
+}
+
+bool PresetIndex::load(const File& index_file) {
+  MemoryBlock data;
+  if (!index_file.existsAsFile() || !index_file.loadFileAsData(data))
+    return false;
+
+  MemoryInputStream input(data, false);
+  if (!readMagic(input) || input.readInt() != kFormatVersion)
+    return false;
+
+  std::vector<std::string> roots;
+  DirectoryMap directories;
+  std::shared_ptr<EntryMap> entries = std::make_shared<EntryMap>();
+  int num_directories = 0;
+  if (!readStrings(input, roots) || !readCount(input, num_directories))
+    return false;
+
+  for (int i = 0; i < num_directories; ++i) {
+    std::string path = input.readString().toStdString();
+    Directory& directory = directories[path];
+    directory.modified = input.readInt64();
+    if (!readStrings(input, directory.files) || !readStrings(input, directory.subdirectories))
+      return false;
+  }
+
+  int num_entries = 0;
+  if (!readCount(input, num_entries))
+    return false;
+
+  for (int i = 0; i < num_entries; ++i) {
+    std::string path = input.readString().toStdString();
+    Entry& entry = (*entries)[path];
+    entry.name = input.readString().toStdString();
+    entry.author = input.readString().toStdString();
+    entry.style = input.readString().toStdString();
+    entry.modified = input.readInt64();
+    entry.size = input.readInt64();
+    entry.hash = input.readString().toStdString();
+    if (!readStrings(input, entry.tokens))
+      return false;
+  }
+
+  // The magic is repeated at the end so a truncated index doesn't load as a smaller one.
+  if (!readMagic(input) || input.getNumBytesRemaining() != 0)
+    return false;
+
+  std::lock_guard<std::mutex> update_lock(update_mutex_);
+  directories_ = std::move(directories);
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_ = entries;
+  roots_ = roots;
+  scanned_ = true;
+  return true;
+}
+
+bool PresetIndex::save(const File& index_file) {
+  std::shared_ptr<const EntryMap> entries;
+  std::vector<std::string> roots;
+  MemoryOutputStream output;
+  {
+    std::lock_guard<std::mutex> update_lock(update_mutex_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      entries = entries_;
+      roots = roots_;
+    }
+
+    output.write(kIndexMagic, sizeof(kIndexMagic));
+    output.writeInt(kFormatVersion);
+    writeStrings(output, roots);
+    output.writeInt(static_cast<int>(directories_.size()));
+    for (auto& directory : directories_) {
+      output.writeString(directory.first);
+      output.writeInt64(directory.second.modified);
+      writeStrings(output, directory.second.files);
+      writeStrings(output, directory.second.subdirectories);
+    }
+  }
+
+  output.writeInt(static_cast<int>(entries->size()));
+  for (auto& entry : *entries) {
+    output.writeString(entry.first);
+    output.writeString(entry.second.name);
+    output.writeString(entry.second.author);
+    output.writeString(entry.second.style);
+    output.writeInt64(entry.second.modified);
+    output.writeInt64(entry.second.size);
+    output.writeString(entry.second.hash);
+    writeStrings(output, entry.second.tokens);
+  }
+  output.write(kIndexMagic, sizeof(kIndexMagic));
+
+  if (!index_file.getParentDirectory().createDirectory())
+    return false;
+
+  // Write to a temporary file first so another instance never loads a partial index.
+  TemporaryFile temporary_file(index_file);
+  if (!temporary_file.getFile().replaceWithData(output.getData(), output.getDataSize()))
+    return false;
+  return temporary_file.overwriteTargetFileWithTemporary();
+}
@@ -0,0 +1,95 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// Metadata for every preset under the preset directories so the browser can list, sort and search without
+// opening files. Updates rescan only directories whose modification time changed and reparse only presets
+// whose size, modification time and content hash changed. Readers get an immutable snapshot.
+class PresetIndex {
+  public:
+    static constexpr int kFormatVersion = 1;
+
+    struct Entry {
+      std::string name;
+      std::string author;
+      std::string style;
+      int64 modified = 0;
+      int64 size = 0;
+      std::string hash;
+      std::vector<std::string> tokens;
+
+      bool matches(const StringArray& search_tokens) const;
+    };
+
+    struct Directory {
+      int64 modified = 0;
+      std::vector<std::string> files;
+      std::vector<std::string> subdirectories;
+    };
+
+    typedef std::map<std::string, Entry> EntryMap;
+    typedef std::map<std::string, Directory> DirectoryMap;
+
+    static PresetIndex& instance() {
+      static PresetIndex index;
+      return index;
+    }
+
+    static Entry readEntry(const File& preset);
+
+    PresetIndex() : entries_(std::make_shared<EntryMap>()), scanned_(false) { }
+
+    std::shared_ptr<const EntryMap> entries();
+    bool hasScanned();
+
+    // Fills presets with everything indexed under folder, or under every root when folder is File().
+    // Returns false when the index can't answer for that folder so the caller should list it itself.
+    bool getPresets(const File& folder, Array<File>& presets);
+
+    // Brings the index up to date with roots. Returns true if anything changed.
+    bool update(const std::vector<File>& roots, const std::function<bool()>& should_exit = nullptr);
+
+    // Forces the directory holding file to be rescanned on the next update, for writes that may keep the
+    // directory modification time, like overwriting a preset in place.
+    void invalidate(const File& file);
+
+    bool load(const File& index_file);
+    bool save(const File& index_file);
+
+  private:
+    void scanDirectory(const File& directory, const DirectoryMap& old_directories, const EntryMap& old_entries,
+                       DirectoryMap& directories, EntryMap& entries, int& num_changes,
+                       const std::function<bool()>& should_exit);
+
+    std::mutex mutex_;
+    std::mutex update_mutex_;
+    std::shared_ptr<const EntryMap> entries_;
+    DirectoryMap directories_;
+    std::vector<std::string> roots_;
+    std::set<std::string> invalid_directories_;
+    bool scanned_;
+};
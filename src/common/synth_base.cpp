@@ -15,22 +15,28 @@
  */
 
 #include "synth_base.h"
+#include "binary_preset.h"
+#include "fourier_transform.h"
 
 #include "sample_source.h"
 #include "sound_engine.h"
 #include "load_save.h"
-#include "memory.h"
+#include "audio_capture.h"
 #include "modulation_connection_processor.h"
 #include "startup.h"
 #include "synth_gui_interface.h"
 #include "synth_parameters.h"
 #include "utils.h"
+#include "wave_frame.h"
+
+#include <thread>
 
 SynthBase::SynthBase() : expired_(false) {
   expired_ = LoadSave::isExpired();
   self_reference_ = std::make_shared<SynthBase*>();
   *self_reference_ = this;
 
+  vital::FFT<vital::WaveFrame::kWaveformBits>::prepare();
   engine_ = std::make_unique<vital::SoundEngine>();
   engine_->setTuning(&tuning_);
 
@@ -49,33 +55,41 @@ SynthBase::SynthBase() : expired_(false) {
 
   last_played_note_ = 0.0f;
   last_num_pressed_ = 0;
-  audio_memory_ = std::make_unique<vital::StereoMemory>(vital::kAudioMemorySamples);
-  memset(oscilloscope_memory_, 0, 2 * vital::kOscilloscopeMemoryResolution * sizeof(vital::poly_float));
-  memset(oscilloscope_memory_write_, 0, 2 * vital::kOscilloscopeMemoryResolution * sizeof(vital::poly_float));
-  memory_reset_period_ = vital::kOscilloscopeMemoryResolution;
-  memory_input_offset_ = 0;
-  memory_index_ = 0;
+  audio_memory_ = std::make_unique<vital::AudioCapture>(vital::kAudioMemorySamples);
 
   controls_ = engine_->getControls();
+  control_events_.reserve(kMaxControlEvents);
+  control_event_index_ = 0;
 
   Startup::doStartupChecks(midi_manager_.get());
 }
 
 SynthBase::~SynthBase() { }
 
+void SynthBase::valueChanged(int id, vital::mono_float value) {
+  if (id < 0 || id >= vital::Parameters::getNumParameters())
+    return;
+
+  vital::Value* control = engine_->getControl(id);
+  if (control)
+    control->set(value);
+}
+
 void SynthBase::valueChanged(const std::string& name, vital::mono_float value) {
-  controls_[name]->set(value);
+  valueChanged(vital::Parameters::getId(name), value);
 }
 
 void SynthBase::valueChangedInternal(const std::string& name, vital::mono_float value) {
-  valueChanged(name, value);
-  setValueNotifyHost(name, value);
+  int id = vital::Parameters::getId(name);
+  valueChanged(id, value);
+  setValueNotifyHost(id, value);
 }
 
-void SynthBase::valueChangedThroughMidi(const std::string& name, vital::mono_float value) {
-  controls_[name]->set(value);
+void SynthBase::valueChangedThroughMidi(int id, vital::mono_float value) {
+  valueChanged(id, value);
+  const std::string& name = vital::Parameters::getDetails(id)->name;
   ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, name, value);
-  setValueNotifyHost(name, value);
+  setValueNotifyHost(id, value);
   callback->post();
 }
 
@@ -105,17 +119,47 @@ void SynthBase::presetChangedThroughMidi(File preset) {
   }
 }
 
-void SynthBase::valueChangedExternal(const std::string& name, vital::mono_float value) {
-  valueChanged(name, value);
-  if (name == "mod_wheel")
+void SynthBase::valueChangedExternal(int id, vital::mono_float value) {
+  static const int kModWheelId = vital::Parameters::getId("mod_wheel");
+  static const int kPitchWheelId = vital::Parameters::getId("pitch_wheel");
+
+  valueChanged(id, value);
+  if (id == kModWheelId)
     engine_->setModWheelAllChannels(value);
-  else if (name == "pitch_wheel")
+  else if (id == kPitchWheelId)
     engine_->setZonedPitchWheel(value, 0, vital::kNumMidiChannels - 1);
 
+  const std::string& name = vital::Parameters::getDetails(id)->name;
   ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, name, value);
   callback->post();
 }
 
+void SynthBase::addControlEvent(int id, vital::mono_float value, int sample) {
+  if (id < 0 || id >= vital::Parameters::getNumParameters())
+    return;
+
+  if (control_events_.size() >= kMaxControlEvents) {
+    valueChangedExternal(id, value);
+    return;
+  }
+
+  // Kept sorted by sample. Events on the same sample keep the order they were added in.
+  auto position = control_events_.end();
+  while (position != control_events_.begin() && (position - 1)->sample > sample)
+    --position;
+  control_events_.insert(position, { id, value, sample });
+}
+
+void SynthBase::valueChangedExternal(const std::string& name, vital::mono_float value) {
+  valueChangedExternal(vital::Parameters::getId(name), value);
+}
+
+void SynthBase::setValueNotifyHost(const std::string& name, vital::mono_float value) {
+  int id = vital::Parameters::getId(name);
+  if (id >= 0)
+    setValueNotifyHost(id, value);
+}
+
 vital::ModulationConnection* SynthBase::getConnection(const std::string& source, const std::string& destination) {
   for (vital::ModulationConnection* connection : mod_connections_) {
     if (connection->source_name == source && connection->destination_name == destination)
@@ -147,13 +191,13 @@ vital::modulation_change SynthBase::createModulationChange(vital::ModulationConn
   change.poly_modulation_switch = engine_->getPolyModulationSwitch(connection->destination_name);
   change.poly_destination = engine_->getPolyModulationDestination(connection->destination_name);
   change.modulation_processor = connection->modulation_processor.get();
+  change.voice_copies = nullptr;
 
   int num_audio_rate = 0;
-  vital::ModulationConnectionBank& modulation_bank = getModulationBank();
-  for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
-    if (modulation_bank.atIndex(i)->source_name == connection->source_name &&
-        modulation_bank.atIndex(i)->destination_name != connection->destination_name &&
-        !modulation_bank.atIndex(i)->modulation_processor->isControlRate()) {
+  for (vital::ModulationConnection* other : mod_connections_) {
+    if (other->source_name == connection->source_name &&
+        other->destination_name != connection->destination_name &&
+        !other->modulation_processor->isControlRate()) {
       num_audio_rate++;
     }
   }
@@ -173,6 +217,7 @@ void SynthBase::connectModulation(vital::ModulationConnection* connection) {
   }
   else if (mod_connections_.count(connection) == 0) {
     change.disconnecting = false;
+    prepareVoiceCopies(change);
     mod_connections_.push_back(connection);
     modulation_change_queue_.enqueue(change);
   }
@@ -200,6 +245,7 @@ void SynthBase::disconnectModulation(vital::ModulationConnection* connection) {
 
   mod_connections_.remove(connection);
   change.disconnecting = true;
+  prepareVoiceCopies(change);
   modulation_change_queue_.enqueue(change);
 }
 
@@ -217,6 +263,9 @@ void SynthBase::clearModulations() {
     mod_connections_.remove(connection);
     vital::modulation_change change = createModulationChange(connection);
     change.disconnecting = true;
+    vital::VoiceCopies voice_copies;
+    change.voice_copies = &voice_copies;
+    engine_->prepareVoiceCopies(change);
     engine_->disconnectModulation(change);
     connection->source_name = "";
     connection->destination_name = "";
@@ -227,6 +276,20 @@ void SynthBase::clearModulations() {
     getModulationBank().atIndex(i)->modulation_processor->lineMapGenerator()->initLinear();
 
   engine_->disableUnnecessaryModSources();
+  freeSwappedVoiceCopies();
+}
+
+void SynthBase::prepareVoiceCopies(vital::modulation_change& change) {
+  freeSwappedVoiceCopies();
+  voice_copies_.push_back(std::make_unique<vital::VoiceCopies>());
+  change.voice_copies = voice_copies_.back().get();
+  engine_->prepareVoiceCopies(change);
+}
+
+void SynthBase::freeSwappedVoiceCopies() {
+  voice_copies_.remove_if([](const std::unique_ptr<vital::VoiceCopies>& voice_copies) {
+    return voice_copies->swapped.load();
+  });
 }
 
 void SynthBase::forceShowModulation(const std::string& source, bool force) {
@@ -279,6 +342,10 @@ const vital::StatusOutput* SynthBase::getStatusOutput(const std::string& name) {
   return engine_->getStatusOutput(name);
 }
 
+bool SynthBase::acquireTelemetry() {
+  return engine_->getTelemetry()->acquire();
+}
+
 vital::Wavetable* SynthBase::getWavetable(int index) {
   return engine_->getWavetable(index);
 }
@@ -338,31 +405,127 @@ void SynthBase::loadInitPreset() {
 }
 
 bool SynthBase::loadFromJson(const json& data) {
+  json state = data;
+  try {
+    if (!stageState(state)) {
+      clearStagedState();
+      return false;
+    }
+  }
+  catch (const json::exception& e) {
+    clearStagedState();
+    throw e;
+  }
+
   pauseProcessing(true);
   engine_->allSoundsOff();
   try {
-    bool result = LoadSave::jsonToState(this, save_info_, data);
+    loadStagedState(state);
     pauseProcessing(false);
-    return result;
+    clearStagedState();
+    return true;
   }
   catch (const json::exception& e) {
     pauseProcessing(false);
+    clearStagedState();
     throw e;
   }
 }
 
+bool SynthBase::stageState(json& state) {
+  clearStagedState();
+  if (!LoadSave::updateState(state))
+    return false;
+
+  json settings = state["settings"];
+  staged_sample_ = std::make_unique<vital::Sample>();
+  missing_sample_file_ = "";
+  if (!LoadSave::loadSampleState(staged_sample_.get(), settings["sample"]))
+    missing_sample_file_ = settings["sample"]["stream_file"].get<std::string>();
+
+  if (getWavetableCreator(0)) {
+    int i = 0;
+    for (const json& wavetable : settings["wavetables"]) {
+      if (getWavetableCreator(i)->stateToJson() != wavetable) {
+        staged_wavetables_[i] = std::make_unique<vital::Wavetable>(vital::kNumOscillatorWaveFrames);
+        staged_creators_[i] = std::make_unique<WavetableCreator>(staged_wavetables_[i].get());
+        staged_creators_[i]->loadState(wavetable);
+      }
+      i++;
+    }
+
+    // Components keep per-instance scratch frames so a single table renders serially,
+    // but each oscillator's creator is independent and can render on its own thread.
+    std::vector<std::thread> render_threads;
+    for (int i = 0; i < vital::kNumOscillators; ++i) {
+      if (staged_wavetables_[i]) {
+        WavetableCreator* wavetable_creator = staged_creators_[i].get();
+        vital::Wavetable* wavetable = staged_wavetables_[i].get();
+        render_threads.emplace_back([=] {
+          vital::FFT<vital::WaveFrame::kWaveformBits>::ThreadInstance transform;
+          wavetable_creator->renderShared(wavetable);
+        });
+      }
+    }
+
+    for (std::thread& render_thread : render_threads)
+      render_thread.join();
+  }
+
+  return true;
+}
+
+void SynthBase::loadStagedState(const json& state) {
+  for (int i = 0; i < vital::kNumOscillators; ++i) {
+    if (staged_wavetables_[i]) {
+      getWavetable(i)->swapData(staged_wavetables_[i].get());
+      getWavetableCreator(i)->swapState(staged_creators_[i].get());
+    }
+  }
+
+  if (staged_sample_)
+    getSample()->swapData(staged_sample_.get());
+
+  LoadSave::loadEngineState(this, save_info_, state);
+}
+
+void SynthBase::clearStagedState() {
+  for (int i = 0; i < vital::kNumOscillators; ++i) {
+    staged_creators_[i] = nullptr;
+    staged_wavetables_[i] = nullptr;
+  }
+  staged_sample_ = nullptr;
+}
+
 bool SynthBase::loadFromFile(File preset, std::string& error) {
   if (!preset.exists())
     return false;
   
   try {
-    json parsed_json_state = json::parse(preset.loadFileAsString().toStdString(), nullptr);
-    if (!loadFromJson(parsed_json_state)) {
-      error = "Preset was created with a newer version.";
-      return false;
+    if (BinaryPreset::isBinary(preset)) {
+      BinaryPreset binary_preset;
+      if (!binary_preset.open(preset)) {
+        error = "Preset file is corrupted.";
+        return false;
+      }
+      if (!loadFromJson(binary_preset.getState())) {
+        error = "Preset was created with a newer version.";
+        return false;
+      }
+    }
+    else {
+      json parsed_json_state = json::parse(preset.loadFileAsString().toStdString(), nullptr);
+      if (!loadFromJson(parsed_json_state)) {
+        error = "Preset was created with a newer version.";
+        return false;
+      }
     }
 
     active_file_ = preset;
+
+    // The rest of the preset still loads, with the default sample in place of the missing audio.
+    if (!missing_sample_file_.empty())
+      error = "Sample file wasn't found: " + missing_sample_file_;
   }
   catch (const json::exception& e) {
     error = "Preset file is corrupted.";
@@ -382,7 +545,16 @@ bool SynthBase::loadFromFile(File preset, std::string& error) {
 
 void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vector<int> notes, bool render_images) {
   static constexpr int kSampleRate = 44100;
-  static constexpr int kPreProcessSamples = 44100;
+  static constexpr float kVelocity = 0.7f;
+
+  std::vector<float> velocities(notes.size(), kVelocity);
+  renderAudioToFile(file, kSampleRate, seconds, bpm, notes, velocities, render_images);
+}
+
+void SynthBase::renderAudioToFile(File file, int sample_rate, float seconds, float bpm,
+                                  std::vector<int> notes, std::vector<float> velocities, bool render_images,
+                                  std::vector<vital::control_event> control_events) {
+  static constexpr float kDefaultVelocity = 0.7f;
   static constexpr int kFadeSamples = 200;
   static constexpr int kBufferSize = 64;
   static constexpr int kVideoRate = 30;
@@ -395,33 +567,42 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
   ScopedLock lock(getCriticalSection());
 
   processModulationChanges();
-  engine_->setSampleRate(kSampleRate);
+  engine_->setSampleRate(sample_rate);
   engine_->setBpm(bpm);
   engine_->updateAllModulationSwitches();
 
   double sample_time = 1.0 / getSampleRate();
-  double current_time = -kPreProcessSamples * sample_time;
+  int pre_process_samples = sample_rate;
+  double current_time = -pre_process_samples * sample_time;
 
-  for (int samples = 0; samples < kPreProcessSamples; samples += kBufferSize) {
+  for (int samples = 0; samples < pre_process_samples; samples += kBufferSize) {
     engine_->correctToTime(current_time);
     current_time += kBufferSize * sample_time;
     engine_->process(kBufferSize);
   }
 
-  for (int note : notes)
-    engine_->noteOn(note, 0.7f, 0, 0);
+  for (size_t i = 0; i < notes.size(); ++i) {
+    float velocity = i < velocities.size() ? velocities[i] : kDefaultVelocity;
+    engine_->noteOn(notes[i], velocity, 0, 0);
+  }
 
   file.deleteFile();
   std::unique_ptr<FileOutputStream> file_stream = file.createOutputStream();
   WavAudioFormat wav_format;
-  std::unique_ptr<AudioFormatWriter> writer(wav_format.createWriterFor(file_stream.get(), kSampleRate, 2, 16, {}, 0));
+  std::unique_ptr<AudioFormatWriter> writer(wav_format.createWriterFor(file_stream.get(), sample_rate, 2, 16, {}, 0));
 
-  int on_samples = seconds * kSampleRate;
-  int total_samples = on_samples + seconds * kSampleRate * kFadeRatio;
+  int on_samples = seconds * sample_rate;
+  int total_samples = on_samples + seconds * sample_rate * kFadeRatio;
   std::unique_ptr<float[]> left_buffer = std::make_unique<float[]>(kBufferSize);
   std::unique_ptr<float[]> right_buffer = std::make_unique<float[]>(kBufferSize);
   float* buffers[2] = { left_buffer.get(), right_buffer.get() };
-  const vital::mono_float* engine_output = (const vital::mono_float*)engine_->output(0)->buffer;
+  AudioSampleBuffer render_buffer(vital::kNumChannels, kBufferSize);
+  MidiBuffer midi_messages;
+
+  // Samples are counted from the note on. Each block takes the events that land inside it.
+  std::stable_sort(control_events.begin(), control_events.end(),
+                   [](const vital::control_event& a, const vital::control_event& b) { return a.sample < b.sample; });
+  size_t next_control_event = 0;
 
 #if JUCE_MODULE_AVAILABLE_juce_graphics
   int current_image_index = -1;
@@ -429,14 +610,19 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
   File images_folder = File::getCurrentWorkingDirectory().getChildFile("images");
   if (!images_folder.exists() && render_images)
     images_folder.createDirectory();
-  const vital::poly_float* memory = getOscilloscopeMemory();
+  vital::poly_float memory[vital::kOscilloscopeMemoryResolution + 1];
+  if (render_images)
+    audio_memory_->addConsumer();
 #endif
 
   for (int samples = 0; samples < total_samples; samples += kBufferSize) {
-    engine_->correctToTime(current_time);
-    current_time += kBufferSize * sample_time;
-    engine_->process(kBufferSize);
-    updateMemoryOutput(kBufferSize, engine_->output(0)->buffer);
+    for (; next_control_event < control_events.size(); ++next_control_event) {
+      const vital::control_event& event = control_events[next_control_event];
+      if (event.sample >= samples + kBufferSize)
+        break;
+      addControlEvent(event.id, event.value, event.sample - samples);
+    }
+    processAudioAndMidi(&render_buffer, vital::kNumChannels, kBufferSize, midi_messages, current_time);
 
     if (on_samples > samples && on_samples <= samples + kBufferSize) {
       for (int note : notes)
@@ -446,14 +632,14 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
     for (int i = 0; i < kBufferSize; ++i) {
       vital::mono_float t = (total_samples - samples) / (1.0f * kFadeSamples);
       t = vital::utils::min(t, 1.0f);
-      left_buffer[i] = t * engine_output[vital::poly_float::kSize * i];
-      right_buffer[i] = t * engine_output[vital::poly_float::kSize * i + 1];
+      left_buffer[i] = t * render_buffer.getSample(0, i);
+      right_buffer[i] = t * render_buffer.getSample(1, i);
     }
 
     writer->writeFromFloatArrays(buffers, 2, kBufferSize);
 
   #if JUCE_MODULE_AVAILABLE_juce_graphics
-    int image_index = (samples * kVideoRate) / kSampleRate;
+    int image_index = (samples * kVideoRate) / sample_rate;
     if (image_index > current_image_index && render_images) {
       current_image_index = image_index;
       String number(image_index);
@@ -462,6 +648,7 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
 
       File image_file = images_folder.getChildFile("rendered_image" + number + ".png");
       FileOutputStream image_file_stream(image_file);
+      readOscilloscopeMemory(audio_memory_.get(), sample_rate, memory);
       Image image(Image::RGB, kImageWidth, kImageHeight, true);
       Graphics g(image);
       g.fillAll(Colour(0xff1d2125));
@@ -498,6 +685,11 @@ void SynthBase::renderAudioToFile(File file, float seconds, float bpm, std::vect
   #endif
   }
 
+#if JUCE_MODULE_AVAILABLE_juce_graphics
+  if (render_images)
+    audio_memory_->removeConsumer();
+#endif
+
   writer->flush();
   file_stream->flush();
 
@@ -617,6 +809,56 @@ void SynthBase::processMidi(MidiBuffer& midi_messages, int start_sample, int end
   }
 }
 
+void SynthBase::processAudioAndMidi(AudioSampleBuffer* buffer, int channels, int num_samples,
+                                    MidiBuffer& midi_messages, double& seconds_time) {
+  // Chunks end at the next control event or learned controller change so each lands on its sample.
+  double sample_time = 1.0 / getSampleRate();
+  for (int sample_offset = 0; sample_offset < num_samples;) {
+    applyControlEvents(sample_offset);
+    int split = getNextControlSplit(midi_messages, sample_offset, num_samples);
+    int chunk_samples = std::min<int>(split - sample_offset, vital::kMaxBufferSize);
+    engine_->correctToTime(seconds_time);
+
+    processMidi(midi_messages, sample_offset, sample_offset + chunk_samples);
+    processAudio(buffer, channels, chunk_samples, sample_offset);
+    seconds_time += chunk_samples * sample_time;
+    sample_offset += chunk_samples;
+  }
+  finishControlEvents();
+}
+
+void SynthBase::applyControlEvents(int sample) {
+  for (; control_event_index_ < control_events_.size(); ++control_event_index_) {
+    const vital::control_event& event = control_events_[control_event_index_];
+    if (event.sample > sample)
+      return;
+    valueChangedExternal(event.id, event.value);
+  }
+}
+
+int SynthBase::getNextControlSplit(const MidiBuffer& buffer, int start_sample, int end_sample) {
+  int split = end_sample;
+  if (control_event_index_ < control_events_.size())
+    split = std::min(split, control_events_[control_event_index_].sample);
+
+  for (auto iter = buffer.findNextSamplePosition(start_sample + 1); iter != buffer.cend(); ++iter) {
+    const MidiMessageMetadata message = *iter;
+    if (message.samplePosition >= split)
+      break;
+
+    MidiMessage midi_message = message.getMessage();
+    if (midi_message.isController() && midi_manager_->isMidiControlled(midi_message.getControllerNumber()))
+      return message.samplePosition;
+  }
+  return split;
+}
+
+void SynthBase::finishControlEvents() {
+  applyControlEvents(INT_MAX);
+  control_events_.clear();
+  control_event_index_ = 0;
+}
+
 void SynthBase::processKeyboardEvents(MidiBuffer& buffer, int num_samples) {
   midi_manager_->replaceKeyboardMessages(buffer, num_samples);
 }
@@ -628,54 +870,36 @@ void SynthBase::processModulationChanges() {
       engine_->disconnectModulation(change);
     else
       engine_->connectModulation(change);
+
+    if (change.voice_copies)
+      change.voice_copies->swapped = true;
   }
 }
 
+void SynthBase::readOscilloscopeMemory(const vital::AudioCapture* capture, int sample_rate,
+                                       vital::poly_float* output) {
+  int output_inc = std::max<int>(1, sample_rate / vital::kOscilloscopeMemorySampleRate);
+  uint64_t start = capture->alignedStart(output_inc * vital::kOscilloscopeMemoryResolution);
+  capture->readFrames(output, vital::kOscilloscopeMemoryResolution + 1, start, output_inc);
+}
+
 void SynthBase::updateMemoryOutput(int samples, const vital::poly_float* audio) {
-  for (int i = 0; i < samples; ++i)
-    audio_memory_->push(audio[i]);
+  if (!audio_memory_->active())
+    return;
 
   vital::mono_float last_played = engine_->getLastActiveNote();
   last_played = vital::utils::clamp(last_played, kOutputWindowMinNote, kOutputWindowMaxNote);
 
   int num_pressed = engine_->getNumPressedNotes();
-  int output_inc = std::max<int>(1, engine_->getSampleRate() / vital::kOscilloscopeMemorySampleRate);
-  int oscilloscope_samples = 2 * vital::kOscilloscopeMemoryResolution;
-
   if (last_played && (last_played_note_ != last_played || num_pressed > last_num_pressed_)) {
     last_played_note_ = last_played;
-    
-    vital::mono_float frequency = vital::utils::midiNoteToFrequency(last_played_note_);
-    vital::mono_float period = engine_->getSampleRate() / frequency;
-    int window_length = output_inc * vital::kOscilloscopeMemoryResolution;
 
-    memory_reset_period_ = period;
-    while (memory_reset_period_ < window_length)
-      memory_reset_period_ += memory_reset_period_;
-
-    memory_reset_period_ = std::min(memory_reset_period_, 2.0f * window_length);
-    memory_index_ = 0;
-    vital::utils::copyBuffer(oscilloscope_memory_, oscilloscope_memory_write_, oscilloscope_samples);
+    vital::mono_float frequency = vital::utils::midiNoteToFrequency(last_played_note_);
+    audio_memory_->trigger(engine_->getSampleRate() / frequency);
   }
   last_num_pressed_ = num_pressed;
 
-  for (; memory_input_offset_ < samples; memory_input_offset_ += output_inc) {
-    int input_index = vital::utils::iclamp(memory_input_offset_, 0, samples);
-    memory_index_ = vital::utils::iclamp(memory_index_, 0, oscilloscope_samples - 1);
-    VITAL_ASSERT(input_index >= 0);
-    VITAL_ASSERT(input_index < samples);
-    VITAL_ASSERT(memory_index_ >= 0);
-    VITAL_ASSERT(memory_index_ < oscilloscope_samples);
-    oscilloscope_memory_write_[memory_index_++] = audio[input_index];
-
-    if (memory_index_ * output_inc >= memory_reset_period_) {
-      memory_input_offset_ += memory_reset_period_ - memory_index_ * output_inc;
-      memory_index_ = 0;
-      vital::utils::copyBuffer(oscilloscope_memory_, oscilloscope_memory_write_, oscilloscope_samples);
-    }
-  }
-
-  memory_input_offset_ -= samples;
+  audio_memory_->write(audio, samples);
 }
 
 void SynthBase::armMidiLearn(const std::string& name) {
@@ -737,7 +961,7 @@ String SynthBase::getMacroName(int index) {
   return name;
 }
 
-const vital::StereoMemory* SynthBase::getEqualizerMemory() {
+vital::AudioCapture* SynthBase::getEqualizerMemory() {
   if (engine_)
     return engine_->getEqualizerMemory();
   return nullptr;
@@ -758,6 +982,63 @@ void SynthBase::checkOversampling() {
   return engine_->checkOversampling();
 }
 
+std::vector<vital::ProcessorProfile> SynthBase::getProcessorProfile() {
+  std::vector<vital::ProcessorProfile> profile;
+#if VITAL_PROFILING
+  if (profile_nodes_.empty())
+    refreshProcessorProfile();
+
+  for (const vital::ProfileNode& node : profile_nodes_) {
+    long long ticks = node.state->profile_ticks.load(std::memory_order_relaxed);
+    long long calls = node.state->profile_calls.load(std::memory_order_relaxed);
+    profile.push_back({ node.path, node.module, node.depth, calls, ticks, ticks });
+  }
+
+  // Routers that aren't run by a parent router get the time of their children.
+  std::vector<long long> child_ticks(1, 0);
+  for (auto entry = profile.rbegin(); entry != profile.rend(); ++entry) {
+    size_t depth = entry->depth;
+    if (child_ticks.size() < depth + 2)
+      child_ticks.resize(depth + 2, 0);
+
+    if (entry->calls == 0)
+      entry->ticks = child_ticks[depth + 1];
+    entry->self_ticks = std::max(0LL, entry->ticks - child_ticks[depth + 1]);
+    child_ticks[depth] += entry->ticks;
+    child_ticks[depth + 1] = 0;
+  }
+#endif
+  return profile;
+}
+
+std::map<std::string, long long> SynthBase::getModuleProfile() {
+  std::map<std::string, long long> modules;
+  for (const vital::ProcessorProfile& entry : getProcessorProfile())
+    modules[entry.module] += entry.self_ticks;
+  return modules;
+}
+
+void SynthBase::refreshProcessorProfile() {
+#if VITAL_PROFILING
+  ScopedLock lock(getCriticalSection());
+  profile_nodes_.clear();
+  std::string name = vital::ProcessorRouter::getProfileName(engine_.get());
+  engine_->collectProfile(profile_nodes_, name, name, 0);
+#endif
+}
+
+void SynthBase::resetProcessorProfile() {
+#if VITAL_PROFILING
+  if (profile_nodes_.empty())
+    refreshProcessorProfile();
+
+  for (const vital::ProfileNode& node : profile_nodes_) {
+    node.state->profile_ticks.store(0, std::memory_order_relaxed);
+    node.state->profile_calls.store(0, std::memory_order_relaxed);
+  }
+#endif
+}
+
 void SynthBase::ValueChangedCallback::messageCallback() {
   if (auto synth_base = listener.lock()) {
     SynthGuiInterface* gui_interface = (*synth_base)->getGuiInterface();
@@ -22,17 +22,19 @@
 #include "synth_constants.h"
 #include "synth_types.h"
 #include "midi_manager.h"
+#include "processor_router.h"
 #include "tuning.h"
 #include "wavetable_creator.h"
 
+#include <list>
 #include <set>
 #include <string>
 
 namespace vital {
+  class AudioCapture;
   class SoundEngine;
   struct Output;
   class StatusOutput;
-  class StereoMemory;
   class Sample;
   class WaveFrame;
   class Wavetable;
@@ -42,19 +44,28 @@ class SynthGuiInterface;
 
 class SynthBase : public MidiManager::Listener {
   public:
+    static constexpr int kMaxControlEvents = 2048;
+
     static constexpr float kOutputWindowMinNote = 16.0f;
     static constexpr float kOutputWindowMaxNote = 128.0f;
 
+    // Fills output with kOscilloscopeMemoryResolution + 1 frames of captured audio lined up with the last note.
+    static void readOscilloscopeMemory(const vital::AudioCapture* capture, int sample_rate,
+                                       vital::poly_float* output);
+
     SynthBase();
     virtual ~SynthBase();
 
+    void valueChanged(int id, vital::mono_float value);
     void valueChanged(const std::string& name, vital::mono_float value);
-    void valueChangedThroughMidi(const std::string& name, vital::mono_float value) override;
+    void valueChangedThroughMidi(int id, vital::mono_float value) override;
     void pitchWheelMidiChanged(vital::mono_float value) override;
     void modWheelMidiChanged(vital::mono_float value) override;
     void pitchWheelGuiChanged(vital::mono_float value);
     void modWheelGuiChanged(vital::mono_float value);
     void presetChangedThroughMidi(File preset) override;
+    void valueChangedExternal(int id, vital::mono_float value);
+    void addControlEvent(int id, vital::mono_float value, int sample);
     void valueChangedExternal(const std::string& name, vital::mono_float value);
     void valueChangedInternal(const std::string& name, vital::mono_float value);
     bool connectModulation(const std::string& source, const std::string& destination);
@@ -72,6 +83,7 @@ class SynthBase : public MidiManager::Listener {
     std::vector<vital::ModulationConnection*> getDestinationConnections(const std::string& destination);
 
     const vital::StatusOutput* getStatusOutput(const std::string& name);
+    bool acquireTelemetry();
 
     vital::Wavetable* getWavetable(int index);
     WavetableCreator* getWavetableCreator(int index);
@@ -84,6 +96,9 @@ class SynthBase : public MidiManager::Listener {
     void loadInitPreset();
     bool loadFromFile(File preset, std::string& error);
     void renderAudioToFile(File file, float seconds, float bpm, std::vector<int> notes, bool render_images);
+    void renderAudioToFile(File file, int sample_rate, float seconds, float bpm,
+                           std::vector<int> notes, std::vector<float> velocities, bool render_images,
+                           std::vector<vital::control_event> control_events = {});
     void renderAudioForResynthesis(float* data, int samples, int note);
     bool saveToFile(File preset);
     bool saveToActiveFile();
@@ -93,7 +108,8 @@ class SynthBase : public MidiManager::Listener {
     void setMpeEnabled(bool enabled);
     virtual void beginChangeGesture(const std::string& name) { }
     virtual void endChangeGesture(const std::string& name) { }
-    virtual void setValueNotifyHost(const std::string& name, vital::mono_float value) { }
+    virtual void setValueNotifyHost(int id, vital::mono_float value) { }
+    void setValueNotifyHost(const std::string& name, vital::mono_float value);
 
     void armMidiLearn(const std::string& name);
     void cancelMidiLearn();
@@ -114,12 +130,18 @@ class SynthBase : public MidiManager::Listener {
     vital::control_map& getControls() { return controls_; }
     vital::SoundEngine* getEngine() { return engine_.get(); }
     MidiKeyboardState* getKeyboardState() { return keyboard_state_.get(); }
-    const vital::poly_float* getOscilloscopeMemory() { return oscilloscope_memory_; }
-    const vital::StereoMemory* getAudioMemory() { return audio_memory_.get(); }
-    const vital::StereoMemory* getEqualizerMemory();
+    vital::AudioCapture* getAudioMemory() { return audio_memory_.get(); }
+    vital::AudioCapture* getEqualizerMemory();
     vital::ModulationConnectionBank& getModulationBank();
     void notifyOversamplingChanged();
     void checkOversampling();
+
+    // Only filled in when built with VITAL_PROFILING. Reading doesn't block the audio thread.
+    std::vector<vital::ProcessorProfile> getProcessorProfile();
+    std::map<std::string, long long> getModuleProfile();
+    void refreshProcessorProfile();
+    void resetProcessorProfile();
+
     virtual const CriticalSection& getCriticalSection() = 0;
     virtual void pauseProcessing(bool pause) = 0;
     Tuning* getTuning() { return &tuning_; }
@@ -141,6 +163,9 @@ class SynthBase : public MidiManager::Listener {
     virtual SynthGuiInterface* getGuiInterface() = 0;
     json saveToJson();
     bool loadFromJson(const json& state);
+    bool stageState(json& state);
+    void loadStagedState(const json& state);
+    void clearStagedState();
     vital::ModulationConnection* getConnection(const std::string& source, const std::string& destination);
 
     inline bool getNextModulationChange(vital::modulation_change& change) {
@@ -149,15 +174,26 @@ class SynthBase : public MidiManager::Listener {
   
     inline void clearModulationQueue() {
       vital::modulation_change change;
-      while (modulation_change_queue_.try_dequeue_non_interleaved(change))
-        ;
+      while (modulation_change_queue_.try_dequeue_non_interleaved(change)) {
+        if (change.voice_copies)
+          change.voice_copies->swapped = true;
+      }
     }
 
+    // Voice copies are built here so the audio thread only swaps them. Old ones are freed here too.
+    void prepareVoiceCopies(vital::modulation_change& change);
+    void freeSwappedVoiceCopies();
+
     void processAudio(AudioSampleBuffer* buffer, int channels, int samples, int offset);
     void processAudioWithInput(AudioSampleBuffer* buffer, const vital::poly_float* input_buffer,
                                int channels, int samples, int offset);
     void writeAudio(AudioSampleBuffer* buffer, int channels, int samples, int offset);
     void processMidi(MidiBuffer& buffer, int start_sample = 0, int end_sample = 0);
+    void processAudioAndMidi(AudioSampleBuffer* buffer, int channels, int num_samples,
+                             MidiBuffer& midi_messages, double& seconds_time);
+    void applyControlEvents(int sample);
+    int getNextControlSplit(const MidiBuffer& buffer, int start_sample, int end_sample);
+    void finishControlEvents();
     void processKeyboardEvents(MidiBuffer& buffer, int num_samples);
     void processModulationChanges();
     void updateMemoryOutput(int samples, const vital::poly_float* audio);
@@ -167,26 +203,32 @@ class SynthBase : public MidiManager::Listener {
     std::unique_ptr<MidiKeyboardState> keyboard_state_;
 
     std::unique_ptr<WavetableCreator> wavetable_creators_[vital::kNumOscillators];
+    std::unique_ptr<vital::Wavetable> staged_wavetables_[vital::kNumOscillators];
+    std::unique_ptr<WavetableCreator> staged_creators_[vital::kNumOscillators];
+    std::unique_ptr<vital::Sample> staged_sample_;
+    std::string missing_sample_file_;
     std::shared_ptr<SynthBase*> self_reference_;
 
     File active_file_;
-    vital::poly_float oscilloscope_memory_[2 * vital::kOscilloscopeMemoryResolution];
-    vital::poly_float oscilloscope_memory_write_[2 * vital::kOscilloscopeMemoryResolution];
-    std::unique_ptr<vital::StereoMemory> audio_memory_;
+    std::unique_ptr<vital::AudioCapture> audio_memory_;
     vital::mono_float last_played_note_;
     int last_num_pressed_;
-    vital::mono_float memory_reset_period_;
-    vital::mono_float memory_input_offset_;
-    int memory_index_;
     bool expired_;
 
     std::map<std::string, String> save_info_;
     vital::control_map controls_;
     vital::CircularQueue<vital::ModulationConnection*> mod_connections_;
     moodycamel::ConcurrentQueue<vital::control_change> value_change_queue_;
+    std::vector<vital::control_event> control_events_;
+    size_t control_event_index_;
     moodycamel::ConcurrentQueue<vital::modulation_change> modulation_change_queue_;
+    std::list<std::unique_ptr<vital::VoiceCopies>> voice_copies_;
     Tuning tuning_;
 
+#if VITAL_PROFILING
+    std::vector<vital::ProfileNode> profile_nodes_;
+#endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthBase)
 };
 
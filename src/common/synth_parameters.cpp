@@ -537,11 +537,13 @@ namespace vital {
     static constexpr int kNewOscillatorVersion = 0x000500;
     static constexpr int kOldMaxModulations = 32;
     static constexpr int kNewModulationVersion = 0x000601;
+    static constexpr int kPreviousMaxModulations = 64;
+    static constexpr int kExtendedModulationVersion = 0x010007;
 
     int num_parameters = sizeof(parameter_list) / sizeof(ValueDetails);
     for (int i = 0; i < num_parameters; ++i) {
       details_lookup_[parameter_list[i].name] = parameter_list[i];
-      details_list_.push_back(&parameter_list[i]);
+      details_list_.push_back(&details_lookup_[parameter_list[i].name]);
 
       VITAL_ASSERT(parameter_list[i].default_value <= parameter_list[i].max);
       VITAL_ASSERT(parameter_list[i].default_value >= parameter_list[i].min);
@@ -578,10 +580,14 @@ namespace vital {
       addParameterGroup(mod_parameter_list, num_mod_parameters, modulation,
                         kModulationIdPrefix, kModulationNamePrefix);
     }
-    for (int modulation = kOldMaxModulations; modulation < kMaxModulationConnections; ++modulation) {
+    for (int modulation = kOldMaxModulations; modulation < kPreviousMaxModulations; ++modulation) {
       addParameterGroup(mod_parameter_list, num_mod_parameters, modulation,
         kModulationIdPrefix, kModulationNamePrefix, kNewModulationVersion);
     }
+    for (int modulation = kPreviousMaxModulations; modulation < kMaxModulationConnections; ++modulation) {
+      addParameterGroup(mod_parameter_list, num_mod_parameters, modulation,
+        kModulationIdPrefix, kModulationNamePrefix, kExtendedModulationVersion);
+    }
 
     details_lookup_["osc_1_on"].default_value = 1.0f;
     details_lookup_["osc_2_destination"].default_value = 1.0f;
@@ -590,6 +596,8 @@ namespace vital {
     details_lookup_["filter_2_osc2_input"].default_value = 1.0f;
 
     std::sort(details_list_.begin(), details_list_.end(), compareValueDetails);
+    for (int i = 0; i < details_list_.size(); ++i)
+      details_lookup_[details_list_[i]->name].id = i;
   }
 
   void ValueDetailsLookup::addParameterGroup(const ValueDetails* list, int num_parameters, int index,
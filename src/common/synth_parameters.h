@@ -50,6 +50,9 @@ namespace vital {
     std::string display_name;
     const std::string* string_lookup = nullptr;
     std::string local_description;
+
+    // Dense index in parameter order, which is also the host parameter index.
+    int id = -1;
   } typedef ValueDetails;
 
   class ValueDetailsLookup {
@@ -69,6 +72,13 @@ namespace vital {
         return details_list_[index];
       }
 
+      int getId(const std::string& name) const {
+        auto details = details_lookup_.find(name);
+        if (details == details_lookup_.end())
+          return -1;
+        return details->second.id;
+      }
+
       std::string getDisplayName(const std::string& name) const {
         return getDetails(name).display_name;
       }
@@ -122,6 +132,10 @@ namespace vital {
         return lookup_.getDetails(index);
       }
 
+      static int getId(const std::string& name) {
+        return lookup_.getId(name);
+      }
+
       static std::string getDisplayName(const std::string& name) {
         return lookup_.getDisplayName(name);
       }
@@ -21,8 +21,11 @@
 #include "operators.h"
 #include "value.h"
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace vital {
 
@@ -85,6 +88,15 @@ namespace vital {
       JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StringLayout)
   };
 
+  // Voice copies of a modulation slot, built on the message thread and swapped with the voices' copies
+  // on the audio thread. The owner frees them once _swapped_ is set.
+  struct VoiceCopies {
+    VoiceCopies() : swapped(false) { }
+
+    std::vector<std::unique_ptr<Processor>> processors;
+    std::atomic<bool> swapped;
+  };
+
   typedef struct {
     Output* source;
     Processor* mono_destination;
@@ -95,10 +107,17 @@ namespace vital {
     ModulationConnectionProcessor* modulation_processor;
     bool disconnecting;
     int num_audio_rate;
+    VoiceCopies* voice_copies;
   } modulation_change;
 
   typedef std::map<std::string, Value*> control_map;
   typedef std::pair<Value*, mono_float> control_change;
+
+  struct control_event {
+    int id;
+    mono_float value;
+    int sample;
+  };
   typedef std::map<std::string, Processor*> input_map;
   typedef std::map<std::string, Output*> output_map;
 } // namespace vital
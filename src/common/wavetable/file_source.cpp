@@ -15,6 +15,7 @@
  */
 
 #include "file_source.h"
+#include "embedded_data.h"
 
 FileSource::FileSourceKeyframe::FileSourceKeyframe(SampleBuffer* sample_buffer) {
   sample_buffer_ = sample_buffer;
@@ -312,12 +313,13 @@ void FileSource::jsonToState(json data) {
     sample_rate = data["audio_sample_rate"];
 
   MemoryOutputStream decoded;
-  std::string audio_data = data["audio_file"];
-  Base64::convertFromBase64(decoded, audio_data);
+  const void* audio_data = nullptr;
+  size_t data_size = 0;
+  vital::EmbeddedData::read(data["audio_file"], decoded, audio_data, data_size);
 
-  int size = static_cast<int>(decoded.getDataSize()) / sizeof(int16_t);
+  int size = static_cast<int>(data_size / sizeof(int16_t));
   std::unique_ptr<float[]> float_data = std::make_unique<float[]>(size);
-  vital::utils::pcmToFloatData(float_data.get(), (int16_t*)decoded.getData(), size);
+  vital::utils::pcmToFloatData(float_data.get(), static_cast<const int16_t*>(audio_data), size);
   loadBuffer(float_data.get(), size, sample_rate);
 }
 
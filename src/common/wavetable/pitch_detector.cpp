@@ -15,6 +15,7 @@
  */
 
 #include "pitch_detector.h"
+#include "fourier_transform.h"
 #include "synth_constants.h"
 #include "wave_frame.h"
 
@@ -70,15 +71,13 @@ float PitchDetector::getPeriodError(float period) {
   return error;
 }
 
-float PitchDetector::findYinPeriod(int max_period) {
-  constexpr float kMinLength = 300.0f;
-
+float PitchDetector::findErrorPeriod(int max_period) {
   float max_length = std::min<float>(size_ / 2.0f, max_period);
 
   float best_error = INT_MAX;
-  float match = kMinLength;
+  float match = kMinPeriod;
 
-  for (float length = kMinLength; length < max_length; length += 1.0f) {
+  for (float length = kMinPeriod; length < max_length; length += 1.0f) {
     float error = getPeriodError(length);
     if (error < best_error) {
       best_error = error;
@@ -98,6 +97,98 @@ float PitchDetector::findYinPeriod(int max_period) {
   return best_match;
 }
 
+void PitchDetector::computeDifference(int window, int max_lag) {
+  // Squared difference between the first window samples and the window lagged by each period:
+  // d(lag) = sum(x[i]^2) + sum(x[i + lag]^2) - 2 * sum(x[i] * x[i + lag]), correlation done with an fft.
+  std::unique_ptr<float[]> signal_frequencies = std::make_unique<float[]>(2 * kMaxFftSize);
+  std::unique_ptr<float[]> window_frequencies = std::make_unique<float[]>(2 * kMaxFftSize);
+  memcpy(signal_frequencies.get(), signal_data_.get(), size_ * sizeof(float));
+  memcpy(window_frequencies.get(), signal_data_.get(), window * sizeof(float));
+
+  vital::FourierTransform* transform = vital::FFT<kFftBits>::transform();
+  transform->transformRealForward(signal_frequencies.get());
+  transform->transformRealForward(window_frequencies.get());
+
+  for (int i = 0; i <= kMaxFftSize / 2; ++i) {
+    float signal_real = signal_frequencies[2 * i];
+    float signal_imaginary = signal_frequencies[2 * i + 1];
+    float window_real = window_frequencies[2 * i];
+    float window_imaginary = window_frequencies[2 * i + 1];
+    signal_frequencies[2 * i] = signal_real * window_real + signal_imaginary * window_imaginary;
+    signal_frequencies[2 * i + 1] = signal_imaginary * window_real - signal_real * window_imaginary;
+  }
+  transform->transformRealInverse(signal_frequencies.get());
+
+  double window_energy = 0.0;
+  for (int i = 0; i < window; ++i)
+    window_energy += signal_data_[i] * signal_data_[i];
+
+  difference_ = std::make_unique<float[]>(max_lag + 1);
+  double lag_energy = window_energy;
+  for (int lag = 0; lag <= max_lag; ++lag) {
+    double difference = window_energy + lag_energy - 2.0 * signal_frequencies[lag];
+    difference_[lag] = std::max(0.0, difference);
+    if (lag == max_lag)
+      break;
+
+    float removed = signal_data_[lag];
+    float added = signal_data_[lag + window];
+    lag_energy += added * added - removed * removed;
+  }
+}
+
+float PitchDetector::findYinPeriod(int max_period) {
+  float max_length = std::min<float>(size_ / 2.0f, max_period);
+  int max_lag = std::ceil(max_length) - 1;
+  int min_lag = kMinPeriod;
+  if (size_ > kMaxFftSize || max_lag <= min_lag + 1)
+    return findErrorPeriod(max_period);
+
+  int window = size_ - max_lag - 1;
+  computeDifference(window, max_lag + 1);
+
+  // Cumulative mean normalized difference so the search doesn't prefer multiples of the period.
+  std::unique_ptr<float[]> normalized = std::make_unique<float[]>(max_lag + 1);
+  normalized[0] = 1.0f;
+  double total = 0.0;
+  for (int lag = 1; lag <= max_lag; ++lag) {
+    total += difference_[lag];
+    normalized[lag] = total > 0.0 ? difference_[lag] * lag / total : 1.0f;
+  }
+
+  // Skip the tail end of a dip that belongs to a period shorter than the minimum.
+  int start = min_lag;
+  while (start < max_lag && normalized[start + 1] > normalized[start])
+    start++;
+
+  int match = -1;
+  for (int lag = start; lag < max_lag && match < 0; ++lag) {
+    if (normalized[lag] < kYinThreshold) {
+      while (lag < max_lag && normalized[lag + 1] < normalized[lag])
+        lag++;
+      match = lag;
+    }
+  }
+
+  if (match < 0) {
+    match = min_lag;
+    for (int lag = min_lag; lag < max_lag; ++lag) {
+      if (normalized[lag] < normalized[match])
+        match = lag;
+    }
+  }
+
+  float previous = difference_[match - 1];
+  float current = difference_[match];
+  float next = difference_[match + 1];
+  float curvature = previous - 2.0f * current + next;
+  if (curvature <= 0.0f)
+    return match;
+
+  float offset = 0.5f * (previous - next) / curvature;
+  return match + vital::utils::clamp(offset, -1.0f, 1.0f);
+}
+
 float PitchDetector::matchPeriod(int max_period) {
   return findYinPeriod(max_period);
 }
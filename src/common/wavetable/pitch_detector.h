@@ -21,6 +21,10 @@
 class PitchDetector {
   public:
     static constexpr int kNumPoints = 2520;
+    static constexpr int kFftBits = 14;
+    static constexpr int kMaxFftSize = 1 << kFftBits;
+    static constexpr float kMinPeriod = 300.0f;
+    static constexpr float kYinThreshold = 0.15f;
 
     PitchDetector();
 
@@ -28,14 +32,18 @@ class PitchDetector {
     void loadSignal(const float* signal, int size);
 
     float getPeriodError(float period);
+    float findErrorPeriod(int max_period);
     float findYinPeriod(int max_period);
     float matchPeriod(int max_period);
 
     const float* data() const { return signal_data_.get(); }
 
   protected:
+    void computeDifference(int window, int max_lag);
+
     int size_;
     std::unique_ptr<float[]> signal_data_;
+    std::unique_ptr<float[]> difference_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchDetector)
 };
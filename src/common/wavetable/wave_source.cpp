@@ -15,6 +15,7 @@
  */
 
 #include "wave_source.h"
+#include "embedded_data.h"
 #include "wave_frame.h"
 #include "wavetable_component_factory.h"
 
@@ -201,8 +202,11 @@ void WaveSourceKeyframe::jsonToState(json data) {
   WavetableKeyframe::jsonToState(data);
 
   MemoryOutputStream decoded(sizeof(float) * vital::WaveFrame::kWaveformSize);
-  std::string wave_data = data["wave_data"];
-  Base64::convertFromBase64(decoded, wave_data);
-  memcpy(wave_frame_->time_domain, decoded.getData(), sizeof(float) * vital::WaveFrame::kWaveformSize);
+  const void* wave_data = nullptr;
+  size_t size = 0;
+  vital::EmbeddedData::read(data["wave_data"], decoded, wave_data, size);
+  size = std::min(size, sizeof(float) * vital::WaveFrame::kWaveformSize);
+  if (size)
+    memcpy(wave_frame_->time_domain, wave_data, size);
   wave_frame_->toFrequencyDomain();
 }
\ No newline at end of file
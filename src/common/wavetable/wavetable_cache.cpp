@@ -0,0 +1,201 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wavetable_cache.h"
+#include "load_save.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr char kMagic[4] = { 'V', 'W', 'T', 'C' };
+  constexpr int kHeaderSize = 64;
+
+  struct CacheHeader {
+    char magic[4];
+    int32_t format_version;
+    int32_t poly_float_size;
+    int32_t waveform_size;
+    int32_t poly_frequency_size;
+    int32_t num_frames;
+    float frequency_ratio;
+    float sample_rate;
+  };
+
+  static_assert(sizeof(CacheHeader) <= kHeaderSize, "Wavetable cache header must fit before the frame data.");
+
+  struct CacheDirectory {
+    CriticalSection lock;
+    bool initialized = false;
+    File directory;
+    int64 max_size = WavetableCache::kDefaultMaxSize;
+  };
+
+  CacheDirectory& cacheDirectory() {
+    static CacheDirectory cache_directory;
+    return cache_directory;
+  }
+
+  CacheHeader createHeader(int num_frames) {
+    CacheHeader header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.format_version = WavetableCache::kFormatVersion;
+    header.poly_float_size = sizeof(vital::poly_float);
+    header.waveform_size = vital::Wavetable::kWaveformSize;
+    header.poly_frequency_size = vital::Wavetable::kPolyFrequencySize;
+    header.num_frames = num_frames;
+    header.frequency_ratio = 1.0f;
+    header.sample_rate = vital::kDefaultSampleRate;
+    return header;
+  }
+
+  bool isCompatible(const CacheHeader& header) {
+    CacheHeader expected = createHeader(header.num_frames);
+    return memcmp(header.magic, expected.magic, sizeof(kMagic)) == 0 &&
+           header.format_version == expected.format_version &&
+           header.poly_float_size == expected.poly_float_size &&
+           header.waveform_size == expected.waveform_size &&
+           header.poly_frequency_size == expected.poly_frequency_size &&
+           header.num_frames > 0 && header.num_frames <= vital::kNumOscillatorWaveFrames;
+  }
+} // namespace
+
+constexpr int WavetableCache::kFormatVersion;
+constexpr int64 WavetableCache::kDefaultMaxSize;
+const std::string WavetableCache::kExtension = ".vitalcache";
+
+void WavetableCache::setDirectory(const File& directory) {
+  CacheDirectory& cache_directory = cacheDirectory();
+  ScopedLock lock(cache_directory.lock);
+  cache_directory.directory = directory;
+  cache_directory.initialized = true;
+}
+
+File WavetableCache::getDirectory() {
+  CacheDirectory& cache_directory = cacheDirectory();
+  ScopedLock lock(cache_directory.lock);
+  if (!cache_directory.initialized) {
+    cache_directory.directory = LoadSave::getWavetableCacheDirectory();
+    cache_directory.initialized = true;
+  }
+  return cache_directory.directory;
+}
+
+void WavetableCache::setMaxSize(int64 max_size) {
+  CacheDirectory& cache_directory = cacheDirectory();
+  ScopedLock lock(cache_directory.lock);
+  cache_directory.max_size = max_size;
+}
+
+int64 WavetableCache::getMaxSize() {
+  CacheDirectory& cache_directory = cacheDirectory();
+  ScopedLock lock(cache_directory.lock);
+  return cache_directory.max_size;
+}
+
+std::shared_ptr<vital::Wavetable::WavetableData> WavetableCache::load(const std::string& name) {
+  File directory = getDirectory();
+  if (directory == File())
+    return nullptr;
+
+  File file = directory.getChildFile(name + kExtension);
+  if (!file.existsAsFile())
+    return nullptr;
+
+  std::unique_ptr<MemoryMappedFile> mapped_file = std::make_unique<MemoryMappedFile>(file,
+                                                                                     MemoryMappedFile::readOnly);
+  if (mapped_file->getData() == nullptr || mapped_file->getSize() < kHeaderSize)
+    return nullptr;
+
+  CacheHeader header;
+  memcpy(&header, mapped_file->getData(), sizeof(CacheHeader));
+  if (!isCompatible(header))
+    return nullptr;
+
+  std::shared_ptr<vital::Wavetable::WavetableData> data =
+      std::make_shared<vital::Wavetable::WavetableData>(header.num_frames, vital::Wavetable::nextVersion());
+  if (mapped_file->getSize() != kHeaderSize + data->memorySize())
+    return nullptr;
+
+  data->frequency_ratio = header.frequency_ratio;
+  data->sample_rate = header.sample_rate;
+  data->useMemory(static_cast<char*>(mapped_file->getData()) + kHeaderSize);
+  data->mapped_file = std::move(mapped_file);
+
+  // The access time orders files for eviction, so mark this one as just used.
+  file.setLastAccessTime(Time::getCurrentTime());
+  return data;
+}
+
+bool WavetableCache::save(const std::string& name, const vital::Wavetable::WavetableData* data) {
+  File directory = getDirectory();
+  if (directory == File() || !directory.createDirectory())
+    return false;
+
+  CacheHeader header = createHeader(data->num_frames);
+  header.frequency_ratio = data->frequency_ratio;
+  header.sample_rate = data->sample_rate;
+  char header_block[kHeaderSize] = { };
+  memcpy(header_block, &header, sizeof(CacheHeader));
+
+  // Write to a temporary file first so other processes never map a partial table.
+  TemporaryFile temporary_file(directory.getChildFile(name + kExtension));
+  {
+    FileOutputStream output(temporary_file.getFile());
+    if (!output.openedOk())
+      return false;
+
+    output.write(header_block, kHeaderSize);
+    output.write(data->frequency_amplitudes, data->memorySize());
+    output.flush();
+    if (output.getStatus().failed())
+      return false;
+  }
+  if (!temporary_file.overwriteTargetFileWithTemporary())
+    return false;
+
+  evict(directory, temporary_file.getTargetFile());
+  return true;
+}
+
+void WavetableCache::evict(const File& directory, const File& keep) {
+  int64 max_size = getMaxSize();
+  Array<File> files = directory.findChildFiles(File::findFiles, false, "*" + String(kExtension));
+
+  int64 total_size = 0;
+  for (const File& file : files)
+    total_size += file.getSize();
+  if (total_size <= max_size)
+    return;
+
+  std::vector<std::pair<Time, File>> least_recent_first;
+  for (const File& file : files) {
+    if (file != keep)
+      least_recent_first.emplace_back(file.getLastAccessTime(), file);
+  }
+  std::sort(least_recent_first.begin(), least_recent_first.end(),
+            [](const std::pair<Time, File>& one, const std::pair<Time, File>& two) {
+              return one.first < two.first;
+            });
+
+  // Tables other instances still map stay readable on POSIX. Where deleting fails the file is kept.
+  for (const std::pair<Time, File>& entry : least_recent_first) {
+    if (total_size <= max_size)
+      break;
+
+    int64 size = entry.second.getSize();
+    if (entry.second.deleteFile())
+      total_size -= size;
+  }
+}
@@ -0,0 +1,42 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "wavetable.h"
+
+// Stores fully rendered wavetable data on disk so loading the same wavetable state later maps the file
+// instead of rendering. Files are named by the hash of the wavetable state and are read only once written.
+// Saving past the size limit deletes the least recently loaded files first.
+class WavetableCache {
+  public:
+    static constexpr int kFormatVersion = 1;
+    static constexpr int64 kDefaultMaxSize = 512LL * 1024 * 1024;
+    static const std::string kExtension;
+
+    static void setDirectory(const File& directory);
+    static File getDirectory();
+
+    static void setMaxSize(int64 max_size);
+    static int64 getMaxSize();
+
+    static std::shared_ptr<vital::Wavetable::WavetableData> load(const std::string& name);
+    static bool save(const std::string& name, const vital::Wavetable::WavetableData* data);
+
+  private:
+    static void evict(const File& directory, const File& keep);
+};
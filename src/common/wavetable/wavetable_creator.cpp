@@ -15,6 +15,7 @@
  */
 
 #include "wavetable_creator.h"
+#include "asset_cache.h"
 #include "line_generator.h"
 #include "load_save.h"
 #include "synth_constants.h"
@@ -22,6 +23,7 @@
 #include "wave_line_source.h"
 #include "wave_source.h"
 #include "wavetable.h"
+#include "wavetable_cache.h"
 
 namespace {
   int getFirstNonZeroSample(const float* audio_buffer, int num_samples) {
@@ -92,15 +94,13 @@ float WavetableCreator::render(int position) {
 
 void WavetableCreator::render() {
   int last_waveframe = 0;
-  bool shepard = groups_.size() > 0;
   for (auto& group : groups_) {
     group->prerender();
     last_waveframe = std::max(last_waveframe, group->getLastKeyframePosition());
-    shepard = shepard && group->isShepardTone();
   }
   
   wavetable_->setNumFrames(last_waveframe + 1);
-  wavetable_->setShepardTable(shepard);
+  wavetable_->setShepardTable(isShepardTable());
   float max_span = 0.0f;
   for (int i = 0; i < last_waveframe + 1; ++i)
     max_span = std::max(render(i), max_span);
@@ -110,6 +110,43 @@ void WavetableCreator::render() {
   postRender(max_span);
 }
 
+void WavetableCreator::render(vital::Wavetable* wavetable) {
+  vital::Wavetable* original_wavetable = wavetable_;
+  wavetable_ = wavetable;
+  render();
+  wavetable_ = original_wavetable;
+}
+
+void WavetableCreator::renderShared(vital::Wavetable* wavetable) {
+  typedef vital::AssetCache<vital::Wavetable::WavetableData> SharedWavetables;
+
+  // Instances loading the same wavetable state share one rendered copy, optionally persisted on disk.
+  std::string state = stateToJson().dump();
+  vital::AssetKey key;
+  key.add(WavetableCache::kFormatVersion);
+  key.add(state.data(), state.size());
+
+  std::shared_ptr<vital::Wavetable::WavetableData> data = SharedWavetables::instance().find(key);
+  if (data == nullptr) {
+    data = WavetableCache::load(key.toString());
+    if (data)
+      data = SharedWavetables::instance().insert(key, data);
+  }
+
+  if (data) {
+    wavetable->loadSharedData(data);
+    wavetable->setShepardTable(isShepardTable());
+    return;
+  }
+
+  render(wavetable);
+  data = SharedWavetables::instance().insert(key, wavetable->shareData());
+  if (data.get() != wavetable->getAllData())
+    wavetable->loadSharedData(data);
+  else
+    WavetableCache::save(key.toString(), data.get());
+}
+
 void WavetableCreator::postRender(float max_span) {
   if (full_normalize_)
     wavetable_->postProcess(max_span);
@@ -298,7 +335,17 @@ void WavetableCreator::initFromLineGenerator(LineGenerator* line_generator) {
 
   new_group->addComponent(line_source);
   addGroup(new_group);
-  render();
+}
+
+bool WavetableCreator::isShepardTable() {
+  if (groups_.empty())
+    return false;
+
+  for (auto& group : groups_) {
+    if (!group->isShepardTone())
+      return false;
+  }
+  return true;
 }
 
 bool WavetableCreator::isValidJson(json data) {
@@ -478,6 +525,11 @@ json WavetableCreator::stateToJson() {
 }
 
 void WavetableCreator::jsonToState(json data) {
+  loadState(data);
+  render();
+}
+
+void WavetableCreator::loadState(json data) {
   if (LineGenerator::isValidJson(data)) {
     LineGenerator generator(vital::WaveFrame::kWaveformSize);
     generator.jsonToState(data);
@@ -511,6 +563,18 @@ void WavetableCreator::jsonToState(json data) {
     new_group->jsonToState(json_group);
     addGroup(new_group);
   }
+}
 
-  render();
+void WavetableCreator::swapState(WavetableCreator* other) {
+  groups_.swap(other->groups_);
+  std::swap(last_file_loaded_, other->last_file_loaded_);
+  std::swap(full_normalize_, other->full_normalize_);
+  std::swap(remove_all_dc_, other->remove_all_dc_);
+
+  std::string name = getName();
+  std::string author = getAuthor();
+  setName(other->getName());
+  setAuthor(other->getAuthor());
+  other->setName(name);
+  other->setAuthor(author);
 }
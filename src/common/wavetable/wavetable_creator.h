@@ -51,6 +51,8 @@ class WavetableCreator {
     WavetableGroup* getGroup(int index) const { return groups_[index].get(); }
     float render(int position);
     void render();
+    void render(vital::Wavetable* wavetable);
+    void renderShared(vital::Wavetable* wavetable);
     void postRender(float max_span);
     void renderToBuffer(float* buffer, int num_frames, int frame_size);
     void init();
@@ -73,6 +75,12 @@ class WavetableCreator {
     json stateToJson();
     void jsonToState(json data);
 
+    // Reads state without rendering it.
+    void loadState(json data);
+
+    // Exchanges groups and settings with other, leaving each creator's wavetable in place.
+    void swapState(WavetableCreator* other);
+
     vital::Wavetable* getWavetable() { return wavetable_; }
 
   protected:
@@ -81,6 +89,7 @@ class WavetableCreator {
     void initFromVocodedAudioFile(const float* audio_buffer, int num_samples, int sample_rate, bool ttwt);
     void initFromPitchedAudioFile(const float* audio_buffer, int num_samples, int sample_rate);
     void initFromLineGenerator(LineGenerator* line_generator);
+    bool isShepardTable();
 
     vital::WaveFrame compute_frame_combine_;
     vital::WaveFrame compute_frame_;
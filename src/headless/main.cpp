@@ -15,9 +15,30 @@
  */
 
 #include "JuceHeader.h"
+#include "binary_preset.h"
+#include "decimator.h"
+#include "file_source.h"
+#include "fourier_transform.h"
 #include "load_save.h"
+#include "modulation_connection_processor.h"
+#include "pitch_detector.h"
+#include "sample_source.h"
 #include "tuning.h"
+#include "sound_engine.h"
 #include "synth_base.h"
+#include "upsampler.h"
+#include "wave_frame.h"
+#include "wavetable_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#if JUCE_LINUX
+  #include <malloc.h>
+#elif JUCE_MAC
+  #include <malloc/malloc.h>
+#endif
 
 String getArgumentValue(int argc, const char* argv[], const String& flag, const String& full_flag) {
   for (int i = 0; i < argc - 1; ++i) {
@@ -30,7 +51,7 @@ String getArgumentValue(int argc, const char* argv[], const String& flag, const
 }
 
 bool hasFlag(int argc, const char* argv[], const String& flag, const String& full_flag) {
-  for (int i = 0; i < argc - 1; ++i) {
+  for (int i = 0; i < argc; ++i) {
     std::string arg = argv[i];
     if (arg == flag || arg == full_flag)
       return true;
@@ -39,6 +60,12 @@ bool hasFlag(int argc, const char* argv[], const String& flag, const String& ful
   return false;
 }
 
+// Options that are switches on their own rather than taking the next argument as a value.
+bool isBooleanFlag(const std::string& arg) {
+  static const std::string kBooleanFlags[] = { "--headless", "-i", "--render-images", "-p", "--profile" };
+  return std::find(std::begin(kBooleanFlags), std::end(kBooleanFlags), arg) != std::end(kBooleanFlags);
+}
+
 float getRenderLength(int argc, const char* argv[]) {
   static constexpr float kDefaultRenderLength = 5.0f;
   static constexpr float kMaxRenderLength = 15.0f;
@@ -55,21 +82,31 @@ float getRenderLength(int argc, const char* argv[]) {
   return length;
 }
 
+std::vector<int> parseMidiNotes(const String& string_midi) {
+  std::vector<int> midi_notes;
+  StringArray midi_tokens;
+  midi_tokens.addTokens(string_midi, ",; ", "");
+  midi_tokens.removeEmptyStrings();
+
+  for (const String& midi_token : midi_tokens) {
+    int midi = -1;
+    if (midi_token.containsOnly("0123456789"))
+      midi = midi_token.getIntValue();
+    else
+      midi = Tuning::noteToMidiKey(midi_token);
+
+    if (midi >= 0 && midi < vital::kMidiSize)
+      midi_notes.push_back(midi);
+  }
+
+  return midi_notes;
+}
+
 std::vector<int> getRenderMidiNotes(int argc, const char* argv[]) {
   static constexpr int kDefaultMidiNote = 48;
   
   String string_midi = getArgumentValue(argc, argv, "-m", "--midi");
-  std::vector<int> midi_notes;
-  if (!string_midi.isEmpty()) {
-    StringArray midi_tokens;
-    midi_tokens.addTokens(string_midi, ",", "");
-    
-    for (const String& midi_token : midi_tokens) {
-      int midi = Tuning::noteToMidiKey(midi_token);
-      if (midi >= 0)
-        midi_notes.push_back(midi);
-    }
-  }
+  std::vector<int> midi_notes = parseMidiNotes(string_midi);
   
   if (midi_notes.empty())
     midi_notes.push_back(kDefaultMidiNote);
@@ -91,6 +128,66 @@ float getRenderBpm(int argc, const char* argv[]) {
   return std::max(bpm, kMinBpm);
 }
 
+json profileToJson(SynthBase& synth) {
+  json data;
+  std::vector<vital::ProcessorProfile> profile = synth.getProcessorProfile();
+  if (profile.empty())
+    return data;
+
+  double total = std::max(1LL, profile[0].ticks);
+  data["total_ticks"] = profile[0].ticks;
+  for (auto& module : synth.getModuleProfile())
+    data["modules"][module.first] = module.second / total;
+
+  for (const vital::ProcessorProfile& entry : profile) {
+    if (entry.ticks == 0)
+      continue;
+
+    json processor;
+    processor["path"] = entry.path;
+    processor["calls"] = entry.calls;
+    processor["ticks"] = entry.ticks;
+    processor["self_ticks"] = entry.self_ticks;
+    data["processors"].push_back(processor);
+  }
+  return data;
+}
+
+void printProfile(SynthBase& synth) {
+  static constexpr int kMaxPrintedProcessors = 20;
+
+  std::vector<vital::ProcessorProfile> profile = synth.getProcessorProfile();
+  if (profile.empty()) {
+    std::cout << "Profiling needs a build with VITAL_PROFILING=1." << std::endl;
+    return;
+  }
+
+  double total = std::max(1LL, profile[0].ticks);
+  std::map<std::string, long long> module_map = synth.getModuleProfile();
+  std::vector<std::pair<std::string, long long>> modules(module_map.begin(), module_map.end());
+  std::sort(modules.begin(), modules.end(), [](const std::pair<std::string, long long>& a,
+                                               const std::pair<std::string, long long>& b) {
+    return a.second > b.second;
+  });
+
+  std::cout << "Modules:" << std::endl;
+  for (auto& module : modules) {
+    if (module.second > 0)
+      std::cout << String(100.0 * module.second / total, 1).paddedLeft(' ', 7) << "%  " << module.first << std::endl;
+  }
+
+  std::sort(profile.begin(), profile.end(), [](const vital::ProcessorProfile& a, const vital::ProcessorProfile& b) {
+    return a.self_ticks > b.self_ticks;
+  });
+
+  std::cout << "Processors:" << std::endl;
+  int num_printed = std::min(kMaxPrintedProcessors, static_cast<int>(profile.size()));
+  for (int i = 0; i < num_printed && profile[i].self_ticks > 0; ++i) {
+    std::cout << String(100.0 * profile[i].self_ticks / total, 1).paddedLeft(' ', 7) << "%  "
+              << profile[i].path << " (" << profile[i].calls << " calls)" << std::endl;
+  }
+}
+
 void doRenderToFile(HeadlessSynth& headless_synth, int argc, const char* argv[]) {
   String string_output_file = getArgumentValue(argc, argv, "-o", "--output");
   bool render_images = hasFlag(argc, argv, "-i", "--render-images");
@@ -110,8 +207,1259 @@ void doRenderToFile(HeadlessSynth& headless_synth, int argc, const char* argv[])
   float length = getRenderLength(argc, argv);
   float bpm = getRenderBpm(argc, argv);
   std::vector<int> midi_notes = getRenderMidiNotes(argc, argv);
-  
+  bool profile = hasFlag(argc, argv, "-p", "--profile");
+
+  if (profile) {
+    headless_synth.refreshProcessorProfile();
+    headless_synth.resetProcessorProfile();
+  }
+
   headless_synth.renderAudioToFile(output_file, length, bpm, midi_notes, render_images);
+
+  if (profile)
+    printProfile(headless_synth);
+}
+
+namespace {
+  constexpr float kBatchDefaultRenderLength = 5.0f;
+  constexpr float kBatchMaxRenderLength = 600.0f;
+  constexpr float kBatchDefaultVelocity = 0.7f;
+  constexpr float kBatchDefaultBpm = 120.0f;
+  constexpr float kBatchMinBpm = 5.0f;
+  constexpr float kBatchMaxBpm = 900.0f;
+  constexpr int kBatchDefaultMidiNote = 48;
+  constexpr int kBatchDefaultSampleRate = 44100;
+  constexpr int kBatchMinSampleRate = 8000;
+  constexpr int kBatchMaxSampleRate = 192000;
+} // namespace
+
+struct RenderAutomation {
+  int id;
+  float time;
+  vital::mono_float value;
+};
+
+struct RenderJob {
+  File preset;
+  File output;
+  std::vector<int> notes;
+  std::vector<float> velocities;
+  std::vector<RenderAutomation> automation;
+  float length;
+  float bpm;
+  int sample_rate;
+};
+
+class BatchRenderer {
+  public:
+    BatchRenderer(const File& manifest) : manifest_(manifest), next_group_(0) { }
+
+    bool loadManifest(std::string& error) {
+      if (!manifest_.existsAsFile()) {
+        error = "Manifest file doesn't exist.";
+        return false;
+      }
+
+      jobs_.clear();
+      if (manifest_.hasFileExtension("json")) {
+        try {
+          json data = json::parse(manifest_.loadFileAsString().toStdString(), nullptr);
+          if (data.is_object() && data.count("jobs"))
+            data = data["jobs"];
+          if (!data.is_array()) {
+            error = "JSON manifest must be a list of jobs.";
+            return false;
+          }
+
+          for (const json& job_data : data)
+            addJob(jsonToJob(job_data));
+        }
+        catch (const json::exception& e) {
+          error = "JSON manifest is corrupted.";
+          return false;
+        }
+      }
+      else if (!loadCsvManifest(error))
+        return false;
+
+      groupJobsByPreset();
+      return true;
+    }
+
+    int numJobs() const { return static_cast<int>(jobs_.size()); }
+
+    void render(int num_threads) {
+      num_threads = std::max(1, std::min(num_threads, static_cast<int>(job_groups_.size())));
+
+      // SynthBase construction reads and writes shared config, so instances are created up front.
+      std::vector<std::unique_ptr<RenderThread>> threads;
+      for (int i = 0; i < num_threads; ++i)
+        threads.push_back(std::make_unique<RenderThread>(this));
+
+      double start_time = Time::getMillisecondCounterHiRes();
+      for (auto& thread : threads)
+        thread->startThread();
+      for (auto& thread : threads)
+        thread->waitForThreadToExit(-1);
+
+      double total_time = Time::getMillisecondCounterHiRes() - start_time;
+      std::cout << "Rendered " << jobs_.size() << " jobs with " << num_threads << " threads in "
+                << String(total_time / 1000.0, 2) << " s" << std::endl;
+    }
+
+  private:
+    class RenderThread : public Thread {
+      public:
+        RenderThread(BatchRenderer* renderer) : Thread("Vital Batch Render"), renderer_(renderer) { }
+
+        void run() override {
+          vital::FFT<vital::WaveFrame::kWaveformBits>::ThreadInstance transform;
+          File loaded_preset;
+          std::vector<int>* group = nullptr;
+          while ((group = renderer_->getNextGroup()) != nullptr) {
+            for (int job_index : *group)
+              renderer_->renderJob(synth_, loaded_preset, job_index);
+          }
+        }
+
+      private:
+        BatchRenderer* renderer_;
+        HeadlessSynth synth_;
+    };
+
+    static File resolveFile(const File& directory, String path) {
+      path = path.trim().unquoted();
+      if (path.isEmpty())
+        return File();
+      return directory.getChildFile(path);
+    }
+
+    RenderJob defaultJob() const {
+      RenderJob job;
+      job.length = kBatchDefaultRenderLength;
+      job.bpm = kBatchDefaultBpm;
+      job.sample_rate = kBatchDefaultSampleRate;
+      return job;
+    }
+
+    RenderJob jsonToJob(const json& data) const {
+      File directory = manifest_.getParentDirectory();
+      RenderJob job = defaultJob();
+
+      if (data.count("preset"))
+        job.preset = resolveFile(directory, data["preset"].get<std::string>());
+      if (data.count("output"))
+        job.output = resolveFile(directory, data["output"].get<std::string>());
+      if (data.count("length"))
+        job.length = data["length"];
+      if (data.count("bpm"))
+        job.bpm = data["bpm"];
+      if (data.count("sample_rate"))
+        job.sample_rate = data["sample_rate"];
+
+      if (data.count("notes")) {
+        const json& notes = data["notes"];
+        if (notes.is_array()) {
+          for (const json& note : notes) {
+            if (note.is_number())
+              job.notes.push_back(note);
+            else
+              job.notes.push_back(Tuning::noteToMidiKey(note.get<std::string>()));
+          }
+        }
+        else if (notes.is_number())
+          job.notes.push_back(notes);
+        else
+          job.notes = parseMidiNotes(notes.get<std::string>());
+      }
+
+      if (data.count("velocities")) {
+        const json& velocities = data["velocities"];
+        if (velocities.is_array()) {
+          for (const json& velocity : velocities)
+            job.velocities.push_back(velocity);
+        }
+        else
+          job.velocities.push_back(velocities);
+      }
+
+      // Parameter changes as { "parameter": name, "time": seconds after the note on, "value": value }.
+      if (data.count("automation")) {
+        for (const json& point : data["automation"]) {
+          int id = vital::Parameters::getId(point["parameter"].get<std::string>());
+          if (id >= 0)
+            job.automation.push_back({ id, point["time"], point["value"] });
+        }
+      }
+
+      return job;
+    }
+
+    bool loadCsvManifest(std::string& error) {
+      StringArray lines;
+      lines.addLines(manifest_.loadFileAsString());
+      lines.removeEmptyStrings();
+      if (lines.isEmpty()) {
+        error = "CSV manifest is empty.";
+        return false;
+      }
+
+      StringArray header = StringArray::fromTokens(lines[0].toLowerCase(), ",", "\"");
+      header.trim();
+      if (!header.contains("preset") || !header.contains("output")) {
+        error = "CSV manifest needs 'preset' and 'output' columns.";
+        return false;
+      }
+
+      File directory = manifest_.getParentDirectory();
+      for (int i = 1; i < lines.size(); ++i) {
+        StringArray cells = StringArray::fromTokens(lines[i], ",", "\"");
+        RenderJob job = defaultJob();
+
+        for (int c = 0; c < header.size() && c < cells.size(); ++c) {
+          String cell = cells[c].trim().unquoted();
+          if (cell.isEmpty())
+            continue;
+
+          const String& column = header[c];
+          if (column == "preset")
+            job.preset = resolveFile(directory, cell);
+          else if (column == "output")
+            job.output = resolveFile(directory, cell);
+          else if (column == "notes")
+            job.notes = parseMidiNotes(cell);
+          else if (column == "velocities") {
+            StringArray velocities;
+            velocities.addTokens(cell, "; ", "");
+            velocities.removeEmptyStrings();
+            for (const String& velocity : velocities)
+              job.velocities.push_back(velocity.getFloatValue());
+          }
+          else if (column == "length")
+            job.length = cell.getFloatValue();
+          else if (column == "bpm")
+            job.bpm = cell.getFloatValue();
+          else if (column == "sample_rate")
+            job.sample_rate = cell.getIntValue();
+        }
+
+        addJob(job);
+      }
+
+      return true;
+    }
+
+    void addJob(RenderJob job) {
+      job.notes.erase(std::remove_if(job.notes.begin(), job.notes.end(),
+                                     [](int note) { return note < 0 || note >= vital::kMidiSize; }),
+                      job.notes.end());
+      if (job.notes.empty())
+        job.notes.push_back(kBatchDefaultMidiNote);
+
+      while (job.velocities.size() < job.notes.size())
+        job.velocities.push_back(job.velocities.empty() ? kBatchDefaultVelocity : job.velocities.back());
+      for (float& velocity : job.velocities)
+        velocity = vital::utils::clamp(velocity, 0.0f, 1.0f);
+
+      if (job.length <= 0.0f)
+        job.length = kBatchDefaultRenderLength;
+      job.length = std::min(job.length, kBatchMaxRenderLength);
+      job.bpm = vital::utils::clamp(job.bpm, kBatchMinBpm, kBatchMaxBpm);
+      job.sample_rate = vital::utils::iclamp(job.sample_rate, kBatchMinSampleRate, kBatchMaxSampleRate);
+
+      jobs_.push_back(job);
+    }
+
+    // Jobs sharing a preset go to the same thread so the preset and its wavetables only load once.
+    void groupJobsByPreset() {
+      job_groups_.clear();
+      std::map<String, int> preset_groups;
+      for (int i = 0; i < numJobs(); ++i) {
+        String path = jobs_[i].preset.getFullPathName();
+        if (preset_groups.count(path) == 0) {
+          preset_groups[path] = static_cast<int>(job_groups_.size());
+          job_groups_.emplace_back();
+        }
+        job_groups_[preset_groups[path]].push_back(i);
+      }
+    }
+
+    std::vector<int>* getNextGroup() {
+      int group = next_group_++;
+      if (group >= static_cast<int>(job_groups_.size()))
+        return nullptr;
+      return &job_groups_[group];
+    }
+
+    void renderJob(HeadlessSynth& synth, File& loaded_preset, int job_index) {
+      const RenderJob& job = jobs_[job_index];
+      String job_name = "[" + String(job_index + 1) + "/" + String(numJobs()) + "] ";
+
+      if (job.output == File()) {
+        log(job_name + "Error: No output file.");
+        return;
+      }
+
+      double start_time = Time::getMillisecondCounterHiRes();
+      if (job.preset != loaded_preset) {
+        std::string error;
+        if (job.preset == File())
+          synth.loadInitPreset();
+        else if (!job.preset.existsAsFile())
+          error = "Preset file doesn't exist.";
+        else
+          synth.loadFromFile(job.preset, error);
+
+        if (!error.empty()) {
+          loaded_preset = File();
+          log(job_name + "Error loading " + job.preset.getFullPathName() + ": " + error);
+          return;
+        }
+        loaded_preset = job.preset;
+      }
+      double load_time = Time::getMillisecondCounterHiRes() - start_time;
+
+      job.output.getParentDirectory().createDirectory();
+      if (!job.output.getParentDirectory().hasWriteAccess()) {
+        log(job_name + "Error: Don't have permission to write " + job.output.getFullPathName());
+        return;
+      }
+
+      std::vector<vital::control_event> control_events;
+      for (const RenderAutomation& point : job.automation)
+        control_events.push_back({ point.id, point.value, static_cast<int>(point.time * job.sample_rate) });
+
+      start_time = Time::getMillisecondCounterHiRes();
+      synth.renderAudioToFile(job.output, job.sample_rate, job.length, job.bpm, job.notes, job.velocities, false,
+                              control_events);
+      double render_time = Time::getMillisecondCounterHiRes() - start_time;
+
+      log(job_name + job.output.getFileName() + " load: " + String(load_time, 1) + " ms, render: " +
+          String(render_time, 1) + " ms");
+    }
+
+    void log(const String& message) {
+      ScopedLock lock(log_lock_);
+      std::cout << message << std::endl;
+    }
+
+    File manifest_;
+    std::vector<RenderJob> jobs_;
+    std::vector<std::vector<int>> job_groups_;
+    std::atomic<int> next_group_;
+    CriticalSection log_lock_;
+};
+
+int doBatchRender(int argc, const char* argv[]) {
+  String manifest_path = getArgumentValue(argc, argv, "--batch", "--batch");
+  File manifest = File::getCurrentWorkingDirectory().getChildFile(manifest_path.unquoted());
+
+  BatchRenderer renderer(manifest);
+  std::string error;
+  if (!renderer.loadManifest(error)) {
+    std::cout << "Error: " << error << std::endl;
+    return 1;
+  }
+
+  int num_threads = SystemStats::getNumCpus();
+  String string_threads = getArgumentValue(argc, argv, "-j", "--threads");
+  if (!string_threads.isEmpty())
+    num_threads = std::max(1, string_threads.getIntValue());
+
+  renderer.render(num_threads);
+  return 0;
+}
+
+namespace {
+  constexpr float kBenchDefaultLength = 2.0f;
+  constexpr float kBenchMaxLength = 60.0f;
+  constexpr float kBenchWarmupSeconds = 1.0f;
+  constexpr float kBenchChordSeconds = 0.5f;
+  constexpr float kBenchVelocity = 0.7f;
+  constexpr int kBenchTransposeStep = 5;
+  constexpr int kBenchDefaultNotes[] = { 48, 55, 60, 64, 67, 71, 74, 79 };
+  constexpr int kBenchDefaultBufferSizes[] = { 64, 256, 1024 };
+  constexpr int kBenchDefaultSampleRates[] = { 44100, 48000, 96000 };
+  constexpr int kBenchDefaultOversampling[] = { 1, 2, 4 };
+  constexpr int kBenchMaxBufferSize = 8192;
+  constexpr int kBenchMaxOversampling = 8;
+  constexpr int kBenchResamplingStages = 3;
+  constexpr int kBenchResamplingBlocks = 8192;
+  constexpr int kBenchPitchSampleRate = 44100;
+  constexpr int kBenchPitchHarmonics = 48;
+  constexpr float kBenchPitchToleranceCents = 1.0f;
+  constexpr float kBenchSingleCyclePeriods[] = { 2047.0f, 1024.0f, 1337.25f, 611.5f, 400.1f };
+  constexpr int kBenchPitchedNotes[] = { 24, 29, 33, 36, 40, 43, 47 };
+
+  const char* kBenchEffectControls[] = {
+    "chorus_on", "compressor_on", "delay_on", "distortion_on", "eq_on",
+    "filter_fx_on", "flanger_on", "phaser_on", "reverb_on"
+  };
+
+  const char* kBenchFilterControls[] = { "filter_1_on", "filter_2_on" };
+  const char* kBenchModulationSources[] = { "lfo_", "env_", "random_" };
+  constexpr int kBenchModulationCounts[] = { 0, 16, 64, vital::kMaxModulationConnections };
+  constexpr int kBenchModulationBlocks = 2000;
+  constexpr int kBenchAudioModulationCounts[] = { 0, 16, 64 };
+  constexpr int kBenchAudioModulationRuns = 5;
+  constexpr int kBenchLoadSampleRate = 44100;
+  constexpr float kBenchLoadSampleSeconds = 30.0f;
+  constexpr int kBenchLoadIterations = 5;
+} // namespace
+
+struct BenchConfig {
+  int buffer_size;
+  int sample_rate;
+  int oversampling;
+};
+
+struct BenchResult {
+  double realtime_factor;
+  double p50_us;
+  double p99_us;
+  double max_us;
+  double budget_us;
+  double process_seconds;
+};
+
+class EngineBenchmark {
+  public:
+    enum Variant {
+      kFull,
+      kNoEffects,
+      kNoFilters,
+      kNoModulation,
+      kNumVariants
+    };
+
+    EngineBenchmark(std::vector<int> notes, float length, bool profile) :
+        notes_(std::move(notes)), length_(length), profile_(profile) { }
+
+    json benchmarkPreset(const File& preset, const std::vector<BenchConfig>& configs) {
+      json data;
+      data["preset"] = preset == File() ? "init" : preset.getFullPathName().toStdString();
+
+      std::string error;
+      if (!loadPreset(preset, Variant::kFull, error)) {
+        data["error"] = error;
+        std::cout << "Error: " << error << std::endl;
+        return data;
+      }
+
+      std::cout << (preset == File() ? String("init") : preset.getFileName()) << std::endl;
+      if (profile_) {
+        synth_.refreshProcessorProfile();
+        synth_.resetProcessorProfile();
+      }
+
+      json results;
+      std::vector<BenchResult> full_results;
+      for (const BenchConfig& config : configs) {
+        BenchResult result = run(config);
+        full_results.push_back(result);
+        printResult(config, result);
+        results.push_back(resultToJson(config, result));
+
+        if (profile_ && full_results.size() == 1) {
+          data["profile"] = profileToJson(synth_);
+          printProfile(synth_);
+        }
+      }
+      data["results"] = results;
+
+      // Subsystem shares are measured by rerunning the first configuration with a subsystem bypassed.
+      double full_seconds = full_results[0].process_seconds;
+      json cpu_share;
+      double remaining = 1.0;
+      for (int variant = kNoEffects; variant < kNumVariants; ++variant) {
+        if (!loadPreset(preset, static_cast<Variant>(variant), error))
+          break;
+
+        double seconds = run(configs[0]).process_seconds;
+        double share = std::max(0.0, (full_seconds - seconds) / full_seconds);
+        remaining -= share;
+        cpu_share[variantName(static_cast<Variant>(variant))] = share;
+      }
+      cpu_share["voices"] = std::max(0.0, remaining);
+      data["cpu_share"] = cpu_share;
+
+      std::cout << "  cpu share:";
+      for (auto& share : cpu_share.items())
+        std::cout << " " << share.key() << " " << String(100.0 * share.value().get<double>(), 1) << "%";
+      std::cout << std::endl;
+
+      return data;
+    }
+
+  private:
+    static const char* variantName(Variant variant) {
+      switch (variant) {
+        case kNoEffects:
+          return "effects";
+        case kNoFilters:
+          return "filters";
+        case kNoModulation:
+          return "modulation";
+        default:
+          return "full";
+      }
+    }
+
+    bool loadPreset(const File& preset, Variant variant, std::string& error) {
+      if (preset == File())
+        synth_.loadInitPreset();
+      else if (!preset.existsAsFile()) {
+        error = "Preset file doesn't exist: " + preset.getFullPathName().toStdString();
+        return false;
+      }
+      else if (!synth_.loadFromFile(preset, error))
+        return false;
+
+      if (variant == kNoEffects)
+        turnOff(kBenchEffectControls);
+      else if (variant == kNoFilters)
+        turnOff(kBenchFilterControls);
+      else if (variant == kNoModulation)
+        synth_.clearModulations();
+      return true;
+    }
+
+    template<size_t size>
+    void turnOff(const char* (&names)[size]) {
+      vital::control_map& controls = synth_.getControls();
+      for (const char* name : names) {
+        if (controls.count(name))
+          synth_.valueChanged(name, 0.0f);
+      }
+    }
+
+    static void processBlock(vital::SoundEngine* engine, int buffer_size) {
+      for (int offset = 0; offset < buffer_size; offset += vital::kMaxBufferSize)
+        engine->process(std::min(buffer_size - offset, vital::kMaxBufferSize));
+    }
+
+    void playChord(vital::SoundEngine* engine, int chord_index) {
+      int last_transpose = ((chord_index + 1) % 2) * kBenchTransposeStep;
+      int transpose = (chord_index % 2) * kBenchTransposeStep;
+      for (int note : notes_) {
+        if (chord_index > 0)
+          engine->noteOff(note + last_transpose, kBenchVelocity, 0, 0);
+      }
+      for (int note : notes_)
+        engine->noteOn(note + transpose, kBenchVelocity, 0, 0);
+    }
+
+    BenchResult run(const BenchConfig& config) {
+      vital::SoundEngine* engine = synth_.getEngine();
+      ScopedLock lock(synth_.getCriticalSection());
+
+      synth_.valueChanged("oversampling", static_cast<int>(std::log2(config.oversampling)));
+      engine->allSoundsOff();
+      engine->setSampleRate(config.sample_rate);
+      synth_.checkOversampling();
+      engine->updateAllModulationSwitches();
+
+      double block_time = config.buffer_size / static_cast<double>(config.sample_rate);
+      double current_time = -kBenchWarmupSeconds;
+      int warmup_samples = kBenchWarmupSeconds * config.sample_rate;
+      for (int samples = 0; samples < warmup_samples; samples += config.buffer_size) {
+        engine->correctToTime(current_time);
+        current_time += block_time;
+        processBlock(engine, config.buffer_size);
+      }
+
+      int total_samples = length_ * config.sample_rate;
+      int chord_samples = kBenchChordSeconds * config.sample_rate;
+      int next_chord = 0;
+      int chord_index = 0;
+      std::vector<double> block_seconds;
+      block_seconds.reserve(total_samples / config.buffer_size + 1);
+      int64 total_ticks = 0;
+
+      for (int samples = 0; samples < total_samples; samples += config.buffer_size) {
+        engine->correctToTime(current_time);
+        current_time += block_time;
+
+        int64 start = Time::getHighResolutionTicks();
+        if (samples >= next_chord) {
+          playChord(engine, chord_index++);
+          next_chord += chord_samples;
+        }
+        processBlock(engine, config.buffer_size);
+        int64 ticks = Time::getHighResolutionTicks() - start;
+
+        total_ticks += ticks;
+        block_seconds.push_back(Time::highResolutionTicksToSeconds(ticks));
+      }
+      engine->allSoundsOff();
+
+      std::sort(block_seconds.begin(), block_seconds.end());
+      int num_blocks = static_cast<int>(block_seconds.size());
+      BenchResult result;
+      result.process_seconds = Time::highResolutionTicksToSeconds(total_ticks);
+      result.realtime_factor = num_blocks * block_time / std::max(result.process_seconds, 1e-9);
+      result.p50_us = 1e6 * block_seconds[num_blocks / 2];
+      result.p99_us = 1e6 * block_seconds[std::min(num_blocks - 1, (99 * num_blocks) / 100)];
+      result.max_us = 1e6 * block_seconds[num_blocks - 1];
+      result.budget_us = 1e6 * block_time;
+      return result;
+    }
+
+    static json resultToJson(const BenchConfig& config, const BenchResult& result) {
+      json data;
+      data["buffer_size"] = config.buffer_size;
+      data["sample_rate"] = config.sample_rate;
+      data["oversampling"] = config.oversampling;
+      data["realtime_factor"] = result.realtime_factor;
+      data["block_p50_us"] = result.p50_us;
+      data["block_p99_us"] = result.p99_us;
+      data["block_max_us"] = result.max_us;
+      data["block_budget_us"] = result.budget_us;
+      return data;
+    }
+
+    static void printResult(const BenchConfig& config, const BenchResult& result) {
+      std::cout << "  buffer " << String(config.buffer_size).paddedLeft(' ', 5)
+                << "  rate " << String(config.sample_rate).paddedLeft(' ', 6)
+                << "  oversampling " << config.oversampling << "x"
+                << "  realtime " << String(result.realtime_factor, 1).paddedLeft(' ', 7) << "x"
+                << "  p50 " << String(result.p50_us, 1) << " us"
+                << "  p99 " << String(result.p99_us, 1) << " us"
+                << "  max " << String(result.max_us, 1) << " us" << std::endl;
+    }
+
+    std::vector<int> notes_;
+    float length_;
+    bool profile_;
+    HeadlessSynth synth_;
+};
+
+// Times the Upsampler and Decimator cascades that wrap oversampled effects, per base rate sample.
+json benchmarkResampling(const std::vector<int>& oversampling) {
+  json results;
+  Random random(0);
+  vital::poly_float audio[vital::kMaxBufferSize];
+  for (int i = 0; i < vital::kMaxBufferSize; ++i)
+    audio[i] = vital::poly_float(random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 2.0f - 1.0f);
+
+  std::cout << "resampling" << std::endl;
+  for (int amount : oversampling) {
+    if (amount <= 1)
+      continue;
+
+    vital::Upsampler upsampler(kBenchResamplingStages);
+    upsampler.setSampleRate(vital::kDefaultSampleRate);
+    upsampler.setOversampleAmount(amount);
+
+    vital::Decimator decimator(kBenchResamplingStages);
+    decimator.setSampleRate(vital::kDefaultSampleRate);
+    decimator.plug(&upsampler, vital::Decimator::kAudio);
+    decimator.init();
+
+    int64 upsample_ticks = 0;
+    int64 decimate_ticks = 0;
+    for (int i = 0; i < kBenchResamplingBlocks; ++i) {
+      int64 start = Time::getHighResolutionTicks();
+      upsampler.processWithInput(audio, vital::kMaxBufferSize);
+      int64 upsampled = Time::getHighResolutionTicks();
+      decimator.process(vital::kMaxBufferSize);
+      decimate_ticks += Time::getHighResolutionTicks() - upsampled;
+      upsample_ticks += upsampled - start;
+    }
+
+    double samples = static_cast<double>(kBenchResamplingBlocks) * vital::kMaxBufferSize;
+    double upsample_ns = 1e9 * Time::highResolutionTicksToSeconds(upsample_ticks) / samples;
+    double decimate_ns = 1e9 * Time::highResolutionTicksToSeconds(decimate_ticks) / samples;
+    std::cout << "  oversampling " << amount << "x"
+              << "  upsample " << String(upsample_ns, 2) << " ns/sample"
+              << "  decimate " << String(decimate_ns, 2) << " ns/sample" << std::endl;
+
+    json result;
+    result["oversampling"] = amount;
+    result["upsample_ns"] = upsample_ns;
+    result["decimate_ns"] = decimate_ns;
+    results.push_back(result);
+  }
+
+  return results;
+}
+
+// Bytes allocated on the heap right now, or -1 where the platform doesn't report it.
+int64 heapBytesInUse() {
+#if JUCE_LINUX && defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  return static_cast<int64>(mallinfo2().uordblks);
+#elif JUCE_MAC
+  malloc_statistics_t statistics;
+  malloc_zone_statistics(nullptr, &statistics);
+  return static_cast<int64>(statistics.size_in_use);
+#else
+  return -1;
+#endif
+}
+
+// Heap used by one more voice, measured by cloning the router voices are copied from.
+int64 measureVoiceBytes(vital::SoundEngine* engine) {
+  int64 start = heapBytesInUse();
+  if (start < 0)
+    return -1;
+
+  std::unique_ptr<vital::Processor> voice(engine->getVoiceRouter()->clone());
+  int64 clone_bytes = heapBytesInUse() - start;
+  return clone_bytes / (vital::poly_float::kSize / 2);
+}
+
+class ModulationBenchSynth : public HeadlessSynth {
+  public:
+    void applyModulationChanges() { processModulationChanges(); }
+};
+
+// Average time of one block with the notes held, after a warmup.
+double timeModulationBlocks(vital::SoundEngine* engine, const std::vector<int>& notes) {
+  for (int note : notes)
+    engine->noteOn(note, kBenchVelocity, 0, 0);
+  for (int i = 0; i < kBenchModulationBlocks / 4; ++i)
+    engine->process(vital::kMaxBufferSize);
+
+  int64 start = Time::getHighResolutionTicks();
+  for (int i = 0; i < kBenchModulationBlocks; ++i)
+    engine->process(vital::kMaxBufferSize);
+  double block_us = 1e6 * Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) /
+                    kBenchModulationBlocks;
+  engine->allSoundsOff();
+  return block_us;
+}
+
+// Times voice processing and measures voice memory against the number of connected modulations.
+json benchmarkModulationScaling(const std::vector<int>& notes) {
+  json results;
+  std::cout << "modulation scaling  slots " << vital::kMaxModulationConnections << std::endl;
+  for (int num_connections : kBenchModulationCounts) {
+    ModulationBenchSynth synth;
+    synth.loadInitPreset();
+    vital::SoundEngine* engine = synth.getEngine();
+    ScopedLock lock(synth.getCriticalSection());
+
+    std::vector<std::string> sources;
+    for (auto& source : engine->getModulationSources()) {
+      for (const char* prefix : kBenchModulationSources) {
+        if (source.first.rfind(prefix, 0) == 0)
+          sources.push_back(source.first);
+      }
+    }
+
+    std::vector<std::string> destinations;
+    for (auto& destination : engine->getPolyModulationDestinations()) {
+      if (destination.first.rfind("modulation_", 0) != 0)
+        destinations.push_back(destination.first);
+    }
+
+    int connected = 0;
+    int num_pairs = static_cast<int>(sources.size() * destinations.size());
+    for (int i = 0; connected < num_connections && i < num_pairs; ++i) {
+      if (synth.connectModulation(sources[i % sources.size()], destinations[i % destinations.size()]))
+        connected++;
+    }
+    synth.applyModulationChanges();
+    engine->updateAllModulationSwitches();
+    int64 voice_bytes = measureVoiceBytes(engine);
+
+    double block_us = timeModulationBlocks(engine, notes);
+
+    std::cout << "  active " << String(connected).paddedLeft(' ', 4)
+              << "  block " << String(block_us, 1) << " us";
+    if (voice_bytes >= 0)
+      std::cout << "  voice " << String(voice_bytes / 1024.0, 1) << " KB";
+    std::cout << std::endl;
+
+    json result;
+    result["active"] = connected;
+    result["block_us"] = block_us;
+    if (voice_bytes >= 0)
+      result["voice_bytes"] = voice_bytes;
+    results.push_back(result);
+  }
+
+  return results;
+}
+
+// Times audio rate connections summed in place by their destination against every connection filling its own
+// buffer first, the way they were evaluated before. Both run on the same engine in turns and the best run counts.
+json benchmarkModulationEvaluation(const std::vector<int>& notes) {
+  json results;
+  std::cout << "audio rate modulation  buffered / summed" << std::endl;
+  for (int num_connections : kBenchAudioModulationCounts) {
+    ModulationBenchSynth synth;
+    synth.loadInitPreset();
+    vital::SoundEngine* engine = synth.getEngine();
+    ScopedLock lock(synth.getCriticalSection());
+
+    std::vector<std::string> sources;
+    for (auto& source : engine->getModulationSources()) {
+      for (const char* prefix : kBenchModulationSources) {
+        if (source.first.rfind(prefix, 0) == 0)
+          sources.push_back(source.first);
+      }
+    }
+
+    // Only destinations summed at audio rate evaluate their connections in place.
+    std::vector<std::string> destinations;
+    for (auto& destination : engine->getPolyModulationDestinations()) {
+      if (dynamic_cast<vital::ModulationSum*>(destination.second))
+        destinations.push_back(destination.first);
+    }
+
+    int connected = 0;
+    int num_pairs = static_cast<int>(sources.size() * destinations.size());
+    for (int i = 0; connected < num_connections && i < num_pairs; ++i) {
+      if (synth.connectModulation(sources[i % sources.size()], destinations[i % destinations.size()]))
+        connected++;
+    }
+    synth.applyModulationChanges();
+    engine->updateAllModulationSwitches();
+
+    int audio_rate = 0;
+    vital::ModulationConnectionBank& bank = engine->getModulationBank();
+    for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
+      vital::ModulationConnectionProcessor* processor = bank.atIndex(i)->modulation_processor.get();
+      if (processor->enabled() && !processor->isControlRate())
+        audio_rate++;
+    }
+
+    double buffered_us = std::numeric_limits<double>::max();
+    double summed_us = std::numeric_limits<double>::max();
+    for (int run = 0; run < kBenchAudioModulationRuns; ++run) {
+      vital::ModulationConnectionProcessor::setDeferredEvaluation(false);
+      buffered_us = std::min(buffered_us, timeModulationBlocks(engine, notes));
+      vital::ModulationConnectionProcessor::setDeferredEvaluation(true);
+      summed_us = std::min(summed_us, timeModulationBlocks(engine, notes));
+    }
+
+    std::cout << "  audio rate " << String(audio_rate).paddedLeft(' ', 4)
+              << "  block " << String(buffered_us, 1) << " / " << String(summed_us, 1) << " us" << std::endl;
+
+    json result;
+    result["audio_rate"] = audio_rate;
+    result["buffered_us"] = buffered_us;
+    result["summed_us"] = summed_us;
+    results.push_back(result);
+  }
+
+  return results;
+}
+
+template<size_t size>
+std::vector<int> getBenchValues(int argc, const char* argv[], const String& flag,
+                                const int (&defaults)[size], int min, int max) {
+  StringArray tokens;
+  tokens.addTokens(getArgumentValue(argc, argv, flag, flag), ",; ", "");
+  tokens.removeEmptyStrings();
+
+  std::vector<int> values;
+  for (const String& token : tokens) {
+    int value = token.getIntValue();
+    if (value >= min && value <= max)
+      values.push_back(value);
+  }
+
+  if (values.empty())
+    values.assign(std::begin(defaults), std::end(defaults));
+  return values;
+}
+
+int doBenchmark(int argc, const char* argv[]) {
+  String bench_path = getArgumentValue(argc, argv, "--bench", "--bench").unquoted();
+  std::vector<File> presets;
+  if (bench_path == "init")
+    presets.push_back(File());
+  else {
+    File bench_file = File::getCurrentWorkingDirectory().getChildFile(bench_path);
+    if (bench_file.isDirectory()) {
+      Array<File> files = bench_file.findChildFiles(File::findFiles, true, String("*.") + vital::kPresetExtension);
+      files.sort();
+      for (const File& file : files)
+        presets.push_back(file);
+    }
+    else
+      presets.push_back(bench_file);
+  }
+
+  if (presets.empty()) {
+    std::cout << "Error: No presets found to benchmark." << std::endl;
+    return 1;
+  }
+
+  std::vector<int> buffer_sizes = getBenchValues(argc, argv, "--buffer-sizes", kBenchDefaultBufferSizes,
+                                                 1, kBenchMaxBufferSize);
+  std::vector<int> sample_rates = getBenchValues(argc, argv, "--sample-rates", kBenchDefaultSampleRates,
+                                                 kBatchMinSampleRate, kBatchMaxSampleRate);
+  std::vector<int> oversampling = getBenchValues(argc, argv, "--oversampling", kBenchDefaultOversampling,
+                                                 1, kBenchMaxOversampling);
+
+  std::vector<BenchConfig> configs;
+  for (int sample_rate : sample_rates) {
+    for (int amount : oversampling) {
+      for (int buffer_size : buffer_sizes)
+        configs.push_back({ buffer_size, sample_rate, amount });
+    }
+  }
+
+  float length = kBenchDefaultLength;
+  String string_length = getArgumentValue(argc, argv, "-l", "--length");
+  if (string_length.getFloatValue() > 0.0f)
+    length = std::min(string_length.getFloatValue(), kBenchMaxLength);
+
+  std::vector<int> notes = parseMidiNotes(getArgumentValue(argc, argv, "-m", "--midi"));
+  if (notes.empty())
+    notes.assign(std::begin(kBenchDefaultNotes), std::end(kBenchDefaultNotes));
+
+  EngineBenchmark benchmark(notes, length, hasFlag(argc, argv, "-p", "--profile"));
+  json results;
+  results["length"] = length;
+  results["notes"] = notes;
+  for (const File& preset : presets)
+    results["presets"].push_back(benchmark.benchmarkPreset(preset, configs));
+  results["resampling"] = benchmarkResampling(oversampling);
+  results["modulation_scaling"] = benchmarkModulationScaling(notes);
+  results["modulation_evaluation"] = benchmarkModulationEvaluation(notes);
+
+  String output_path = getArgumentValue(argc, argv, "-o", "--output");
+  if (output_path.isNotEmpty()) {
+    File output_file = File::getCurrentWorkingDirectory().getChildFile(output_path.unquoted());
+    if (!output_file.replaceWithText(results.dump(2))) {
+      std::cout << "Error: Couldn't write benchmark results." << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+struct PitchBenchSignal {
+  std::string name;
+  float expected_period;
+  std::vector<float> audio;
+};
+
+// Harmonic series with a per waveform shape so the corpus isn't all one spectrum.
+float harmonicAmplitude(int shape, int harmonic) {
+  if (shape == 0)
+    return 1.0f / harmonic;
+  if (shape == 1)
+    return (harmonic % 2) ? 1.0f / harmonic : 0.0f;
+  if (shape == 2)
+    return (harmonic % 2) ? 1.0f / (harmonic * harmonic) : 0.0f;
+  return 1.0f / std::sqrt(static_cast<float>(harmonic));
+}
+
+float periodCents(float period, float reference) {
+  return std::abs(1200.0f * std::log2(period / reference));
+}
+
+std::vector<PitchBenchSignal> createPitchBenchCorpus() {
+  std::vector<PitchBenchSignal> corpus;
+  Random random(0);
+  int shape = 0;
+
+  for (float period : kBenchSingleCyclePeriods) {
+    PitchBenchSignal signal;
+    signal.name = "single_cycle_" + String(period, 2).toStdString();
+    signal.expected_period = period;
+    signal.audio.resize(3 * FileSource::kPitchDetectMaxPeriod);
+
+    int num_harmonics = std::min<int>(kBenchPitchHarmonics, period / 2.0f);
+    float phases[kBenchPitchHarmonics];
+    for (int h = 0; h < num_harmonics; ++h)
+      phases[h] = random.nextFloat() * vital::kPi;
+
+    for (int i = 0; i < signal.audio.size(); ++i) {
+      float value = 0.0f;
+      for (int h = 1; h <= num_harmonics; ++h)
+        value += harmonicAmplitude(shape, h) * sinf(2.0f * vital::kPi * h * i / period + phases[h - 1]);
+      signal.audio[i] = value;
+    }
+
+    shape = (shape + 1) % 4;
+    corpus.push_back(std::move(signal));
+  }
+
+  for (int note : kBenchPitchedNotes) {
+    PitchBenchSignal signal;
+    signal.name = "pitched_note_" + std::to_string(note);
+    float frequency = vital::utils::midiNoteToFrequency(note);
+    signal.expected_period = kBenchPitchSampleRate / frequency;
+    signal.audio.resize(kBenchPitchSampleRate);
+
+    // Slightly stretched partials with their own decays and some noise, like a plucked recording.
+    float decays[kBenchPitchHarmonics];
+    float phases[kBenchPitchHarmonics];
+    for (int h = 0; h < kBenchPitchHarmonics; ++h) {
+      decays[h] = (1.0f + h * 0.5f) / kBenchPitchSampleRate;
+      phases[h] = random.nextFloat() * vital::kPi;
+    }
+
+    for (int i = 0; i < signal.audio.size(); ++i) {
+      float value = 0.0f;
+      for (int h = 1; h <= kBenchPitchHarmonics; ++h) {
+        float partial = h * frequency * (1.0f + 0.00002f * h * h);
+        if (partial >= kBenchPitchSampleRate / 2)
+          break;
+
+        float amplitude = harmonicAmplitude(shape, h) * expf(-decays[h - 1] * i);
+        value += amplitude * sinf(2.0f * vital::kPi * partial * i / kBenchPitchSampleRate + phases[h - 1]);
+      }
+      signal.audio[i] = value + 0.01f * (random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    shape = (shape + 1) % 4;
+    corpus.push_back(std::move(signal));
+  }
+
+  return corpus;
+}
+
+void addPitchBenchFiles(std::vector<PitchBenchSignal>& corpus, const File& directory) {
+  AudioFormatManager format_manager;
+  format_manager.registerBasicFormats();
+
+  Array<File> files = directory.findChildFiles(File::findFiles, true, format_manager.getWildcardForAllFormats());
+  files.sort();
+  for (const File& file : files) {
+    std::unique_ptr<AudioFormatReader> reader(format_manager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples < FileSource::kPitchDetectMaxPeriod)
+      continue;
+
+    int num_samples = reader->lengthInSamples;
+    AudioSampleBuffer buffer(1, num_samples);
+    reader->read(&buffer, 0, num_samples, 0, true, false);
+
+    PitchBenchSignal signal;
+    signal.name = file.getFileName().toStdString();
+    signal.expected_period = 0.0f;
+    signal.audio.assign(buffer.getReadPointer(0), buffer.getReadPointer(0) + num_samples);
+    corpus.push_back(std::move(signal));
+  }
+}
+
+// Compares the brute force error search against the fft yin search on the window FileSource analyzes.
+int doPitchBenchmark(int argc, const char* argv[]) {
+  String corpus_path = getArgumentValue(argc, argv, "--bench-pitch", "--bench-pitch").unquoted();
+  std::vector<PitchBenchSignal> corpus = createPitchBenchCorpus();
+  if (corpus_path != "synthetic")
+    addPitchBenchFiles(corpus, File::getCurrentWorkingDirectory().getChildFile(corpus_path));
+
+  json results;
+  double total_error_seconds = 0.0;
+  double total_yin_seconds = 0.0;
+  float max_difference = 0.0f;
+  float max_error_search_cents = 0.0f;
+  float max_yin_cents = 0.0f;
+  int mismatches = 0;
+  for (const PitchBenchSignal& signal : corpus) {
+    int start = (static_cast<int>(signal.audio.size()) - FileSource::kPitchDetectMaxPeriod) / 3;
+    PitchDetector detector;
+    detector.loadSignal(signal.audio.data() + start, FileSource::kPitchDetectMaxPeriod);
+
+    int64 start_ticks = Time::getHighResolutionTicks();
+    float error_period = detector.findErrorPeriod(vital::WaveFrame::kWaveformSize);
+    int64 error_ticks = Time::getHighResolutionTicks();
+    float yin_period = detector.findYinPeriod(vital::WaveFrame::kWaveformSize);
+    int64 yin_ticks = Time::getHighResolutionTicks();
+
+    double error_seconds = Time::highResolutionTicksToSeconds(error_ticks - start_ticks);
+    double yin_seconds = Time::highResolutionTicksToSeconds(yin_ticks - error_ticks);
+    total_error_seconds += error_seconds;
+    total_yin_seconds += yin_seconds;
+
+    float difference = periodCents(yin_period, error_period);
+    max_difference = std::max(max_difference, difference);
+    if (difference > kBenchPitchToleranceCents)
+      mismatches++;
+    if (signal.expected_period) {
+      max_error_search_cents = std::max(max_error_search_cents, periodCents(error_period, signal.expected_period));
+      max_yin_cents = std::max(max_yin_cents, periodCents(yin_period, signal.expected_period));
+    }
+
+    std::cout << signal.name << "  error search " << String(error_period, 2)
+              << " (" << String(1000.0 * error_seconds, 2) << " ms)"
+              << "  yin " << String(yin_period, 2)
+              << " (" << String(1000.0 * yin_seconds, 2) << " ms)";
+    if (signal.expected_period)
+      std::cout << "  expected " << String(signal.expected_period, 2);
+    std::cout << std::endl;
+
+    json result;
+    result["name"] = signal.name;
+    if (signal.expected_period)
+      result["expected_period"] = signal.expected_period;
+    result["error_period"] = error_period;
+    result["error_ms"] = 1000.0 * error_seconds;
+    result["yin_period"] = yin_period;
+    result["yin_ms"] = 1000.0 * yin_seconds;
+    results["signals"].push_back(result);
+  }
+
+  double speedup = total_error_seconds / std::max(total_yin_seconds, 1e-9);
+  std::cout << "max difference " << String(max_difference, 2) << " cents  mismatches " << mismatches
+            << "  speedup " << String(speedup, 1) << "x" << std::endl;
+  std::cout << "max synthetic error  error search " << String(max_error_search_cents, 2) << " cents"
+            << "  yin " << String(max_yin_cents, 2) << " cents" << std::endl;
+
+  results["max_difference_cents"] = max_difference;
+  results["mismatches"] = mismatches;
+  results["max_error_search_cents"] = max_error_search_cents;
+  results["max_yin_cents"] = max_yin_cents;
+  results["speedup"] = speedup;
+
+  String output_path = getArgumentValue(argc, argv, "-o", "--output");
+  if (output_path.isNotEmpty()) {
+    File output_file = File::getCurrentWorkingDirectory().getChildFile(output_path.unquoted());
+    if (!output_file.replaceWithText(results.dump(2))) {
+      std::cout << "Error: Couldn't write benchmark results." << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+// Preset carrying a long stereo sample, where json loading is dominated by decoding base64 audio.
+json createLoadBenchPreset() {
+  int length = kBenchLoadSampleSeconds * kBenchLoadSampleRate;
+  std::vector<vital::mono_float> left(length);
+  std::vector<vital::mono_float> right(length);
+  vital::utils::RandomGenerator random(-1.0f, 1.0f);
+  for (int i = 0; i < length; ++i) {
+    float phase = (2.0f * vital::kPi * 110.0f * i) / kBenchLoadSampleRate;
+    left[i] = 0.5f * sinf(phase) + 0.1f * random.next();
+    right[i] = 0.5f * cosf(phase) + 0.1f * random.next();
+  }
+
+  HeadlessSynth synth;
+  synth.getSample()->loadSample(left.data(), right.data(), length, kBenchLoadSampleRate);
+  synth.getSample()->setName("Load Bench");
+  return LoadSave::stateToJson(&synth, synth.getCriticalSection());
+}
+
+double timePresetLoad(HeadlessSynth& synth, const File& preset) {
+  double best_seconds = std::numeric_limits<double>::max();
+  for (int i = 0; i < kBenchLoadIterations; ++i) {
+    std::string error;
+    int64 start_ticks = Time::getHighResolutionTicks();
+    if (!synth.loadFromFile(preset, error))
+      return -1.0;
+    int64 end_ticks = Time::getHighResolutionTicks();
+    best_seconds = std::min(best_seconds, Time::highResolutionTicksToSeconds(end_ticks - start_ticks));
+  }
+  return best_seconds;
+}
+
+// Times loading each preset from json and from the binary format, best of several loads.
+int doPresetLoadBenchmark(int argc, const char* argv[]) {
+  String bench_path = getArgumentValue(argc, argv, "--bench-preset-load", "--bench-preset-load").unquoted();
+  std::vector<std::pair<std::string, json>> presets;
+  if (bench_path == "init")
+    presets.push_back({ "init", createLoadBenchPreset() });
+  else {
+    File bench_file = File::getCurrentWorkingDirectory().getChildFile(bench_path);
+    Array<File> files;
+    if (bench_file.isDirectory())
+      files = bench_file.findChildFiles(File::findFiles, true, String("*.") + vital::kPresetExtension);
+    else
+      files.add(bench_file);
+    files.sort();
+
+    for (const File& file : files) {
+      try {
+        json state;
+        if (!BinaryPreset::isBinary(file))
+          state = json::parse(file.loadFileAsString().toStdString(), nullptr);
+        else {
+          MemoryBlock data;
+          if (!file.loadFileAsData(data) || !BinaryPreset::toJson(data.getData(), data.getSize(), state))
+            continue;
+        }
+        presets.push_back({ file.getFileNameWithoutExtension().toStdString(), state });
+      }
+      catch (const json::exception& e) {
+        std::cout << "Skipping corrupted preset " << file.getFileName() << std::endl;
+      }
+    }
+  }
+
+  if (presets.empty()) {
+    std::cout << "Error: No presets found to benchmark." << std::endl;
+    return 1;
+  }
+
+  HeadlessSynth synth;
+  json results;
+  double total_json_seconds = 0.0;
+  double total_binary_seconds = 0.0;
+  for (const auto& preset : presets) {
+    TemporaryFile json_file(String(".") + vital::kPresetExtension);
+    TemporaryFile binary_file(String(".") + vital::kPresetExtension);
+    if (!json_file.getFile().replaceWithText(preset.second.dump()) ||
+        !BinaryPreset::writeFile(binary_file.getFile(), preset.second)) {
+      std::cout << "Error: Couldn't write " << preset.first << std::endl;
+      return 1;
+    }
+
+    double json_seconds = timePresetLoad(synth, json_file.getFile());
+    double binary_seconds = timePresetLoad(synth, binary_file.getFile());
+    if (json_seconds < 0.0 || binary_seconds < 0.0) {
+      std::cout << "Error: Couldn't load " << preset.first << std::endl;
+      return 1;
+    }
+    total_json_seconds += json_seconds;
+    total_binary_seconds += binary_seconds;
+
+    int64 json_size = json_file.getFile().getSize();
+    int64 binary_size = binary_file.getFile().getSize();
+    std::cout << preset.first << "  json " << json_size << " bytes (" << String(1000.0 * json_seconds, 2) << " ms)"
+              << "  binary " << binary_size << " bytes (" << String(1000.0 * binary_seconds, 2) << " ms)"
+              << std::endl;
+
+    json result;
+    result["name"] = preset.first;
+    result["json_bytes"] = json_size;
+    result["json_ms"] = 1000.0 * json_seconds;
+    result["binary_bytes"] = binary_size;
+    result["binary_ms"] = 1000.0 * binary_seconds;
+    results["presets"].push_back(result);
+  }
+
+  double speedup = total_json_seconds / std::max(total_binary_seconds, 1e-9);
+  std::cout << "speedup " << String(speedup, 1) << "x" << std::endl;
+  results["speedup"] = speedup;
+
+  String output_path = getArgumentValue(argc, argv, "-o", "--output");
+  if (output_path.isNotEmpty()) {
+    File output_file = File::getCurrentWorkingDirectory().getChildFile(output_path.unquoted());
+    if (!output_file.replaceWithText(results.dump(2))) {
+      std::cout << "Error: Couldn't write benchmark results." << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+// Converts json presets to the binary format and binary presets back to json.
+int doConvertPreset(int argc, const char* argv[]) {
+  String input_path = getArgumentValue(argc, argv, "--convert-preset", "--convert-preset").unquoted();
+  String output_path = getArgumentValue(argc, argv, "-o", "--output").unquoted();
+  if (input_path.isEmpty() || output_path.isEmpty()) {
+    std::cout << "Usage: --convert-preset <input> -o <output>" << std::endl;
+    return 1;
+  }
+
+  File input_file = File::getCurrentWorkingDirectory().getChildFile(input_path);
+  File output_file = File::getCurrentWorkingDirectory().getChildFile(output_path);
+  if (!BinaryPreset::convertFile(input_file, output_file)) {
+    std::cout << "Error: Couldn't convert " << input_file.getFullPathName() << std::endl;
+    return 1;
+  }
+  return 0;
 }
 
 bool loadFromCommandLine(HeadlessSynth& synth, const String& command_line) {
@@ -128,6 +1476,24 @@ bool loadFromCommandLine(HeadlessSynth& synth, const String& command_line) {
 }
 
 int main(int argc, const char* argv[]) {
+  String wavetable_cache = getArgumentValue(argc, argv, "--wavetable-cache", "--wavetable-cache").unquoted();
+  if (wavetable_cache.isNotEmpty())
+    WavetableCache::setDirectory(File::getCurrentWorkingDirectory().getChildFile(wavetable_cache));
+
+  if (hasFlag(argc, argv, "--bench", "--bench"))
+    return doBenchmark(argc, argv);
+  if (hasFlag(argc, argv, "--bench-pitch", "--bench-pitch"))
+    return doPitchBenchmark(argc, argv);
+
+  // Renders load sample levels and stream blocks when they're played so output doesn't depend on thread timing.
+  vital::Sample::setBackgroundLoading(false);
+  if (hasFlag(argc, argv, "--batch", "--batch"))
+    return doBatchRender(argc, argv);
+  if (hasFlag(argc, argv, "--bench-preset-load", "--bench-preset-load"))
+    return doPresetLoadBenchmark(argc, argv);
+  if (hasFlag(argc, argv, "--convert-preset", "--convert-preset"))
+    return doConvertPreset(argc, argv);
+
   HeadlessSynth headless_synth;
   
   bool last_arg_was_option = false;
@@ -136,7 +1502,7 @@ int main(int argc, const char* argv[]) {
     if (arg != "" && arg[0] != '-' && !last_arg_was_option && loadFromCommandLine(headless_synth, arg))
       break;
 
-    last_arg_was_option = arg[0] == '-' && arg != "--headless";
+    last_arg_was_option = arg != "" && arg[0] == '-' && !isBooleanFlag(arg);
   }
   
   doRenderToFile(headless_synth, argc, argv);
@@ -20,15 +20,29 @@
 #include "synth_constants.h"
 #include "skin.h"
 #include "shaders.h"
+#include "synth_gui_interface.h"
 #include "utils.h"
 
-Oscilloscope::Oscilloscope() : OpenGlLineRenderer(kResolution) {
+Oscilloscope::Oscilloscope() : OpenGlLineRenderer(kResolution), window_() {
   memory_ = nullptr;
   setFill(true);
   addRoundedCorners();
 }
 
-Oscilloscope::~Oscilloscope() { }
+Oscilloscope::~Oscilloscope() {
+  setAudioMemory(nullptr);
+}
+
+void Oscilloscope::setAudioMemory(vital::AudioCapture* memory) {
+  if (memory_ == memory)
+    return;
+
+  if (memory_)
+    memory_->removeConsumer();
+  memory_ = memory;
+  if (memory_)
+    memory_->addConsumer();
+}
 
 void Oscilloscope::drawWaveform(OpenGlWrapper& open_gl, int index) {
   float y_adjust = getHeight() / 2.0f;
@@ -39,8 +53,8 @@ void Oscilloscope::drawWaveform(OpenGlWrapper& open_gl, int index) {
       float memory_spot = (1.0f * i * vital::kOscilloscopeMemoryResolution) / kResolution;
       int memory_index = memory_spot;
       float remainder = memory_spot - memory_index;
-      float from = memory_[memory_index][index];
-      float to = memory_[memory_index + 1][index];
+      float from = window_[memory_index][index];
+      float to = window_[memory_index + 1][index];
       setXAt(i, t * width);
       setYAt(i, (1.0f - vital::utils::interpolate(from, to, remainder)) * y_adjust);
     }
@@ -49,6 +63,10 @@ void Oscilloscope::drawWaveform(OpenGlWrapper& open_gl, int index) {
 }
 
 void Oscilloscope::render(OpenGlWrapper& open_gl, bool animate) {
+  SynthGuiInterface* synth_interface = findParentComponentOfClass<SynthGuiInterface>();
+  if (memory_ && synth_interface)
+    SynthBase::readOscilloscopeMemory(memory_, synth_interface->getSynth()->getSampleRate(), window_);
+
   setLineWidth(findValue(Skin::kWidgetLineWidth));
   setFillCenter(findValue(Skin::kWidgetFillCenter));
 
@@ -87,7 +105,20 @@ Spectrogram::Spectrogram() : OpenGlLineRenderer(kResolution), transform_buffer_(
   addRoundedCorners();
 }
 
-Spectrogram::~Spectrogram() = default;
+Spectrogram::~Spectrogram() {
+  setAudioMemory(nullptr);
+}
+
+void Spectrogram::setAudioMemory(vital::AudioCapture* memory) {
+  if (memory_ == memory)
+    return;
+
+  if (memory_)
+    memory_->removeConsumer();
+  memory_ = memory;
+  if (memory_)
+    memory_->addConsumer();
+}
 
 void Spectrogram::applyWindow() {
   static constexpr double kRadianIncrement = vital::kPi / (kAudioSize - 1.0);
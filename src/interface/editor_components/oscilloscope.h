@@ -17,9 +17,10 @@
 #pragma once
 
 #include "JuceHeader.h"
-#include "memory.h"
+#include "audio_capture.h"
 #include "fourier_transform.h"
 #include "open_gl_line_renderer.h"
+#include "synth_constants.h"
 
 class Oscilloscope : public OpenGlLineRenderer {
   public:
@@ -30,10 +31,11 @@ class Oscilloscope : public OpenGlLineRenderer {
 
     void drawWaveform(OpenGlWrapper& open_gl, int index);
     void render(OpenGlWrapper& open_gl, bool animate) override;
-    void setOscilloscopeMemory(const vital::poly_float* memory) { memory_ = memory; }
+    void setAudioMemory(vital::AudioCapture* memory);
 
   private:
-    const vital::poly_float* memory_;
+    vital::AudioCapture* memory_;
+    vital::poly_float window_[vital::kOscilloscopeMemoryResolution + 1];
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Oscilloscope)
 };
@@ -55,7 +57,7 @@ class Spectrogram : public OpenGlLineRenderer {
 
     void drawWaveform(OpenGlWrapper& open_gl, int index);
     void render(OpenGlWrapper& open_gl, bool animate) override;
-    void setAudioMemory(const vital::StereoMemory* memory) { memory_ = memory; }
+    void setAudioMemory(vital::AudioCapture* memory);
     void paintBackground(Graphics& g) override;
     void setOversampleAmount(int oversample) { oversample_amount_ = oversample; }
     void setMinFrequency(float frequency) { min_frequency_ = frequency; }
@@ -79,7 +81,7 @@ class Spectrogram : public OpenGlLineRenderer {
     float transform_buffer_[2 * kAudioSize];
     float left_amps_[kAudioSize];
     float right_amps_[kAudioSize];
-    const vital::StereoMemory* memory_;
+    vital::AudioCapture* memory_;
     vital::FourierTransform transform_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Spectrogram)
@@ -314,11 +314,6 @@ void EqualizerSection::parentHierarchyChanged() {
 }
 
 void EqualizerSection::renderOpenGlComponents(OpenGlWrapper& open_gl, bool animate) {
-  if (parent_) {
-    int oversampling_amount = parent_->getSynth()->getEngine()->getOversamplingAmount();
-    if (oversampling_amount >= 1)
-      spectrogram_->setOversampleAmount(oversampling_amount);
-  }
   spectrogram_->setColour(Skin::kWidgetPrimary1, findColour(Skin::kLightenScreen, true));
   SynthSection::renderOpenGlComponents(open_gl, animate);
 }
@@ -515,14 +515,7 @@ void FullInterface::resized() {
     redoBackground();
 }
 
-void FullInterface::setOscilloscopeMemory(const vital::poly_float* memory) {
-  if (header_)
-    header_->setOscilloscopeMemory(memory);
-  if (master_controls_interface_)
-    master_controls_interface_->setOscilloscopeMemory(memory);
-}
-
-void FullInterface::setAudioMemory(const vital::StereoMemory* memory) {
+void FullInterface::setAudioMemory(vital::AudioCapture* memory) {
   if (header_)
     header_->setAudioMemory(memory);
   if (master_controls_interface_)
@@ -620,6 +613,11 @@ void FullInterface::renderOpenGL() {
     MessageManager::callAsync([=] { checkShouldReposition(true); });
   }
 
+  // All status readouts drawn this frame come from the same published audio block.
+  SynthGuiInterface* synth_interface = findParentComponentOfClass<SynthGuiInterface>();
+  if (synth_interface)
+    synth_interface->getSynth()->acquireTelemetry();
+
   ScopedLock lock(open_gl_critical_section_);
   open_gl_.display_scale = display_scale_;
   background_.render(open_gl_);
@@ -23,7 +23,7 @@
 #include "download_section.h"
 #include "header_section.h"
 #include "effects_interface.h"
-#include "memory.h"
+#include "audio_capture.h"
 #include "modulation_matrix.h"
 #include "open_gl_background.h"
 #include "shaders.h"
@@ -63,8 +63,7 @@ class FullInterface : public SynthSection, public AuthenticationSection::Listene
     FullInterface();
     virtual ~FullInterface();
 
-    void setOscilloscopeMemory(const vital::poly_float* memory);
-    void setAudioMemory(const vital::StereoMemory* memory);
+    void setAudioMemory(vital::AudioCapture* memory);
 
     void createModulationSliders(const vital::output_map& mono_modulations,
                                  const vital::output_map& poly_modulations);
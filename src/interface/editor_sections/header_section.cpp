@@ -342,11 +342,8 @@ void HeaderSection::setTemporaryTab(String name) {
   repaintBackground();
 }
 
-void HeaderSection::setOscilloscopeMemory(const vital::poly_float* memory) {
-  oscilloscope_->setOscilloscopeMemory(memory);
-}
-
-void HeaderSection::setAudioMemory(const vital::StereoMemory* memory) {
+void HeaderSection::setAudioMemory(vital::AudioCapture* memory) {
+  oscilloscope_->setAudioMemory(memory);
   spectrogram_->setAudioMemory(memory);
 }
 
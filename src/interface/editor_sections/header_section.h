@@ -91,8 +91,7 @@ class HeaderSection : public SynthSection, public SaveSection::Listener,
         listener->showAboutSection();
     }
 
-    void setOscilloscopeMemory(const vital::poly_float* memory);
-    void setAudioMemory(const vital::StereoMemory* memory);
+    void setAudioMemory(vital::AudioCapture* memory);
 
     void notifyChange();
     void notifyFresh();
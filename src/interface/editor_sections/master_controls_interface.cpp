@@ -561,11 +561,8 @@ class OutputDisplays : public SynthSection {
       spectrogram_->setBounds(x, spectrogram_y, width, spectrogram_height);
     }
 
-    void setOscilloscopeMemory(const vital::poly_float* memory) {
-      oscilloscope_->setOscilloscopeMemory(memory);
-    }
-
-    void setAudioMemory(const vital::StereoMemory* memory) {
+    void setAudioMemory(vital::AudioCapture* memory) {
+      oscilloscope_->setAudioMemory(memory);
       spectrogram_->setAudioMemory(memory);
     }
 
@@ -638,10 +635,6 @@ void MasterControlsInterface::passOscillatorSection(int index, const OscillatorS
   oscillator_advanceds_[index]->passOscillatorSection(oscillator);
 }
 
-void MasterControlsInterface::setOscilloscopeMemory(const vital::poly_float* memory) {
-  output_displays_->setOscilloscopeMemory(memory);
-}
-
-void MasterControlsInterface::setAudioMemory(const vital::StereoMemory* memory) {
+void MasterControlsInterface::setAudioMemory(vital::AudioCapture* memory) {
   output_displays_->setAudioMemory(memory);
 }
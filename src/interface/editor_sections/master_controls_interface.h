@@ -17,7 +17,7 @@
 #pragma once
 
 #include "JuceHeader.h"
-#include "memory.h"
+#include "audio_capture.h"
 #include "oscillator_advanced_section.h"
 #include "synth_constants.h"
 #include "synth_section.h"
@@ -73,8 +73,7 @@ class MasterControlsInterface  : public SynthSection {
 
     void setOscillatorBounds(int index, Rectangle<int> bounds) { oscillator_advanceds_[index]->setBounds(bounds); }
     void passOscillatorSection(int index, const OscillatorSection* oscillator);
-    void setOscilloscopeMemory(const vital::poly_float* memory);
-    void setAudioMemory(const vital::StereoMemory* memory);
+    void setAudioMemory(vital::AudioCapture* memory);
 
   private:
     std::unique_ptr<OscillatorAdvancedSection> oscillator_advanceds_[vital::kNumOscillators];
@@ -585,7 +585,7 @@ void ModulationManager::resized() {
 
 void ModulationManager::parentHierarchyChanged() {
   SynthSection::parentHierarchyChanged();
-  if (!modulation_source_readouts_.empty())
+  if (!source_readouts_.empty())
     return;
 
   SynthGuiInterface* parent = findParentComponentOfClass<SynthGuiInterface>();
@@ -593,9 +593,8 @@ void ModulationManager::parentHierarchyChanged() {
     return;
 
   for (auto& mod_button : modulation_buttons_) {
-    modulation_source_readouts_[mod_button.first] = parent->getSynth()->getStatusOutput(mod_button.first);
-    smooth_mod_values_[mod_button.first] = 0.0f;
-    active_mod_values_[mod_button.first] = false;
+    const vital::StatusOutput* readout = parent->getSynth()->getStatusOutput(mod_button.first);
+    source_readouts_.push_back({ mod_button.second, readout, 0.0f, false });
   }
 
   num_voices_readout_ = parent->getSynth()->getStatusOutput("num_voices");
@@ -1050,7 +1049,11 @@ void ModulationManager::drawDraggingModulation(OpenGlWrapper& open_gl) {
   if (current_source_ == nullptr || temporarily_set_destination_ || temporarily_set_hover_slider_)
     return;
 
-  vital::poly_float mod_percent = modulation_source_readouts_[current_source_->getName().toStdString()]->value();
+  vital::poly_float mod_percent = 0.0f;
+  for (const SourceReadout& source_readout : source_readouts_) {
+    if (source_readout.button == current_source_)
+      mod_percent = source_readout.readout->value();
+  }
   float draw_radius = kRadiusWidthRatio * getWidth();
   float radius_x = draw_radius / getWidth();
   float radius_y = draw_radius / getHeight();
@@ -1124,14 +1127,14 @@ void ModulationManager::renderSourceMeters(OpenGlWrapper& open_gl, int index) {
   int i = 0;
   float width = getWidth();
   float height = getHeight();
-  for (auto& mod_readout : modulation_source_readouts_) {
-    ModulationButton* button = modulation_buttons_[mod_readout.first];
-    float readout_value = mod_readout.second->value()[index];
+  for (SourceReadout& source_readout : source_readouts_) {
+    ModulationButton* button = source_readout.button;
+    float readout_value = source_readout.readout->value()[index];
 
     float clamped_value = vital::utils::clamp(readout_value, 0.0f, 1.0f);
-    if (!active_mod_values_[mod_readout.first] && !mod_readout.second->isClearValue(readout_value))
-      smooth_mod_values_[mod_readout.first].set(index, clamped_value);
-    float smooth_value = smooth_mod_values_[mod_readout.first][index];
+    if (!source_readout.active && !source_readout.readout->isClearValue(readout_value))
+      source_readout.smooth_value.set(index, clamped_value);
+    float smooth_value = source_readout.smooth_value[index];
 
     Rectangle<int> bounds = getLocalArea(button, button->getMeterBounds());
     float left = 2.0f * ((bounds.getX() - 1.0f) / width) - 1.0f + kModSourceMeterBuffer;
@@ -1145,7 +1148,7 @@ void ModulationManager::renderSourceMeters(OpenGlWrapper& open_gl, int index) {
     float bottom = std::max(y_center, smooth_y_center) + kModSourceMinRadius;
 
     bool active = button->isActiveModulation() || button->hasAnyModulation();
-    if (w <= 0.0f || mod_readout.second->isClearValue(readout_value) || !showingInParents(button) || !active) {
+    if (w <= 0.0f || source_readout.readout->isClearValue(readout_value) || !showingInParents(button) || !active) {
       left = -2.0f;
       top = -2.0f;
       bottom = -2.0f;
@@ -1168,14 +1171,12 @@ void ModulationManager::updateSmoothModValues() {
   float seconds = delta_milliseconds / 1000.0f;
   float decay = std::max(std::min(kModSmoothDecay * seconds * kTimeDecayScale, 1.0f), 0.0f);
 
-  for (auto& mod_readout : modulation_source_readouts_) {
-    vital::poly_float readout_value = mod_readout.second->value();
+  for (SourceReadout& source_readout : source_readouts_) {
+    vital::poly_float readout_value = source_readout.readout->value();
     vital::poly_float clamped_value = vital::utils::clamp(readout_value, 0.0f, 1.0f);
-    vital::poly_float smooth_value = smooth_mod_values_[mod_readout.first];
-    bool active = !mod_readout.second->isClearValue(readout_value);
-    active_mod_values_[mod_readout.first] = active;
-    if (active)
-      smooth_mod_values_[mod_readout.first] = vital::utils::interpolate(smooth_value, clamped_value, decay);
+    source_readout.active = !source_readout.readout->isClearValue(readout_value);
+    if (source_readout.active)
+      source_readout.smooth_value = vital::utils::interpolate(source_readout.smooth_value, clamped_value, decay);
   }
 }
 
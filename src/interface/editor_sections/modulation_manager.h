@@ -262,6 +262,13 @@ class ModulationManager : public SynthSection,
     void removeAuxSourceConnection(int from_index);
 
   private:
+    struct SourceReadout {
+      ModulationButton* button;
+      const vital::StatusOutput* readout;
+      vital::poly_float smooth_value;
+      bool active;
+    };
+
     void setDestinationQuadBounds(ModulationDestination* destination);
     void makeCurrentModulatorAmountsVisible();
     void makeModulationsVisible(SynthSlider* destination, bool visible);
@@ -303,9 +310,7 @@ class ModulationManager : public SynthSection,
     ModulationButton* current_modulator_;
     std::map<std::string, ModulationButton*> modulation_buttons_;
     std::map<std::string, std::unique_ptr<ExpandModulationButton>> modulation_callout_buttons_;
-    std::map<std::string, const vital::StatusOutput*> modulation_source_readouts_;
-    std::map<std::string, vital::poly_float> smooth_mod_values_;
-    std::map<std::string, bool> active_mod_values_;
+    std::vector<SourceReadout> source_readouts_;
     const vital::StatusOutput* num_voices_readout_;
     long long last_milliseconds_;
     std::unique_ptr<BarRenderer> modulation_source_meters_;
@@ -17,6 +17,7 @@
 #include "preset_browser.h"
 
 #include "skin.h"
+#include "binary_preset.h"
 #include "fonts.h"
 #include "load_save.h"
 #include "paths.h"
@@ -34,6 +35,13 @@ namespace {
     file_array.sort(comparator, true);
   }
 
+  PresetIndex& loadedPresetIndex() {
+    PresetIndex& index = PresetIndex::instance();
+    if (!index.hasScanned())
+      index.load(LoadSave::getPresetIndexFile());
+    return index;
+  }
+
   template<class Comparator>
   void sortFileArrayWithCache(Array<File>& file_array, PresetInfoCache* cache) {
     Comparator comparator(cache);
@@ -52,8 +60,25 @@ namespace {
   };
 }
 
+void PresetList::IndexThread::run() {
+  PresetIndex& index = PresetIndex::instance();
+  while (!threadShouldExit()) {
+    if (index.update(LoadSave::getPresetDirectories(), [this] { return threadShouldExit(); }))
+      index.save(LoadSave::getPresetIndexFile());
+
+    ref_->triggerAsyncUpdate();
+    wait(-1);
+  }
+}
+
+void PresetList::getAllPresets(Array<File>& presets) {
+  if (!loadedPresetIndex().getPresets(File(), presets))
+    LoadSave::getAllPresets(presets);
+}
+
 PresetList::PresetList() : SynthSection("Preset List"),
-    num_view_presets_(0), hover_preset_(-1), click_preset_(-1), cache_position_(0),
+    num_view_presets_(0), hover_preset_(-1), click_preset_(-1), index_thread_(this), listing_folder_(false),
+    cache_position_(0),
     highlight_(Shaders::kColorFragment), hover_(Shaders::kColorFragment),
     view_position_(0), sort_column_(kName), sort_ascending_(true) {
   addAndMakeVisible(browse_area_);
@@ -83,6 +108,11 @@ PresetList::PresetList() : SynthSection("Preset List"),
   favorites_ = LoadSave::getFavorites();
 }
 
+PresetList::~PresetList() {
+  index_thread_.stopThread(kIndexThreadStopMs);
+  cancelPendingUpdate();
+}
+
 void PresetList::paintBackground(Graphics& g) {
   int title_width = getTitleWidth();
   g.setColour(findColour(Skin::kWidgetBackground, true));
@@ -171,6 +201,8 @@ void PresetList::sort() {
 
 void PresetList::setPresets(Array<File> presets) {
   presets_ = presets;
+  listing_folder_ = false;
+  preset_info_cache_.setEntries(loadedPresetIndex().entries());
   sort();
   redoCache();
 }
@@ -349,21 +381,57 @@ void PresetList::finishRename() {
   File parent = renaming_preset_.getParentDirectory();
   File new_file = parent.getChildFile(text + renaming_preset_.getFileExtension());
   renaming_preset_.moveFileTo(new_file);
+  PresetIndex::instance().invalidate(new_file);
   renaming_preset_ = File();
 
   reloadPresets();
 }
 
 void PresetList::reloadPresets() {
-  presets_.clear();
-  if (current_folder_.exists() && current_folder_.isDirectory())
-    current_folder_.findChildFiles(presets_, File::findFiles, true, "*." + vital::kPresetExtension);
+  listPresets();
+  sort();
+  redoCache();
+  refreshIndex();
+}
+
+void PresetList::handleAsyncUpdate() {
+  std::shared_ptr<const PresetIndex::EntryMap> entries = PresetIndex::instance().entries();
+  if (entries == preset_info_cache_.getEntries())
+    return;
+
+  if (listing_folder_)
+    listPresets();
   else
-    LoadSave::getAllPresets(presets_);
+    preset_info_cache_.setEntries(entries);
   sort();
   redoCache();
 }
 
+void PresetList::listPresets() {
+  PresetIndex& index = loadedPresetIndex();
+  preset_info_cache_.setEntries(index.entries());
+  listing_folder_ = true;
+
+  File folder;
+  if (current_folder_.exists() && current_folder_.isDirectory())
+    folder = current_folder_;
+  if (index.getPresets(folder, presets_))
+    return;
+
+  presets_.clear();
+  if (folder.exists())
+    folder.findChildFiles(presets_, File::findFiles, true, "*." + vital::kPresetExtension);
+  else
+    LoadSave::getAllPresets(presets_);
+}
+
+void PresetList::refreshIndex() {
+  if (index_thread_.isThreadRunning())
+    index_thread_.notify();
+  else
+    index_thread_.startThread();
+}
+
 void PresetList::shiftSelectedPreset(int indices) {
   int num_presets = static_cast<int>(filtered_presets_.size());
   if (num_presets == 0)
@@ -399,7 +467,10 @@ void PresetList::filter(String filter_string, const std::set<std::string>& style
       if (styles.count(style) == 0)
         match = false;
     }
-    if (match && tokens.size()) {
+    const PresetIndex::Entry* entry = preset_info_cache_.getEntry(preset);
+    if (match && tokens.size() && entry)
+      match = entry->matches(tokens);
+    else if (match && tokens.size()) {
       String name = preset.getFileNameWithoutExtension().toLowerCase();
       String author = String(preset_info_cache_.getAuthor(preset)).toLowerCase();
 
@@ -654,9 +725,7 @@ PresetBrowser::PresetBrowser() : SynthSection("preset_browser") {
   comments_->setMultiLine(true, true);
 #endif
 
-  Array<File> presets;
-  LoadSave::getAllPresets(presets);
-  preset_list_->setPresets(presets);
+  preset_list_->reloadPresets();
 
   setWantsKeyboardFocus(true);
   setMouseClickGrabsKeyboardFocus(true);
@@ -883,10 +952,12 @@ void PresetBrowser::textEditorEscapeKeyPressed(TextEditor& editor) {
 }
 
 void PresetBrowser::save(File preset) {
+  PresetIndex::instance().invalidate(preset);
   loadPresets();
 }
 
 void PresetBrowser::fileDeleted(File saved_file) {
+  PresetIndex::instance().invalidate(saved_file);
   loadPresets();
 }
 
@@ -1026,7 +1097,9 @@ void PresetBrowser::loadPresetInfo() {
 void PresetBrowser::setPresetInfo(File& preset) {
   if (preset.exists()) {
     try {
-      json parsed_json_state = json::parse(preset.loadFileAsString().toStdString(), nullptr, false);
+      json parsed_json_state;
+      if (!BinaryPreset::readState(preset, parsed_json_state))
+        parsed_json_state = json::parse(preset.loadFileAsString().toStdString(), nullptr, false);
       author_ = LoadSave::getAuthorFromFile(preset);
       license_ = LoadSave::getLicense(parsed_json_state);
     }
@@ -1055,14 +1128,12 @@ void PresetBrowser::newSelection(File selection) {
 }
 
 void PresetBrowser::allSelected() {
-  Array<File> presets;
-  LoadSave::getAllPresets(presets);
-  preset_list_->setPresets(presets);
+  preset_list_->setCurrentFolder(File());
 }
 
 void PresetBrowser::favoritesSelected() {
   Array<File> presets;
-  LoadSave::getAllPresets(presets);
+  PresetList::getAllPresets(presets);
 
   Array<File> favorites;
   std::set<std::string> favorite_lookup = LoadSave::getFavorites();
@@ -25,12 +25,30 @@
 #include "open_gl_multi_quad.h"
 #include "overlay.h"
 #include "popup_browser.h"
+#include "preset_index.h"
 #include "save_section.h"
 #include "synth_section.h"
 
 class PresetInfoCache {
   public:
+    void setEntries(std::shared_ptr<const PresetIndex::EntryMap> entries) { entries_ = std::move(entries); }
+    std::shared_ptr<const PresetIndex::EntryMap> getEntries() const { return entries_; }
+
+    const PresetIndex::Entry* getEntry(const File& preset) {
+      if (entries_ == nullptr)
+        return nullptr;
+
+      auto entry = entries_->find(preset.getFullPathName().toStdString());
+      if (entry == entries_->end())
+        return nullptr;
+      return &entry->second;
+    }
+
     std::string getAuthor(const File& preset) {
+      const PresetIndex::Entry* entry = getEntry(preset);
+      if (entry)
+        return entry->author;
+
       std::string path = preset.getFullPathName().toStdString();
       if (author_cache_.count(path) == 0)
         author_cache_[path] = LoadSave::getAuthorFromFile(preset).toStdString();
@@ -39,6 +57,10 @@ class PresetInfoCache {
     }
 
     std::string getStyle(const File& preset) {
+      const PresetIndex::Entry* entry = getEntry(preset);
+      if (entry)
+        return entry->style;
+
       std::string path = preset.getFullPathName().toStdString();
       if (style_cache_.count(path) == 0)
         style_cache_[path] = LoadSave::getStyleFromFile(preset).toLowerCase().toStdString();
@@ -47,11 +69,12 @@ class PresetInfoCache {
     }
 
   private:
+    std::shared_ptr<const PresetIndex::EntryMap> entries_;
     std::map<std::string, std::string> author_cache_;
     std::map<std::string, std::string> style_cache_;
 };
 
-class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::Listener {
+class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::Listener, AsyncUpdater {
   public:
     class Listener {
       public:
@@ -87,6 +110,18 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
     static constexpr float kAuthorWidthPercent = 0.25f;
     static constexpr float kDateWidthPercent = 0.18f;
     static constexpr float kScrollSensitivity = 200.0f;
+    static constexpr int kIndexThreadStopMs = 500;
+
+    class IndexThread : public Thread {
+      public:
+        IndexThread(PresetList* ref) : Thread("Vial Preset Index Thread"), ref_(ref) { }
+        virtual ~IndexThread() { }
+
+        void run() override;
+
+      private:
+        PresetList* ref_;
+    };
 
     class FileNameAscendingComparator {
       public:
@@ -215,7 +250,10 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
         }
     };
 
+    static void getAllPresets(Array<File>& presets);
+
     PresetList();
+    ~PresetList();
 
     void paintBackground(Graphics& g) override;
     void paintBackgroundShadow(Graphics& g) override { paintTabShadow(g); }
@@ -242,6 +280,7 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
 
     void finishRename();
     void reloadPresets();
+    void handleAsyncUpdate() override;
     void shiftSelectedPreset(int indices);
 
     void redoCache();
@@ -266,6 +305,8 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
       int view_height = getHeight() - getTitleWidth();
       return std::max(0, std::min<int>(num_view_presets_ * getRowHeight() - view_height, view_position_));
     }
+    void listPresets();
+    void refreshIndex();
     void loadBrowserCache(int start_index, int end_index);
     void moveQuadToRow(OpenGlQuad& quad, int row, float y_offset);
     void sort();
@@ -286,6 +327,8 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
     int click_preset_;
 
     PresetInfoCache preset_info_cache_;
+    IndexThread index_thread_;
+    bool listing_folder_;
 
     Component browse_area_;
     int cache_position_;
@@ -258,11 +258,20 @@ void SampleSection::reset() {
 
 void SampleSection::loadFile(const File& file) {
   static constexpr int kMaxFileSamples = 17640000;
+  static constexpr double kMinStreamSeconds = 30.0;
   preset_selector_->setText(file.getFileNameWithoutExtension());
   sample_->setLastBrowsedFile(file.getFullPathName().toStdString());
 
   std::unique_ptr<AudioFormatReader> format_reader(sample_viewer_->formatManager().createReaderFor(file));
 
+  bool stream = format_reader && LoadSave::shouldStreamLongSamples() &&
+                format_reader->lengthInSamples > kMinStreamSeconds * format_reader->sampleRate;
+  if (stream && LoadSave::loadSampleStream(sample_, file)) {
+    preset_selector_->setText(sample_viewer_->getName());
+    sample_viewer_->repaintAudio();
+    return;
+  }
+
   if (format_reader) {
     int num_samples = (int)std::min<long long>(format_reader->lengthInSamples, kMaxFileSamples);
     sample_buffer_.setSize(format_reader->numChannels, num_samples);
@@ -29,7 +29,6 @@ SynthEditor::SynthEditor(SynthPlugin& synth) :
 
   Authentication::create();
   gui_->reset();
-  gui_->setOscilloscopeMemory(synth.getOscilloscopeMemory());
   gui_->setAudioMemory(synth.getAudioMemory());
   gui_->animate(LoadSave::shouldAnimateWidgets());
 
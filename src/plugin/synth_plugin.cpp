@@ -23,6 +23,7 @@ SynthPlugin::SynthPlugin() {
   last_seconds_time_ = 0.0;
 
   int num_params = vital::Parameters::getNumParameters();
+  bridge_list_.assign(num_params, nullptr);
   for (int i = 0; i < num_params; ++i) {
     const vital::ValueDetails* details = vital::Parameters::getDetails(i);
     if (controls_.count(details->name) == 0)
@@ -31,6 +32,7 @@ SynthPlugin::SynthPlugin() {
     ValueBridge* bridge = new ValueBridge(details->name, controls_[details->name]);
     bridge->setListener(this);
     bridge_lookup_[details->name] = bridge;
+    bridge_list_[i] = bridge;
     addParameter(bridge);
   }
 
@@ -59,11 +61,13 @@ void SynthPlugin::endChangeGesture(const std::string& name) {
     bridge_lookup_[name]->endChangeGesture();
 }
 
-void SynthPlugin::setValueNotifyHost(const std::string& name, vital::mono_float value) {
-  if (bridge_lookup_.count(name)) {
-    vital::mono_float plugin_value = bridge_lookup_[name]->convertToPluginValue(value);
-    bridge_lookup_[name]->setValueNotifyHost(plugin_value);
-  }
+void SynthPlugin::setValueNotifyHost(int id, vital::mono_float value) {
+  if (id < 0 || id >= static_cast<int>(bridge_list_.size()))
+    return;
+
+  ValueBridge* bridge = bridge_list_[id];
+  if (bridge)
+    bridge->setValueNotifyHost(bridge->convertToPluginValue(value));
 }
 
 const CriticalSection& SynthPlugin::getCriticalSection() {
@@ -161,17 +165,7 @@ void SynthPlugin::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midi_messa
   if (total_samples)
     processKeyboardEvents(midi_messages, total_samples);
 
-  double sample_time = 1.0 / AudioProcessor::getSampleRate();
-  for (int sample_offset = 0; sample_offset < total_samples;) {
-    int num_samples = std::min<int>(total_samples - sample_offset, vital::kMaxBufferSize);
-
-    engine_->correctToTime(last_seconds_time_);
-    processMidi(midi_messages, sample_offset, sample_offset + num_samples);
-    processAudio(&buffer, num_channels, num_samples, sample_offset);
-
-    last_seconds_time_ += num_samples * sample_time;
-    sample_offset += num_samples;
-  }
+  processAudioAndMidi(&buffer, num_channels, total_samples, midi_messages, last_seconds_time_);
 }
 
 bool SynthPlugin::hasEditor() const {
@@ -182,8 +176,8 @@ AudioProcessorEditor* SynthPlugin::createEditor() {
   return new SynthEditor(*this);
 }
 
-void SynthPlugin::parameterChanged(std::string name, vital::mono_float value) {
-  valueChangedExternal(name, value);
+void SynthPlugin::parameterChanged(int id, vital::mono_float value) {
+  valueChangedExternal(id, value);
 }
 
 void SynthPlugin::getStateInformation(MemoryBlock& dest_data) {
@@ -200,19 +194,26 @@ void SynthPlugin::setStateInformation(const void* data, int size_in_bytes) {
   MemoryInputStream stream(data, size_in_bytes, false);
   String data_string = stream.readEntireStreamAsString();
 
-  pauseProcessing(true);
+  bool paused = false;
   try {
     json json_data = json::parse(data_string.toStdString());
-    LoadSave::jsonToState(this, save_info_, json_data);
+    if (stageState(json_data)) {
+      pauseProcessing(true);
+      paused = true;
+      loadStagedState(json_data);
 
-    if (json_data.count("tuning"))
-      getTuning()->jsonToState(json_data["tuning"]);
+      if (json_data.count("tuning"))
+        getTuning()->jsonToState(json_data["tuning"]);
+    }
   }
   catch (const json::exception& e) {
     std::string error = "There was an error open the preset. Preset file is corrupted.";
     AlertWindow::showNativeDialogBox("Error opening preset", error, false);
   }
-  pauseProcessing(false);
+
+  if (paused)
+    pauseProcessing(false);
+  clearStagedState();
 
   SynthGuiInterface* editor = getGuiInterface();
   if (editor)
@@ -33,7 +33,7 @@ class SynthPlugin : public SynthBase, public AudioProcessor, public ValueBridge:
     SynthGuiInterface* getGuiInterface() override;
     void beginChangeGesture(const std::string& name) override;
     void endChangeGesture(const std::string& name) override;
-    void setValueNotifyHost(const std::string& name, vital::mono_float value) override;
+    void setValueNotifyHost(int id, vital::mono_float value) override;
     const CriticalSection& getCriticalSection() override;
     void pauseProcessing(bool pause) override;
 
@@ -67,7 +67,7 @@ class SynthPlugin : public SynthBase, public AudioProcessor, public ValueBridge:
     void setStateInformation(const void* data, int size_in_bytes) override;
     AudioProcessorParameter* getBypassParameter() const override { return bypass_parameter_; }
 
-    void parameterChanged(std::string name, vital::mono_float value) override;
+    void parameterChanged(int id, vital::mono_float value) override;
 
   private:
     ValueBridge* bypass_parameter_;
@@ -76,6 +76,7 @@ class SynthPlugin : public SynthBase, public AudioProcessor, public ValueBridge:
     AudioPlayHead::CurrentPositionInfo position_info_;
 
     std::map<std::string, ValueBridge*> bridge_lookup_;
+    std::vector<ValueBridge*> bridge_list_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthPlugin)
 };
@@ -25,7 +25,7 @@ class ValueBridge : public AudioProcessorParameter {
     class Listener {
       public:
         virtual ~Listener() { }
-        virtual void parameterChanged(std::string name, vital::mono_float value) = 0;
+        virtual void parameterChanged(int id, vital::mono_float value) = 0;
     };
 
     ValueBridge() = delete;
@@ -47,7 +47,7 @@ class ValueBridge : public AudioProcessorParameter {
       if (listener_ && !source_changed_) {
         source_changed_ = true;
         vital::mono_float synth_value = convertToEngineValue(value);
-        listener_->parameterChanged(name_.toStdString(), synth_value);
+        listener_->parameterChanged(details_.id, synth_value);
         source_changed_ = false;
       }
     }
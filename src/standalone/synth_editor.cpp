@@ -60,7 +60,6 @@ SynthEditor::SynthEditor(bool use_gui) : SynthGuiInterface(this, use_gui) {
     setLookAndFeel(DefaultLookAndFeel::instance());
     addAndMakeVisible(gui_.get());
     gui_->reset();
-    gui_->setOscilloscopeMemory(getOscilloscopeMemory());
     gui_->setAudioMemory(getAudioMemory());
 
     Rectangle<int> total_bounds = Desktop::getInstance().getDisplays().getTotalBounds(true);
@@ -96,22 +95,13 @@ void SynthEditor::getNextAudioBlock(const AudioSourceChannelInfo& buffer) {
   ScopedLock lock(getCriticalSection());
 
   int num_samples = buffer.buffer->getNumSamples();
-  int synth_samples = std::min(num_samples, vital::kMaxBufferSize);
 
   processModulationChanges();
   MidiBuffer midi_messages;
   midi_manager_->removeNextBlockOfMessages(midi_messages, num_samples);
   processKeyboardEvents(midi_messages, num_samples);
 
-  double sample_time = 1.0 / getSampleRate();
-  for (int b = 0; b < num_samples; b += synth_samples) {
-    int current_samples = std::min<int>(synth_samples, num_samples - b);
-    engine_->correctToTime(current_time_);
-
-    processMidi(midi_messages, b, b + current_samples);
-    processAudio(buffer.buffer, vital::kNumChannels, current_samples, b);
-    current_time_ += current_samples * sample_time;
-  }
+  processAudioAndMidi(buffer.buffer, vital::kNumChannels, num_samples, midi_messages, current_time_);
 }
 
 void SynthEditor::releaseResources() {
@@ -92,17 +92,6 @@ namespace vital {
 
     createStatusOutput("random", random_->output());
     createStatusOutput("stereo", stereo_->output());
-
-    std::string modulation_source_prefix = "modulation_source_";
-    std::string modulation_amount_prefix = "modulation_amount_";
-    for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
-      ModulationConnectionProcessor* processor = modulation_bank_.atIndex(i)->modulation_processor.get();
-      std::string number = std::to_string(i + 1);
-      Output* source_output = processor->output(ModulationConnectionProcessor::kModulationSource);
-      Output* pre_scale_output = processor->output(ModulationConnectionProcessor::kModulationPreScale);
-      createStatusOutput(modulation_source_prefix + number, source_output);
-      createStatusOutput(modulation_amount_prefix + number, pre_scale_output);
-    }
   }
 
   void EffectsModulationHandler::prepareDestroy() {
@@ -249,21 +238,26 @@ namespace vital {
     note_retriggered_.clearTrigger();
 
     if (getNumActiveVoices() == 0) {
-      for (auto& status_source : data_->status_outputs)
-        status_source.second->clear();
+      for (StatusOutput* status_source : data_->status_output_list)
+        status_source->clear();
+      for (int i = 0; i < vital::kMaxModulationConnections; ++i)
+        modulation_bank_.atIndex(i)->modulation_processor->clearStatus();
     }
     else {
       poly_mask voice_mask = getCurrentVoiceMask();
       for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
         ModulationConnectionProcessor* processor = modulation_bank_.atIndex(i)->modulation_processor.get();
         if (processor->enabled()) {
+          processor->updateStatus(voice_mask);
           poly_float* buffer = processor->output()->buffer;
           poly_float masked_value = buffer[0] & voice_mask;
           buffer[0] = masked_value + utils::swapVoices(masked_value);
         }
+        else
+          processor->clearStatus();
       }
-      for (auto& status_source : data_->status_outputs)
-        status_source.second->update(voice_mask);
+      for (StatusOutput* status_source : data_->status_output_list)
+        status_source->update(voice_mask);
     }
   }
 
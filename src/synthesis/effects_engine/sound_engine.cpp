@@ -71,7 +71,7 @@ namespace vital {
     Value* mod_wheel = createBaseControl("mod_wheel");
     modulation_handler_->setModWheelControl(mod_wheel);
 
-    upsampler_ = new Upsampler();
+    upsampler_ = new Upsampler(kMaxOversampleStages);
     addIdleProcessor(upsampler_);
 
     Value* effect_chain_order = createBaseControl("effect_chain_order");
@@ -99,7 +99,7 @@ namespace vital {
     SynthModule* flanger = effect_chain_->getEffect(constants::kFlanger);
     createStatusOutput("flanger_delay_frequency", flanger->output(FlangerModule::kFrequencyOutput));
 
-    Decimator* decimator = new Decimator(3);
+    Decimator* decimator = new Decimator(kMaxOversampleStages);
     decimator->plug(effect_chain_);
     addProcessor(decimator);
 
@@ -140,6 +140,7 @@ namespace vital {
     Processor* destination = change.mono_destination;
     bool polyphonic = change.source->owner->isPolyphonic() && change.poly_destination;
     change.modulation_processor->setPolyphonicModulation(polyphonic);
+    swapVoiceCopies(change, polyphonic);
     if (polyphonic)
       destination = change.poly_destination;
 
@@ -161,6 +162,27 @@ namespace vital {
     modulation_processors_.push_back(change.modulation_processor);
   }
 
+  void SoundEngine::prepareVoiceCopies(const modulation_change& change) {
+    if (change.voice_copies == nullptr)
+      return;
+
+    if (change.disconnecting)
+      modulation_handler_->reserveVoiceCopies(change.voice_copies->processors);
+    else
+      modulation_handler_->createVoiceCopies(change.modulation_processor, change.voice_copies->processors);
+  }
+
+  void SoundEngine::swapVoiceCopies(const modulation_change& change, bool polyphonic) {
+    if (change.voice_copies == nullptr)
+      return;
+
+    for (std::unique_ptr<Processor>& copy : change.voice_copies->processors) {
+      if (copy)
+        static_cast<ModulationConnectionProcessor*>(copy.get())->setPolyphonicModulation(polyphonic);
+    }
+    modulation_handler_->swapVoiceCopies(change.modulation_processor, change.voice_copies->processors);
+  }
+
   int SoundEngine::getNumPressedNotes() {
     return modulation_handler_->getNumPressedNotes();
   }
@@ -171,6 +193,7 @@ namespace vital {
       destination = change.poly_destination;
 
     destination->unplug(change.modulation_processor);
+    swapVoiceCopies(change, false);
 
     if (change.mono_destination->connectedInputs() == 1 &&
         (change.poly_destination == nullptr || change.poly_destination->connectedInputs() == 0)) {
@@ -236,8 +259,8 @@ namespace vital {
     upsampler_->processWithInput(audio_in, num_samples);
     ProcessorRouter::process(num_samples);
 
-    for (auto& status_source : data_->status_outputs)
-      status_source.second->update();
+    for (StatusOutput* status_source : data_->status_output_list)
+      status_source->update();
   }
 
   void SoundEngine::correctToTime(double seconds) {
@@ -301,7 +324,7 @@ namespace vital {
     return getModulationSource(source)->owner->enabled();
   }
 
-  const StereoMemory* SoundEngine::getEqualizerMemory() {
+  AudioCapture* SoundEngine::getEqualizerMemory() {
     return effect_chain_->getEqualizerMemory();
   }
 
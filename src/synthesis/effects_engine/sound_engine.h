@@ -24,11 +24,11 @@
 class LineGenerator;
 
 namespace vital {
+  class AudioCapture;
   class PeakMeter;
   class ReorderableEffectChain;
   class EffectsModulationHandler;
   class Sample;
-  class StereoMemory;
   class SynthLfo;
   class Upsampler;
   class Value;
@@ -50,6 +50,9 @@ namespace vital {
       int getNumPressedNotes();
       void connectModulation(const modulation_change& change);
       void disconnectModulation(const modulation_change& change);
+
+      // Builds the voice copies _change_ hands to or takes from the voices. Call off the audio thread.
+      void prepareVoiceCopies(const modulation_change& change);
       int getNumActiveVoices();
       ModulationConnectionBank& getModulationBank();
       mono_float getLastActiveNote() const;
@@ -72,7 +75,7 @@ namespace vital {
       void enableModSource(const std::string& source);
       void disableModSource(const std::string& source);
       bool isModSourceEnabled(const std::string& source);
-      const StereoMemory* getEqualizerMemory();
+      AudioCapture* getEqualizerMemory();
 
       void setBpm(mono_float bpm);
       void setAftertouch(mono_float note, mono_float value, int sample, int channel);
@@ -98,6 +101,8 @@ namespace vital {
       void checkOversampling();
 
     private:
+      void swapVoiceCopies(const modulation_change& change, bool polyphonic);
+
       EffectsModulationHandler* modulation_handler_;
       Upsampler* upsampler_;
       ReorderableEffectChain* effect_chain_;
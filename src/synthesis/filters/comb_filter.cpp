@@ -89,9 +89,8 @@ namespace vital {
     }
   } // namespace
 
-  CombFilter::CombFilter(int size) : Processor(CombFilter::kNumInputs, 1) {
+  CombFilter::CombFilter(int size) : Processor(CombFilter::kNumInputs, 1), memory_size_(size) {
     feedback_style_ = kComb;
-    memory_ = std::make_unique<Memory>(size);
     feedback_ = 0.0f;
     max_period_ = Memory::kMinPeriod;
     scale_ = 0.0f;
@@ -106,7 +105,7 @@ namespace vital {
 
   CombFilter::CombFilter(const CombFilter& other) : Processor(other), SynthFilter(other) {
     this->feedback_style_ = other.feedback_style_;
-    this->memory_ = std::make_unique<Memory>(*other.memory_);
+    this->memory_size_ = other.memory_size_;
     this->feedback_ = 0.0f;
     this->max_period_ = Memory::kMinPeriod;
     this->filter_coefficient_ = 0.0f;
@@ -120,12 +119,14 @@ namespace vital {
   CombFilter::~CombFilter() { }
   
   void CombFilter::reset(poly_mask reset_mask) {
-    mono_float max_period = max_period_[0];
-    for (int i = 1; i < poly_float::kSize; ++i)
-      max_period = utils::max(max_period, max_period_[i]);
+    if (memory_) {
+      mono_float max_period = max_period_[0];
+      for (int i = 1; i < poly_float::kSize; ++i)
+        max_period = utils::max(max_period, max_period_[i]);
 
-    int clear_samples = std::min(memory_->getSize() - 1, ((int)max_period) + 1);
-    memory_->clearMemory(clear_samples, reset_mask);
+      int clear_samples = std::min(memory_->getSize() - 1, ((int)max_period) + 1);
+      memory_->clearMemory(clear_samples, reset_mask);
+    }
 
     scale_ = utils::maskLoad(scale_, 0.0f, reset_mask);
     low_gain_ = utils::maskLoad(low_gain_, 0.0f, reset_mask);
@@ -200,6 +201,8 @@ namespace vital {
 
   void CombFilter::process(int num_samples) {
     VITAL_ASSERT(inputMatchesBufferSize(kAudio));
+    if (memory_ == nullptr)
+      memory_ = std::make_unique<Memory>(memory_size_);
 
     filter_state_.loadSettings(this);
     FeedbackStyle style = getFeedbackStyle(filter_state_.style);
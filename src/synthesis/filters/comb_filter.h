@@ -73,6 +73,10 @@ namespace vital {
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
 
+      // Feedback memory is allocated on first use so unused comb models don't hold it.
+      bool hasMemory() const { return memory_ != nullptr; }
+      void releaseMemory() { memory_ = nullptr; }
+
       poly_float getDrive() { return scale_; }
       poly_float getResonance() { return feedback_; }
       poly_float getLowAmount() { return low_gain_; }
@@ -81,6 +85,7 @@ namespace vital {
       poly_float getFilter2MidiCutoff() { return filter2_midi_cutoff_; }
 
     protected:
+      int memory_size_;
       std::unique_ptr<Memory> memory_;
 
       FeedbackStyle feedback_style_;
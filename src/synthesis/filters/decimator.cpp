@@ -57,6 +57,7 @@ namespace vital {
 
       VITAL_ASSERT(num_stages <= max_stages_);
       VITAL_ASSERT(input_sample_rate == output_sample_rate);
+      num_stages = utils::imin(num_stages, max_stages_);
     }
 
     if (num_stages == 0) {
@@ -0,0 +1,82 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "iir_halfband_interpolator.h"
+
+namespace vital {
+  // Same allpass coefficients as IirHalfbandDecimator with the branches swapped, the transposed structure.
+  poly_float IirHalfbandInterpolator::kTaps9[kNumTaps9] = {
+    { 0.0413554705262319f, 0.167135116548925f },
+    { 0.3878932830211427f, 0.742130012538075f },
+  };
+
+  poly_float IirHalfbandInterpolator::kTaps25[kNumTaps25] = {
+    { 0.024388383731296f, 0.093022421467960f },
+    { 0.194029987625265f, 0.312318050871736f },
+    { 0.433855675727187f, 0.548379093159427f },
+    { 0.650124972769370f, 0.737198546150414f },
+    { 0.810418671775866f, 0.872234992057129f },
+    { 0.925979700943193f, 0.975497791832324f }
+  };
+
+  IirHalfbandInterpolator::IirHalfbandInterpolator() : Processor(kNumInputs, 1), sharp_cutoff_(false) {
+    reset(constants::kFullMask);
+  }
+
+  void IirHalfbandInterpolator::process(int num_samples) {
+    processWithInput(input(kAudio)->source->buffer, num_samples);
+  }
+
+  void IirHalfbandInterpolator::processWithInput(const poly_float* audio_in, int num_samples) {
+    VITAL_ASSERT(num_samples % 2 == 0);
+    interpolate(audio_in, output()->buffer, num_samples / 2);
+  }
+
+  void IirHalfbandInterpolator::interpolate(const poly_float* audio_in, poly_float* audio_out,
+                                            int num_input_samples) {
+    int num_taps = kNumTaps9;
+    const poly_float* taps = kTaps9;
+    if (sharp_cutoff_) {
+      num_taps = kNumTaps25;
+      taps = kTaps25;
+    }
+
+    for (int i = 0; i < num_input_samples; ++i) {
+      // Lanes are left even, left odd, right even, right odd.
+      poly_float result = utils::consolidateAudio(audio_in[i], audio_in[i]);
+      for (int tap_index = 0; tap_index < num_taps; ++tap_index) {
+        poly_float delta = result - out_memory_[tap_index];
+        poly_float new_result = utils::mulAdd(in_memory_[tap_index], taps[tap_index], delta);
+        in_memory_[tap_index] = result;
+        out_memory_[tap_index] = new_result;
+        result = new_result;
+      }
+
+      poly_float stereo_split = utils::swapInner(result);
+      poly_float odd = utils::swapVoices(stereo_split);
+      int audio_out_index = 2 * i;
+      audio_out[audio_out_index] = utils::compactFirstVoices(stereo_split, stereo_split);
+      audio_out[audio_out_index + 1] = utils::compactFirstVoices(odd, odd);
+    }
+  }
+
+  void IirHalfbandInterpolator::reset(poly_mask reset_mask) {
+    for (int i = 0; i < kNumTaps25; ++i) {
+      in_memory_[i] = 0.0f;
+      out_memory_[i] = 0.0f;
+    }
+  }
+} // namespace vital
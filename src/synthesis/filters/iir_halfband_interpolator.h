@@ -0,0 +1,58 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "processor.h"
+#include "synth_constants.h"
+
+namespace vital {
+
+  // Polyphase allpass halfband interpolator, the upsampling counterpart of IirHalfbandDecimator.
+  // Each branch runs at the input rate and produces every other output sample.
+  class IirHalfbandInterpolator : public Processor {
+    public:
+      static constexpr int kNumTaps9 = 2;
+      static constexpr int kNumTaps25 = 6;
+      static poly_float kTaps9[kNumTaps9];
+      static poly_float kTaps25[kNumTaps25];
+
+      enum {
+        kAudio,
+        kNumInputs
+      };
+
+      IirHalfbandInterpolator();
+      virtual ~IirHalfbandInterpolator() { }
+
+      virtual Processor* clone() const override { VITAL_ASSERT(false); return nullptr; }
+
+      virtual void process(int num_samples) override;
+      virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
+      void reset(poly_mask reset_mask) override;
+      force_inline void setSharpCutoff(bool sharp_cutoff) { sharp_cutoff_ = sharp_cutoff; }
+
+      // Writes 2 * num_input_samples samples into audio_out.
+      void interpolate(const poly_float* audio_in, poly_float* audio_out, int num_input_samples);
+
+    private:
+      bool sharp_cutoff_;
+      poly_float in_memory_[kNumTaps25];
+      poly_float out_memory_[kNumTaps25];
+
+      JUCE_LEAK_DETECTOR(IirHalfbandInterpolator)
+  };
+} // namespace vital
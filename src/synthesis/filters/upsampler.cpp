@@ -16,11 +16,26 @@
 
 #include "upsampler.h"
 
+#include "iir_halfband_interpolator.h"
+
 namespace vital {
-  Upsampler::Upsampler() : ProcessorRouter(kNumInputs, 1) { }
+  Upsampler::Upsampler(int max_stages) : ProcessorRouter(kNumInputs, 1), max_stages_(max_stages) {
+    num_stages_ = -1;
+    for (int i = 0; i < max_stages_; ++i) {
+      IirHalfbandInterpolator* stage = new IirHalfbandInterpolator();
+      stage->setOversampleAmount(1 << (i + 1));
+      addProcessor(stage);
+      stages_.push_back(stage);
+    }
+  }
 
   Upsampler::~Upsampler() { }
 
+  void Upsampler::reset(poly_mask reset_mask) {
+    for (int i = 0; i < max_stages_; ++i)
+      stages_[i]->reset(reset_mask);
+  }
+
   void Upsampler::process(int num_samples) {
     const poly_float* audio_in = input(kAudio)->source->buffer;
     processWithInput(audio_in, num_samples);
@@ -29,12 +44,37 @@ namespace vital {
   void Upsampler::processWithInput(const poly_float* audio_in, int num_samples) {
     poly_float* destination = output()->buffer;
 
-    int oversample_amount = getOversampleAmount();
+    int num_stages = 0;
+    while ((1 << num_stages) < getOversampleAmount())
+      num_stages++;
+    VITAL_ASSERT(num_stages <= max_stages_);
+    num_stages = utils::imin(num_stages, max_stages_);
 
-    for (int i = 0; i < num_samples; ++i) {
-      int offset = i * oversample_amount;
-      for (int s = 0; s < oversample_amount; ++s)
-        destination[offset + s] = audio_in[i];
+    if (num_stages == 0) {
+      utils::copyBuffer(destination, audio_in, num_samples);
+      return;
     }
+
+    if (num_stages != num_stages_) {
+      num_stages_ = num_stages;
+      for (int i = 0; i < max_stages_; ++i) {
+        stages_[i]->reset(constants::kFullMask);
+        stages_[i]->setSharpCutoff(i == 0);
+      }
+    }
+
+    const poly_float* stage_in = audio_in;
+    int stage_samples = num_samples;
+    for (int i = 0; i < num_stages; ++i) {
+      poly_float* stage_out = i == num_stages - 1 ? destination : stages_[i]->output()->buffer;
+      stages_[i]->interpolate(stage_in, stage_out, stage_samples);
+      stage_in = stage_out;
+      stage_samples *= 2;
+    }
+  }
+
+  void Upsampler::setOversampleAmount(int oversample) {
+    // Stages keep the rates they were built with, only the output gets resized.
+    Processor::setOversampleAmount(oversample);
   }
 } // namespace vital
@@ -21,6 +21,8 @@
 
 namespace vital {
 
+  class IirHalfbandInterpolator;
+
   class Upsampler : public ProcessorRouter {
     public:
       enum {
@@ -28,15 +30,23 @@ namespace vital {
         kNumInputs
       };
 
-      Upsampler();
+      Upsampler(int max_stages);
       virtual ~Upsampler();
 
+      void reset(poly_mask reset_mask) override;
+
       virtual Processor* clone() const override { VITAL_ASSERT(false); return nullptr; }
 
       virtual void process(int num_samples) override;
       virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
+      virtual void setOversampleAmount(int oversample) override;
 
     private:
+      int num_stages_;
+      int max_stages_;
+
+      std::vector<IirHalfbandInterpolator*> stages_;
+
       JUCE_LEAK_DETECTOR(Upsampler)
   };
 } // namespace vital
@@ -0,0 +1,137 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vital {
+
+  // Identifies asset content by two independent 64 bit hashes so collisions are not a practical concern.
+  class AssetKey {
+    public:
+      AssetKey() : first_(kFirstBasis), second_(kSecondBasis) { }
+
+      AssetKey& add(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+          first_ = (first_ ^ bytes[i]) * kFirstPrime;
+          second_ = (second_ + bytes[i] + 1) * kSecondPrime;
+          second_ ^= second_ >> 29;
+        }
+        return *this;
+      }
+
+      template<class T>
+      AssetKey& add(const T& value) { return add(&value, sizeof(T)); }
+
+      std::string toString() const {
+        char hex[33];
+        snprintf(hex, sizeof(hex), "%016llx%016llx",
+                 static_cast<unsigned long long>(first_), static_cast<unsigned long long>(second_));
+        return hex;
+      }
+
+      bool operator<(const AssetKey& other) const {
+        return first_ < other.first_ || (first_ == other.first_ && second_ < other.second_);
+      }
+
+    private:
+      static constexpr uint64_t kFirstBasis = 0xcbf29ce484222325ULL;
+      static constexpr uint64_t kFirstPrime = 0x100000001b3ULL;
+      static constexpr uint64_t kSecondBasis = 0x9e3779b97f4a7c15ULL;
+      static constexpr uint64_t kSecondPrime = 0xbf58476d1ce4e5b9ULL;
+
+      uint64_t first_;
+      uint64_t second_;
+  };
+
+  // Process wide cache of read only assets so every synth instance loading the same content shares one copy.
+  // Entries are held weakly and go away when the last instance using them lets go.
+  template<class T>
+  class AssetCache {
+    public:
+      static AssetCache& instance() {
+        static AssetCache cache;
+        return cache;
+      }
+
+      std::shared_ptr<T> find(const AssetKey& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto entry = entries_.find(key);
+        if (entry == entries_.end())
+          return nullptr;
+
+        std::shared_ptr<T> asset = entry->second.lock();
+        if (asset == nullptr)
+          entries_.erase(entry);
+        return asset;
+      }
+
+      // Returns the asset already cached under key, or caches and returns the one passed in.
+      std::shared_ptr<T> insert(const AssetKey& key, std::shared_ptr<T> asset) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto entry = entries_.begin(); entry != entries_.end();) {
+          if (entry->second.expired())
+            entry = entries_.erase(entry);
+          else
+            ++entry;
+        }
+
+        std::weak_ptr<T>& entry = entries_[key];
+        std::shared_ptr<T> existing = entry.lock();
+        if (existing)
+          return existing;
+
+        entry = asset;
+        return asset;
+      }
+
+      // Snapshot of the live entries so work over every asset can run without holding the cache lock.
+      std::vector<std::shared_ptr<T>> entries() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::shared_ptr<T>> live;
+        for (auto& entry : entries_) {
+          std::shared_ptr<T> asset = entry.second.lock();
+          if (asset)
+            live.push_back(std::move(asset));
+        }
+        return live;
+      }
+
+      int size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int live = 0;
+        for (auto& entry : entries_)
+          live += entry.second.expired() ? 0 : 1;
+        return live;
+      }
+
+    private:
+      AssetCache() = default;
+
+      std::mutex mutex_;
+      std::map<AssetKey, std::weak_ptr<T>> entries_;
+  };
+} // namespace vital
@@ -0,0 +1,113 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace vital {
+
+  // Most recent audio for displays. The audio thread copies each block in with one bulk write and skips it
+  // entirely while no consumer is attached. Readers do their own analysis without locking, so a read that
+  // races a write can show part of a newer block, which only matters as a glitch on screen.
+  class AudioCapture {
+    public:
+      AudioCapture(int size) : position_(0), consumers_(0), trigger_position_(0), trigger_period_(0.0f) {
+        size_ = utils::nextPowerOfTwo(size);
+        bitmask_ = size_ - 1;
+        buffer_ = std::make_unique<poly_float[]>(size_);
+        for (int i = 0; i < size_; ++i)
+          buffer_[i] = 0.0f;
+      }
+
+      void addConsumer() { consumers_++; }
+      void removeConsumer() { consumers_--; }
+      force_inline bool active() const { return consumers_.load(std::memory_order_relaxed) > 0; }
+
+      void write(const poly_float* audio, int num_samples) {
+        uint64_t position = position_.load(std::memory_order_relaxed);
+        int skip = std::max(0, num_samples - size_);
+        int length = num_samples - skip;
+        int start = (position + skip) & bitmask_;
+        int first = std::min(length, size_ - start);
+        memcpy(buffer_.get() + start, audio + skip, first * sizeof(poly_float));
+        memcpy(buffer_.get(), audio + skip + first, (length - first) * sizeof(poly_float));
+        position_.store(position + num_samples, std::memory_order_release);
+      }
+
+      // Marks the current write position as the start of audio repeating every period samples.
+      void trigger(mono_float period) {
+        trigger_period_.store(period, std::memory_order_relaxed);
+        trigger_position_.store(position_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+
+      force_inline uint64_t position() const { return position_.load(std::memory_order_acquire); }
+
+      // Start of the latest complete window that begins a whole number of trigger periods after the trigger,
+      // so periodic audio lines up the same way on every read.
+      uint64_t alignedStart(int window_length) const {
+        uint64_t position = this->position();
+        uint64_t window = window_length;
+        uint64_t trigger_position = trigger_position_.load(std::memory_order_relaxed);
+        double period = trigger_period_.load(std::memory_order_relaxed);
+        if (position < window)
+          return 0;
+        if (period <= 0.0 || trigger_position > position - window)
+          return position - window;
+
+        while (period < window_length)
+          period += period;
+        period = std::min(period, 2.0 * window_length);
+
+        double passes = std::floor((position - window - trigger_position) / period);
+        return trigger_position + static_cast<uint64_t>(passes * period);
+      }
+
+      // Reads num_frames frames, stride apart, from the absolute position start onwards.
+      void readFrames(poly_float* output, int num_frames, uint64_t start, int stride = 1) const {
+        for (int i = 0; i < num_frames; ++i)
+          output[i] = buffer_[(start + i * stride) & bitmask_];
+      }
+
+      // Reads num_samples of a channel ending offset samples before the write position.
+      void readSamples(mono_float* output, int num_samples, int offset, int channel) const {
+        uint64_t start = position() - offset - num_samples;
+        for (int i = 0; i < num_samples; ++i)
+          output[i] = buffer_[(start + i) & bitmask_][channel];
+      }
+
+      int getSize() const { return size_; }
+
+    private:
+      std::unique_ptr<poly_float[]> buffer_;
+      int size_;
+      int bitmask_;
+      std::atomic<uint64_t> position_;
+      std::atomic<int> consumers_;
+      std::atomic<uint64_t> trigger_position_;
+      std::atomic<mono_float> trigger_period_;
+
+      JUCE_LEAK_DETECTOR(AudioCapture)
+  };
+} // namespace vital
@@ -28,6 +28,11 @@
 
 #define UNUSED(x) ((void)x)
 
+// Profiling. Build with VITAL_PROFILING=1 to time every Processor in the graph.
+#if !defined(VITAL_PROFILING)
+#define VITAL_PROFILING 0
+#endif
+
 #if !defined(force_inline)
 #if defined (_MSC_VER)
   #define force_inline __forceinline
@@ -44,11 +49,15 @@ namespace vital {
 
   typedef float mono_float;
 
+  // Number of 2x halfband stages it takes to reach an oversample amount.
+  constexpr int oversampleStages(int oversample) { return oversample > 1 ? 1 + oversampleStages(oversample / 2) : 0; }
+
   constexpr mono_float kPi = 3.1415926535897932384626433832795f;
   constexpr mono_float kSqrt2 = 1.414213562373095048801688724209698f;
   constexpr mono_float kEpsilon = 1e-16f;
   constexpr int kMaxBufferSize = 128;
   constexpr int kMaxOversample = 8;
+  constexpr int kMaxOversampleStages = oversampleStages(kMaxOversample);
   constexpr int kDefaultSampleRate = 44100;
   constexpr mono_float kMinNyquistMult = 0.45351473923f;
   constexpr int kMaxSampleRate = 192000;
@@ -0,0 +1,96 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+#include "json/json.h"
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+using json = nlohmann::json;
+
+namespace vital {
+
+  // Raw blocks of data that json state can refer to instead of carrying them as base64 text, so binary presets
+  // can hand audio to loaders straight out of a mapped file. Blocks are only reachable while registered.
+  class EmbeddedData {
+    public:
+      static const std::string& referenceKey() {
+        static const std::string key = "embedded_data";
+        return key;
+      }
+
+      static EmbeddedData& instance() {
+        static EmbeddedData embedded_data;
+        return embedded_data;
+      }
+
+      static json reference(int id) {
+        json data;
+        data[referenceKey()] = id;
+        return data;
+      }
+
+      // Points data at the bytes of a state field holding either base64 text or a reference to a registered
+      // block. Text is decoded into decoded, which has to outlive data.
+      static bool read(const json& value, MemoryOutputStream& decoded, const void*& data, size_t& size) {
+        if (value.is_string()) {
+          Base64::convertFromBase64(decoded, value.get_ref<const std::string&>());
+          data = decoded.getData();
+          size = decoded.getDataSize();
+          return true;
+        }
+
+        const std::string& key = referenceKey();
+        if (value.is_object() && value.count(key) && value[key].is_number_integer())
+          return instance().find(value[key], data, size);
+        return false;
+      }
+
+      int add(const void* data, size_t size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int id = next_id_++;
+        blocks_[id] = { data, size };
+        return id;
+      }
+
+      void remove(int id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        blocks_.erase(id);
+      }
+
+      bool find(int id, const void*& data, size_t& size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto block = blocks_.find(id);
+        if (block == blocks_.end())
+          return false;
+
+        data = block->second.first;
+        size = block->second.second;
+        return true;
+      }
+
+    private:
+      EmbeddedData() : next_id_(0) { }
+
+      std::mutex mutex_;
+      std::map<int, std::pair<const void*, size_t>> blocks_;
+      int next_id_;
+  };
+} // namespace vital
@@ -213,6 +213,103 @@ namespace vital {
     }
   }
   
+  namespace {
+    constexpr int kMaxBatchedModulations = 8;
+
+    force_inline poly_float remapModulation(const ModulationBlock& block, poly_float value) {
+      mono_float resolution = block.resolution;
+      poly_float boost = utils::clamp(value * resolution, 0.0f, resolution);
+      poly_int indices = utils::clamp(utils::toInt(boost), 0, resolution - 1);
+      poly_float t = boost - utils::toFloat(indices);
+
+      matrix interpolation_matrix = utils::getCatmullInterpolationMatrix(t);
+      matrix value_matrix = utils::getValueMatrix(block.map, indices);
+
+      value_matrix.transpose();
+      return utils::clamp(interpolation_matrix.multiplyAndSumRows(value_matrix), -1.0f, 1.0f);
+    }
+
+    force_inline poly_float morphModulation(const ModulationBlock& block, poly_float value,
+                                            poly_float amount, poly_float power) {
+      poly_float modulation_shift = value * block.pre_scale + block.offset;
+      poly_float modulation_abs = poly_float::abs(modulation_shift);
+      poly_mask sign_mask = poly_float::sign_mask(modulation_shift);
+
+      poly_float pre_modulation = amount * futils::powerScale(modulation_abs, power);
+      return (pre_modulation ^ sign_mask) * block.post_scale;
+    }
+
+    // A stride above one reads the last of every stride source samples, for a source running at a
+    // higher oversampling than the destination. Amounts step by stride so they stay on the source's ramp.
+    template<bool remap, bool morph>
+    void accumulateModulation(poly_float* dest, const ModulationBlock& block, int num_samples, int stride) {
+      const poly_float* source = block.source + (stride - 1);
+      poly_float current_amount = block.amount;
+      poly_float current_power = block.power;
+      poly_float delta_amount = block.delta_amount * stride;
+      poly_float delta_power = block.delta_power * stride;
+
+      for (int i = 0; i < num_samples; ++i) {
+        current_amount += delta_amount;
+        poly_float value = source[i * stride];
+        if (remap)
+          value = remapModulation(block, value);
+
+        if (morph) {
+          current_power += delta_power;
+          dest[i] += morphModulation(block, value, current_amount, current_power);
+        }
+        else
+          dest[i] += (value + block.offset) * current_amount;
+      }
+    }
+
+    // Evaluates a batch of linear connections in one pass over the destination buffer.
+    void accumulateLinearModulations(poly_float* dest, const ModulationBlock* const* blocks,
+                                     int num_blocks, int num_samples, int stride) {
+      const poly_float* sources[kMaxBatchedModulations];
+      poly_float amounts[kMaxBatchedModulations];
+      poly_float deltas[kMaxBatchedModulations];
+      poly_float offsets[kMaxBatchedModulations];
+
+      for (int b = 0; b < num_blocks; ++b) {
+        sources[b] = blocks[b]->source + (stride - 1);
+        amounts[b] = blocks[b]->amount;
+        deltas[b] = blocks[b]->delta_amount * stride;
+        offsets[b] = blocks[b]->offset;
+      }
+
+      for (int i = 0; i < num_samples; ++i) {
+        poly_float total = dest[i];
+        for (int b = 0; b < num_blocks; ++b) {
+          amounts[b] += deltas[b];
+          total += (sources[b][i * stride] + offsets[b]) * amounts[b];
+        }
+        dest[i] = total;
+      }
+    }
+  } // namespace
+
+  poly_float ModulationBlock::firstValue() const {
+    poly_float value = source[0];
+    if (remap)
+      value = remapModulation(*this, value);
+    if (morph)
+      return morphModulation(*this, value, amount + delta_amount, power + delta_power);
+    return (value + offset) * (amount + delta_amount);
+  }
+
+  void ModulationBlock::accumulate(poly_float* dest, int num_samples, int stride) const {
+    if (remap && morph)
+      accumulateModulation<true, true>(dest, *this, num_samples, stride);
+    else if (morph)
+      accumulateModulation<false, true>(dest, *this, num_samples, stride);
+    else if (remap)
+      accumulateModulation<true, false>(dest, *this, num_samples, stride);
+    else
+      accumulateModulation<false, false>(dest, *this, num_samples, stride);
+  }
+
   void ModulationSum::process(int num_samples) {
     VITAL_ASSERT(output()->buffer_size >= num_samples);
 
@@ -234,19 +331,41 @@ namespace vital {
       dest[s] = current_control_value;
     }
 
+    const ModulationBlock* linear_blocks[kMaxBatchedModulations];
+    int num_linear_blocks = 0;
+    int linear_stride = 1;
+
     for (int i = kNumStaticInputs; i < num_inputs; ++i) {
-      if (input(i)->source != &Processor::null_source_ && !input(i)->source->owner->isControlRate()) {
+      const Output* source = input(i)->source;
+      if (source == &Processor::null_source_ || source->owner->isControlRate())
+        continue;
+
+      // Voice modulation feeding an effect that runs below the voice oversampling is read at our rate.
+      int stride = utils::imax(1, source->owner->getOversampleAmount() / getOversampleAmount());
+      const ModulationBlock* block = source->owner->modulationBlock();
+      if (block == nullptr) {
         VITAL_ASSERT(inputMatchesBufferSize(i));
 
-        const poly_float* source = input(i)->source->buffer;
-
-        for (int s = 0; s < num_samples; ++s) {
-          poly_float value = source[s];
-          dest[s] += value;
+        const poly_float* buffer = source->buffer + (stride - 1);
+        for (int s = 0; s < num_samples; ++s)
+          dest[s] += buffer[s * stride];
+      }
+      else if (block->remap || block->morph)
+        block->accumulate(dest, num_samples, stride);
+      else {
+        if (num_linear_blocks && (num_linear_blocks == kMaxBatchedModulations || stride != linear_stride)) {
+          accumulateLinearModulations(dest, linear_blocks, num_linear_blocks, num_samples, linear_stride);
+          num_linear_blocks = 0;
         }
+
+        linear_blocks[num_linear_blocks++] = block;
+        linear_stride = stride;
       }
     }
 
+    if (num_linear_blocks)
+      accumulateLinearModulations(dest, linear_blocks, num_linear_blocks, num_samples, linear_stride);
+
     output()->trigger_value = dest[0];
   }
 
@@ -342,4 +461,57 @@ namespace vital {
     poly_float result = utils::maskLoad(tempo_adjusted, input(kFrequency)->at(0), frequency_mask);
     output()->buffer[0] = utils::maskLoad(result, keytrack_frequency, keytrack_mask);
   }
+
+  namespace cr {
+    force_inline poly_float computeOperator(Operator::FusedType type, const Operator* op) {
+      switch (type) {
+        case Operator::kVariableAdd:
+          return static_cast<const VariableAdd*>(op)->compute();
+        case Operator::kAdd:
+          return static_cast<const Add*>(op)->compute();
+        case Operator::kMultiply:
+          return static_cast<const Multiply*>(op)->compute();
+        case Operator::kClamp:
+          return static_cast<const Clamp*>(op)->compute();
+        case Operator::kLowerBound:
+          return static_cast<const LowerBound*>(op)->compute();
+        case Operator::kUpperBound:
+          return static_cast<const UpperBound*>(op)->compute();
+        case Operator::kInterpolate:
+          return static_cast<const Interpolate*>(op)->compute();
+        case Operator::kBilinearInterpolate:
+          return static_cast<const BilinearInterpolate*>(op)->compute();
+        case Operator::kSquare:
+          return static_cast<const Square*>(op)->compute();
+        case Operator::kCube:
+          return static_cast<const Cube*>(op)->compute();
+        case Operator::kQuart:
+          return static_cast<const Quart*>(op)->compute();
+        case Operator::kQuadratic:
+          return static_cast<const Quadratic*>(op)->compute();
+        case Operator::kCubic:
+          return static_cast<const Cubic*>(op)->compute();
+        case Operator::kQuartic:
+          return static_cast<const Quartic*>(op)->compute();
+        case Operator::kRoot:
+          return static_cast<const Root*>(op)->compute();
+        case Operator::kExponentialScale:
+          return static_cast<const ExponentialScale*>(op)->compute();
+        case Operator::kMagnitudeScale:
+          return static_cast<const MagnitudeScale*>(op)->compute();
+        case Operator::kMidiScale:
+          return static_cast<const MidiScale*>(op)->compute();
+        default:
+          VITAL_ASSERT(false);
+          return 0.0f;
+      }
+    }
+
+    void FusedChain::process(int num_samples) {
+      for (const FusedOperator& fused : operators_) {
+        if (fused.op->enabled())
+          fused.op->output()->buffer[0] = computeOperator(fused.type, fused.op);
+      }
+    }
+  } // namespace cr
 } // namespace vital
@@ -56,6 +56,31 @@ namespace vital {
 
       virtual bool hasState() const override { return false; }
 
+      // Control-rate operators that cr::FusedChain can evaluate without a virtual call.
+      enum FusedType {
+        kNotFusable,
+        kVariableAdd,
+        kAdd,
+        kMultiply,
+        kClamp,
+        kLowerBound,
+        kUpperBound,
+        kInterpolate,
+        kBilinearInterpolate,
+        kSquare,
+        kCube,
+        kQuart,
+        kQuadratic,
+        kCubic,
+        kQuartic,
+        kRoot,
+        kExponentialScale,
+        kMagnitudeScale,
+        kMidiScale
+      };
+
+      virtual FusedType getFusedType() const { return kNotFusable; }
+
     private:
       Operator() : Processor(0, 0), externally_enabled_(false) { }
       bool externally_enabled_;
@@ -154,6 +179,26 @@ namespace vital {
       JUCE_LEAK_DETECTOR(VariableAdd)
   };
 
+  // Per block parameters of one audio rate modulation connection. Linear blocks compute
+  // (source + offset) * amount, morphed blocks scale the shifted source by a power curve.
+  struct ModulationBlock {
+    const poly_float* source;
+    poly_float amount;
+    poly_float delta_amount;
+    poly_float power;
+    poly_float delta_power;
+    poly_float offset;
+    poly_float pre_scale;
+    poly_float post_scale;
+    const mono_float* map;
+    mono_float resolution;
+    bool remap;
+    bool morph;
+
+    poly_float firstValue() const;
+    void accumulate(poly_float* dest, int num_samples, int stride = 1) const;
+  };
+
   class ModulationSum : public Operator {
     public:
       enum {
@@ -398,8 +443,14 @@ namespace vital {
 
         virtual Processor* clone() const override { return new Clamp(*this); }
 
+        FusedType getFusedType() const override { return kClamp; }
+
+        force_inline poly_float compute() const {
+          return utils::clamp(input()->at(0), min_, max_);
+        }
+
         void process(int num_samples) override {
-          output()->buffer[0] = utils::clamp(input()->at(0), min_, max_);
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -413,8 +464,14 @@ namespace vital {
 
         virtual Processor* clone() const override { return new LowerBound(*this); }
 
+        FusedType getFusedType() const override { return kLowerBound; }
+
+        force_inline poly_float compute() const {
+          return utils::max(input()->at(0), min_);
+        }
+
         void process(int num_samples) override {
-          output()->buffer[0] = utils::max(input()->at(0), min_);
+          output()->buffer[0] = compute();
         }
         
       private:
@@ -429,8 +486,14 @@ namespace vital {
 
         virtual Processor* clone() const override { return new UpperBound(*this); }
 
+        FusedType getFusedType() const override { return kUpperBound; }
+
+        force_inline poly_float compute() const {
+          return utils::min(input()->at(0), max_);
+        }
+
         void process(int num_samples) override {
-          output()->buffer[0] = utils::min(input()->at(0), max_);
+          output()->buffer[0] = compute();
         }
         
       private:
@@ -446,8 +509,14 @@ namespace vital {
 
         virtual Processor* clone() const override { return new Add(*this); }
 
+        FusedType getFusedType() const override { return kAdd; }
+
+        force_inline poly_float compute() const {
+          return input(0)->at(0) + input(1)->at(0);
+        }
+
         void process(int num_samples) override {
-          output()->buffer[0] = input(0)->at(0) + input(1)->at(0);
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -463,8 +532,14 @@ namespace vital {
 
         virtual Processor* clone() const override { return new Multiply(*this); }
 
+        FusedType getFusedType() const override { return kMultiply; }
+
+        force_inline poly_float compute() const {
+          return input(0)->at(0) * input(1)->at(0);
+        }
+
         void process(int num_samples) override {
-          output()->buffer[0] = input(0)->at(0) * input(1)->at(0);
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -486,11 +561,17 @@ namespace vital {
           return new Interpolate(*this);
         }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kInterpolate; }
+
+        force_inline poly_float compute() const {
           poly_float from = input(kFrom)->at(0);
           poly_float to = input(kTo)->at(0);
           poly_float fraction = input(kFractional)->at(0);
-          output()->buffer[0] = utils::interpolate(from, to, fraction);
+          return utils::interpolate(from, to, fraction);
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -502,9 +583,15 @@ namespace vital {
         Square() : Operator(1, 1, true) { }
         virtual Processor* clone() const override { return new Square(*this); }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kSquare; }
+
+        force_inline poly_float compute() const {
           poly_float value = utils::max(input()->at(0), 0.0f);
-          output()->buffer[0] = value * value;
+          return value * value;
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -516,9 +603,15 @@ namespace vital {
         Cube() : Operator(1, 1, true) { }
         virtual Processor* clone() const override { return new Cube(*this); }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kCube; }
+
+        force_inline poly_float compute() const {
           poly_float value = utils::max(input()->at(0), 0.0f);
-          output()->buffer[0] = value * value * value;
+          return value * value * value;
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -530,10 +623,16 @@ namespace vital {
         Quart() : Operator(1, 1, true) { }
         virtual Processor* clone() const override { return new Quart(*this); }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kQuart; }
+
+        force_inline poly_float compute() const {
           poly_float value = utils::max(input()->at(0), 0.0f);
           value *= value;
-          output()->buffer[0] = value * value;
+          return value * value;
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -545,9 +644,15 @@ namespace vital {
         Quadratic(mono_float offset) : Operator(1, 1, true), offset_(offset) { }
         virtual Processor* clone() const override { return new Quadratic(*this); }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kQuadratic; }
+
+        force_inline poly_float compute() const {
           poly_float value = utils::max(input()->at(0), 0.0f);
-          output()->buffer[0] = value * value + offset_;
+          return value * value + offset_;
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -561,9 +666,15 @@ namespace vital {
         Cubic(mono_float offset) : Operator(1, 1, true), offset_(offset) { }
         virtual Processor* clone() const override { return new Cubic(*this); }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kCubic; }
+
+        force_inline poly_float compute() const {
           poly_float value = utils::max(input()->at(0), 0.0f);
-          output()->buffer[0] = value * value * value + offset_;
+          return value * value * value + offset_;
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -577,10 +688,16 @@ namespace vital {
         Quartic(mono_float offset) : Operator(1, 1, true), offset_(offset) { }
         virtual Processor* clone() const override { return new Quartic(*this); }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kQuartic; }
+
+        force_inline poly_float compute() const {
           poly_float value = utils::max(input()->at(0), 0.0f);
           value *= value;
-          output()->buffer[0] = value * value + offset_;
+          return value * value + offset_;
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -594,9 +711,15 @@ namespace vital {
         Root(mono_float offset) : Operator(1, 1, true), offset_(offset) { }
         virtual Processor* clone() const override { return new Root(*this); }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kRoot; }
+
+        force_inline poly_float compute() const {
           poly_float value = utils::max(input()->at(0), 0.0f);
-          output()->buffer[0] = utils::sqrt(value) + offset_;
+          return utils::sqrt(value) + offset_;
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
         
       private:
@@ -614,8 +737,14 @@ namespace vital {
           return new ExponentialScale(*this);
         }
 
+        FusedType getFusedType() const override { return kExponentialScale; }
+
+        force_inline poly_float compute() const {
+          return futils::pow(scale_, utils::clamp(input()->at(0), min_, max_));
+        }
+
         void process(int num_samples) override {
-          output()->buffer[0] = futils::pow(scale_, utils::clamp(input()->at(0), min_, max_));
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -636,14 +765,20 @@ namespace vital {
           return new VariableAdd(*this);
         }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kVariableAdd; }
+
+        force_inline poly_float compute() const {
           int num_inputs = static_cast<int>(inputs_->size());
           poly_float value = 0.0;
 
           for (int in = 0; in < num_inputs; ++in)
             value += input(in)->at(0);
 
-          output()->buffer[0] = value;
+          return value;
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -706,8 +841,14 @@ namespace vital {
           return new MagnitudeScale(*this);
         }
 
+        FusedType getFusedType() const override { return kMagnitudeScale; }
+
+        force_inline poly_float compute() const {
+          return futils::dbToMagnitude(input()->at(0));
+        }
+
         void process(int num_samples) override {
-          output()->buffer[0] = futils::dbToMagnitude(input()->at(0));
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -722,8 +863,14 @@ namespace vital {
           return new MidiScale(*this);
         }
 
+        FusedType getFusedType() const override { return kMidiScale; }
+
+        force_inline poly_float compute() const {
+          return utils::midiCentsToFrequency(input()->at(0));
+        }
+
         void process(int num_samples) override {
-          output()->buffer[0] = utils::midiCentsToFrequency(input()->at(0));
+          output()->buffer[0] = compute();
         }
 
       private:
@@ -750,19 +897,54 @@ namespace vital {
           return new BilinearInterpolate(*this);
         }
 
-        void process(int num_samples) override {
+        FusedType getFusedType() const override { return kBilinearInterpolate; }
+
+        force_inline poly_float compute() const {
           poly_float top = utils::interpolate(input(kTopLeft)->at(0),
                                               input(kTopRight)->at(0),
                                               input(kXPosition)->at(0));
           poly_float bottom = utils::interpolate(input(kBottomLeft)->at(0),
                                                  input(kBottomRight)->at(0),
                                                  input(kXPosition)->at(0));
-          output()->buffer[0] = utils::interpolate(top, bottom, input(kYPosition)->at(0));
+          return utils::interpolate(top, bottom, input(kYPosition)->at(0));
+        }
+
+        void process(int num_samples) override {
+          output()->buffer[0] = compute();
         }
 
       private:
         JUCE_LEAK_DETECTOR(BilinearInterpolate)
     };
+
+    // Stands in for a run of consecutive control-rate operators where each feeds the next. Every
+    // operator's output is still written so other readers of the intermediate values are unaffected.
+    class FusedChain : public Processor {
+      public:
+        FusedChain() : Processor(0, 1, true) { }
+
+        virtual Processor* clone() const override { return new FusedChain(*this); }
+        virtual bool hasState() const override { return false; }
+
+        void addOperator(Operator* op) {
+          operators_.push_back({ op->getFusedType(), op });
+          useOutput(op->output());
+        }
+
+        int numOperators() const { return static_cast<int>(operators_.size()); }
+
+        void process(int num_samples) override;
+
+      private:
+        struct FusedOperator {
+          Operator::FusedType type;
+          Operator* op;
+        };
+
+        std::vector<FusedOperator> operators_;
+
+        JUCE_LEAK_DETECTOR(FusedChain)
+    };
   } // namespace cr
 } // namespace vital
 
@@ -215,17 +215,25 @@ namespace vital {
     }
 
     force_inline poly_float maskLoad(poly_float zero_value, poly_float one_value, poly_mask reset_mask) {
+    #if VITAL_SSE4_1
+      return _mm_blendv_ps(zero_value.value, one_value.value, _mm_castsi128_ps(reset_mask.value));
+    #else
       poly_float old_values = zero_value & ~reset_mask;
       poly_float new_values = one_value & reset_mask;
 
       return old_values + new_values;
+    #endif
     }
 
     force_inline poly_int maskLoad(poly_int zero_value, poly_int one_value, poly_mask reset_mask) {
+    #if VITAL_SSE4_1
+      return _mm_blendv_epi8(zero_value.value, one_value.value, reset_mask.value);
+    #else
       poly_int old_values = zero_value & ~reset_mask;
       poly_int new_values = one_value & reset_mask;
 
       return old_values | new_values;
+    #endif
     }
 
     force_inline poly_float modOnce(poly_float value) {
@@ -517,8 +525,12 @@ namespace vital {
     }
 
     force_inline poly_float floor(poly_float value) {
+    #if VITAL_SSE4_1
+      return _mm_floor_ps(value.value);
+    #else
       poly_float truncated = trunc(value);
       return truncated + (poly_float(-1.0f) & poly_float::greaterThan(truncated, value));
+    #endif
     }
 
     force_inline poly_int floorToInt(poly_float value) {
@@ -530,8 +542,12 @@ namespace vital {
     }
 
     force_inline poly_float ceil(poly_float value) {
+    #if VITAL_SSE4_1
+      return _mm_ceil_ps(value.value);
+    #else
       poly_float truncated = trunc(value);
       return truncated + (poly_float(1.0f) & poly_float::lessThan(truncated, value));
+    #endif
     }
 
     force_inline poly_float round(poly_float value) {
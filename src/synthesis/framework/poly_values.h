@@ -31,6 +31,10 @@
   static_assert(false, "No SIMD Intrinsics found which are necessary for compilation");
 #endif
 
+#if VITAL_SSE2 && (defined(__SSE4_1__) || defined(__AVX__))
+  #define VITAL_SSE4_1 1
+#endif
+
 #if VITAL_SSE2
   #include <immintrin.h>
 #elif VITAL_NEON
@@ -128,11 +132,15 @@ namespace vital {
 #if VITAL_AVX2
       return _mm256_mul_epi32(one, two);
 #elif VITAL_SSE2
+  #if VITAL_SSE4_1
+      return _mm_mullo_epi32(one, two);
+  #else
       simd_type mul0_2 = _mm_mul_epu32(one, two);
       simd_type mul1_3 = _mm_mul_epu32(_mm_shuffle_epi32(one, _MM_SHUFFLE(2, 3, 0, 1)),
                                        _mm_shuffle_epi32(two, _MM_SHUFFLE(2, 3, 0, 1)));
       return _mm_unpacklo_epi32(_mm_shuffle_epi32(mul0_2, _MM_SHUFFLE (0, 0, 2, 0)),
                                 _mm_shuffle_epi32(mul1_3, _MM_SHUFFLE (0, 0, 2, 0)));
+  #endif
 #elif VITAL_NEON
       return vmulq_u32(one, two);
 #endif
@@ -176,8 +184,12 @@ namespace vital {
 #if VITAL_AVX2
       return _mm256_max_epi32(one, two);
 #elif VITAL_SSE2
+  #if VITAL_SSE4_1
+      return _mm_max_epu32(one, two);
+  #else
       simd_type greater_than_mask = greaterThan(one, two);
       return _mm_or_si128(_mm_and_si128(greater_than_mask, one), _mm_andnot_si128(greater_than_mask, two));
+  #endif
 #elif VITAL_NEON
       return vmaxq_u32(one, two);
 #endif
@@ -187,8 +199,12 @@ namespace vital {
 #if VITAL_AVX2
       return _mm256_min_epi32(one, two);
 #elif VITAL_SSE2
+  #if VITAL_SSE4_1
+      return _mm_min_epi32(one, two);
+  #else
       simd_type less_than_mask = _mm_cmpgt_epi32(two, one);
       return _mm_or_si128(_mm_and_si128(less_than_mask, one), _mm_andnot_si128(less_than_mask, two));
+  #endif
 #elif VITAL_NEON
       return vminq_u32(one, two);
 #endif
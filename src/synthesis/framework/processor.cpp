@@ -40,6 +40,15 @@ namespace vital {
       addOutput(max_oversample);
   }
 
+  void Processor::enable(bool enable) {
+    if (state_->enabled == enable)
+      return;
+
+    state_->enabled = enable;
+    if (router_)
+      router_->enabledChanged();
+  }
+
   bool Processor::inputMatchesBufferSize(int input) {
     if (input >= inputs_->size())
       return false;
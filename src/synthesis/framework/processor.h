@@ -22,10 +22,20 @@
 #include <cstring>
 #include <vector>
 
+#if VITAL_PROFILING
+#include <atomic>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
 namespace vital {
 
   class Processor;
   class ProcessorRouter;
+  struct ModulationBlock;
 
   struct Output {
     Output(int size = kMaxBufferSize, int max_oversample = 1) {
@@ -103,6 +113,10 @@ namespace vital {
       control_rate = false;
       enabled = true;
       initialized = false;
+#if VITAL_PROFILING
+      profile_ticks = 0;
+      profile_calls = 0;
+#endif
     }
 
     int sample_rate;
@@ -110,8 +124,24 @@ namespace vital {
     bool control_rate;
     bool enabled;
     bool initialized;
+
+#if VITAL_PROFILING
+    // Shared by every voice clone of a processor, so voices accumulate together.
+    std::atomic<long long> profile_ticks;
+    std::atomic<long long> profile_calls;
+#endif
   };
 
+#if VITAL_PROFILING
+  force_inline long long getProfileTicks() {
+  #if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+  #else
+    return Time::getHighResolutionTicks();
+  #endif
+  }
+#endif
+
   namespace cr {
     struct Output : public ::vital::Output {
       Output() {
@@ -137,6 +167,12 @@ namespace vital {
       // Does the processor require any data per voice.
       virtual bool hasState() const { return true; }
 
+      // Does the processor create harmonics that would alias without oversampling.
+      virtual bool needsOversampling() const { return false; }
+
+      // Audio rate modulation that the destination evaluates in place instead of reading our output buffer.
+      virtual const ModulationBlock* modulationBlock() const { return nullptr; }
+
       // Override this for main processing code.
       virtual void process(int num_samples) = 0;
       virtual void processWithInput(const poly_float* audio_in, int num_samples) { VITAL_ASSERT(false); }
@@ -176,9 +212,7 @@ namespace vital {
         return state_->enabled;
       }
 
-      virtual void enable(bool enable) {
-        state_->enabled = enable;
-      }
+      virtual void enable(bool enable);
 
       force_inline int getSampleRate() const {
         return state_->sample_rate;
@@ -299,6 +333,15 @@ namespace vital {
 
       void setPluggingStart(int start) { plugging_start_ = start; }
 
+#if VITAL_PROFILING
+      force_inline void addProfileTicks(long long ticks) {
+        state_->profile_ticks.fetch_add(ticks, std::memory_order_relaxed);
+        state_->profile_calls.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      std::shared_ptr<ProcessorState> getProfileState() const { return state_; }
+#endif
+
     protected:
       Output* addOutput(int oversample = 1);
       Input* addInput();
@@ -17,39 +17,82 @@
 #include "processor_router.h"
 
 #include "feedback.h"
-#include "synth_constants.h"
+#include "operators.h"
 
 #include <algorithm>
 #include <vector>
 
+#if VITAL_PROFILING
+#include <cstdlib>
+#include <typeinfo>
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+#endif
+
 namespace vital {
 
+  namespace {
+    constexpr int kDefaultOrderCapacity = 64;
+
+    bool isFusable(const Processor* processor) {
+      const Operator* op = dynamic_cast<const Operator*>(processor);
+      return op && op->isControlRate() && op->getFusedType() != Operator::kNotFusable;
+    }
+
+    bool feeds(const Processor* source, const Processor* destination) {
+      for (int i = 0; i < destination->numInputs(); ++i) {
+        if (destination->input(i)->source == source->output())
+          return true;
+      }
+      return false;
+    }
+
+    int indexOf(CircularQueue<Processor*>& queue, const Processor* processor) {
+      for (int i = 0; i < queue.size(); ++i) {
+        if (queue[i] == processor)
+          return i;
+      }
+      return -1;
+    }
+  } // namespace
+
   ProcessorRouter::ProcessorRouter(int num_inputs, int num_outputs, bool control_rate) :
       Processor(num_inputs, num_outputs, control_rate),
-      global_order_(new CircularQueue<Processor*>(kMaxModulationConnections)),
-      global_reorder_(new CircularQueue<Processor*>(kMaxModulationConnections)),
-      local_order_(kMaxModulationConnections),
+      global_order_(new CircularQueue<Processor*>(kDefaultOrderCapacity)),
+      global_reorder_(new CircularQueue<Processor*>(kDefaultOrderCapacity)),
+      local_order_(kDefaultOrderCapacity), active_order_(kDefaultOrderCapacity),
       global_feedback_order_(new std::vector<const Feedback*>()),
       global_changes_(new int(0)), local_changes_(0),
-      dependencies_(new CircularQueue<const Processor*>(kMaxModulationConnections)),
-      dependencies_visited_(new CircularQueue<const Processor*>(kMaxModulationConnections)),
-      dependency_inputs_(new CircularQueue<const Processor*>(kMaxModulationConnections)) { }
+      global_enables_(new int(0)), active_enables_(-1), active_changes_(-1),
+      dependencies_(new CircularQueue<const Processor*>(kDefaultOrderCapacity)),
+      dependencies_visited_(new CircularQueue<const Processor*>(kDefaultOrderCapacity)),
+      dependency_inputs_(new CircularQueue<const Processor*>(kDefaultOrderCapacity)) { }
 
   ProcessorRouter::ProcessorRouter(const ProcessorRouter& original) :
       Processor(original), global_order_(original.global_order_), global_reorder_(original.global_reorder_),
       global_feedback_order_(original.global_feedback_order_),
       global_changes_(original.global_changes_),
-      local_changes_(original.local_changes_) {
+      local_changes_(original.local_changes_),
+      global_enables_(original.global_enables_), active_enables_(-1), active_changes_(-1) {
     local_order_.reserve(global_order_->capacity());
+    active_order_.reserve(global_order_->capacity());
     local_order_.assign(global_order_->size(), 0);
     local_feedback_order_.assign(global_feedback_order_->size(), nullptr);
 
     int num_processors = global_order_->size();
     for (int i = 0; i < num_processors; ++i) {
-      const Processor* next = global_order_->at(i);
-      std::unique_ptr<Processor> clone(next->clone());
-      local_order_[i] = clone.get();
-      processors_[next] = { 0, std::move(clone) };
+      Processor* next = global_order_->at(i);
+      if (next->hasState()) {
+        std::unique_ptr<Processor> clone(next->clone());
+        local_order_[i] = clone.get();
+        processors_[next] = { 0, std::move(clone) };
+      }
+      else {
+        // Keep an empty entry so swapLocalProcessor can hand this voice a copy later without allocating.
+        local_order_[i] = next;
+        processors_[next] = { 0, nullptr };
+      }
     }
 
     int num_feedbacks = static_cast<int>(global_feedback_order_->size());
@@ -72,14 +115,23 @@ namespace vital {
     for (int i = 0; i < num_feedbacks; ++i)
       local_feedback_order_[i]->refreshOutput(num_samples);
 
+    if (active_enables_ != *global_enables_ || active_changes_ != *global_changes_)
+      updateActiveProcessors();
+
     // Run all the main processors.
     int normal_samples = std::max(1, num_samples / getOversampleAmount());
-    for (Processor* processor : local_order_) {
+    for (Processor* processor : active_order_) {
       if (processor->enabled()) {
         int processor_samples = normal_samples * processor->getOversampleAmount();
 
         VITAL_ASSERT(processor->checkInputAndOutputSize(processor_samples));
+#if VITAL_PROFILING
+        long long start = getProfileTicks();
+        processor->process(processor_samples);
+        processor->addProfileTicks(getProfileTicks() - start);
+#else
         processor->process(processor_samples);
+#endif
         VITAL_ASSERT(utils::isFinite(processor->output()->buffer, processor->isControlRate() ? 0 : processor_samples));
       }
     }
@@ -134,6 +186,7 @@ namespace vital {
     global_order_->ensureSpace();
     global_reorder_->ensureCapacity(global_order_->capacity());
     local_order_.ensureSpace();
+    reserveActiveOrder();
     addProcessorRealTime(processor);
   }
 
@@ -159,6 +212,22 @@ namespace vital {
     idle_processors_[processor] = std::unique_ptr<Processor>(processor);
   }
 
+  void ProcessorRouter::swapLocalProcessor(const Processor* global_processor,
+                                           std::unique_ptr<Processor>& local_processor) {
+    auto found = processors_.find(global_processor);
+    if (found == processors_.end())
+      return;
+
+    std::unique_ptr<Processor>& current = found->second.second;
+    current.swap(local_processor);
+
+    // If we're behind the global order the next update rebuilds local_order_ from processors_ anyway.
+    int index = indexOf(*global_order_, global_processor);
+    if (index >= 0 && !shouldUpdate())
+      local_order_[index] = current ? current.get() : global_order_->at(index);
+    active_changes_ = -1;
+  }
+
   void ProcessorRouter::removeProcessor(Processor* processor) {
     for (int i = 0; i < processor->numInputs(); ++i)
       disconnect(processor, processor->input(i)->source);
@@ -245,7 +314,12 @@ namespace vital {
 
   bool ProcessorRouter::isDownstream(const Processor* first, const Processor* second) const {
     getDependencies(second);
-    return dependencies_->contains(first);
+    const Processor* first_context = getContext(first);
+
+    // Members of one fused chain share it as their context so the walk over members decides.
+    if (first_context && first_context == getContext(second) && fused_processors_.count(first))
+      return dependencies_visited_->contains(first);
+    return dependencies_->contains(first_context);
   }
 
   bool ProcessorRouter::areOrdered(const Processor* first, const Processor* second) const {
@@ -273,6 +347,122 @@ namespace vital {
     return false;
   }
 
+#if VITAL_PROFILING
+  void ProcessorRouter::collectProfile(std::vector<ProfileNode>& nodes, const std::string& path,
+                                       const std::string& module, int depth) const {
+    nodes.push_back({ path, module, depth, state_ });
+
+    // Processors a module runs itself sit in the idle list and count towards the module's own time.
+    std::vector<const Processor*> children;
+    for (const Processor* processor : *global_order_)
+      children.push_back(processor);
+    for (auto& idle_processor : idle_processors_)
+      children.push_back(idle_processor.first);
+
+    std::vector<std::string> names;
+    std::map<std::string, int> name_counts;
+    for (const Processor* child : children) {
+      names.push_back(getProfileName(child));
+      name_counts[names.back()]++;
+    }
+
+    std::map<std::string, int> name_indices;
+    for (size_t i = 0; i < children.size(); ++i) {
+      std::string child_path = path + "/" + names[i];
+      if (name_counts[names[i]] > 1)
+        child_path += "[" + std::to_string(name_indices[names[i]]++) + "]";
+
+      const ProcessorRouter* router = dynamic_cast<const ProcessorRouter*>(children[i]);
+      if (router)
+        router->collectProfile(nodes, child_path, module, depth + 1);
+      else
+        nodes.push_back({ child_path, module, depth + 1, children[i]->getProfileState() });
+    }
+  }
+
+  std::string ProcessorRouter::getProfileName(const Processor* processor) {
+    std::string name = typeid(*processor).name();
+  #if defined(__GNUC__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    if (status == 0 && demangled)
+      name = demangled;
+    free(demangled);
+  #endif
+
+    for (const std::string prefix : { "class ", "struct ", "vital::" }) {
+      size_t position = 0;
+      while ((position = name.find(prefix)) != std::string::npos)
+        name.erase(position, prefix.size());
+    }
+    return name;
+  }
+#endif
+
+  void ProcessorRouter::fuseOperatorChains() {
+    for (int start = 0; start < global_order_->size(); ++start) {
+      if (!isFusable(global_order_->at(start)))
+        continue;
+
+      // Members must also be adjacent in our own processing order so nothing reads a stale value.
+      int end = start + 1;
+      while (end < global_order_->size()) {
+        Processor* previous = global_order_->at(end - 1);
+        Processor* next = global_order_->at(end);
+        int local_index = indexOf(local_order_, previous);
+        if (!isFusable(next) || !feeds(previous, next) || local_index < 0 ||
+            local_index + 1 >= local_order_.size() || local_order_[local_index + 1] != next) {
+          break;
+        }
+        end++;
+      }
+
+      if (end - start > 1)
+        fuseProcessors(start, end);
+    }
+
+    for (Processor* processor : *global_order_) {
+      ProcessorRouter* router = dynamic_cast<ProcessorRouter*>(processor);
+      if (router)
+        router->fuseOperatorChains();
+    }
+
+    for (auto& idle_processor : idle_processors_) {
+      ProcessorRouter* router = dynamic_cast<ProcessorRouter*>(idle_processor.second.get());
+      if (router)
+        router->fuseOperatorChains();
+    }
+  }
+
+  void ProcessorRouter::fuseProcessors(int start, int end) {
+    cr::FusedChain* chain = new cr::FusedChain();
+    chain->router(this);
+    if (getOversampleAmount() > 1)
+      chain->setOversampleAmount(getOversampleAmount());
+
+    std::vector<Processor*> members;
+    for (int i = start; i < end; ++i)
+      members.push_back(global_order_->at(i));
+
+    // The operators stay alive so their inputs can still be plugged and switched on and off.
+    for (Processor* member : members) {
+      chain->addOperator(static_cast<Operator*>(member));
+      fused_processors_[member] = { chain, std::move(processors_[member].second) };
+      processors_.erase(member);
+    }
+
+    local_order_[indexOf(local_order_, members[0])] = chain;
+    global_order_->at(start) = chain;
+    for (size_t i = 1; i < members.size(); ++i) {
+      global_order_->remove(members[i]);
+      local_order_.remove(members[i]);
+    }
+
+    processors_[chain] = { 0, std::unique_ptr<Processor>(chain) };
+    (*global_changes_)++;
+    local_changes_++;
+  }
+
   ProcessorRouter* ProcessorRouter::getMonoRouter() {
     if (isPolyphonic(this))
       return router_->getMonoRouter();
@@ -320,9 +510,27 @@ namespace vital {
     local_changes_ = *global_changes_;
   }
 
+  void ProcessorRouter::reserveActiveOrder() {
+    if (active_order_.capacity() < local_order_.capacity())
+      active_order_.reserve(local_order_.capacity());
+  }
+
+  void ProcessorRouter::updateActiveProcessors() {
+    VITAL_ASSERT(active_order_.capacity() >= local_order_.size());
+    active_order_.clear();
+    for (Processor* processor : local_order_) {
+      if (processor->enabled())
+        active_order_.push_back(processor);
+    }
+
+    active_enables_ = *global_enables_;
+    active_changes_ = *global_changes_;
+  }
+
   void ProcessorRouter::createAddedProcessors() {
     if (global_order_->size() > local_order_.capacity())
       local_order_.reserve(global_order_->capacity());
+    reserveActiveOrder();
    
     local_order_.assign(global_order_->size(), nullptr);
     local_feedback_order_.assign(global_feedback_order_->size(), nullptr);
@@ -331,9 +539,10 @@ namespace vital {
     for (int i = 0; i < num_processors; ++i) {
       Processor* next = global_order_->at(i);
       if (next->hasState()) {
-        if (processors_.count(next) == 0)
-          processors_[next] = { 0, std::unique_ptr<Processor>(next->clone()) };
-        local_order_[i] = processors_[next].second.get();
+        std::unique_ptr<Processor>& local = processors_[next].second;
+        if (local == nullptr)
+          local.reset(next->clone());
+        local_order_[i] = local.get();
       }
       else
         local_order_[i] = next;
@@ -381,6 +590,9 @@ namespace vital {
     const Processor* context = processor;
     while (context && processors_.find(context) == processors_.end() &&
            idle_processors_.find(context) == idle_processors_.end()) {
+      auto fused = fused_processors_.find(context);
+      if (fused != fused_processors_.end())
+        return fused->second.first;
       context = context->router();
     }
 
@@ -21,12 +21,32 @@
 
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace vital {
 
   class Feedback;
 
+  // Time spent in a processor and its children across all voices, in profiler ticks.
+  struct ProcessorProfile {
+    std::string path;
+    std::string module;
+    int depth;
+    long long calls;
+    long long ticks;
+    long long self_ticks;
+  };
+
+#if VITAL_PROFILING
+  struct ProfileNode {
+    std::string path;
+    std::string module;
+    int depth;
+    std::shared_ptr<ProcessorState> state;
+  };
+#endif
+
   class ProcessorRouter : public Processor {
     public:
       ProcessorRouter(int num_inputs = 0, int num_outputs = 0, bool control_rate = false);
@@ -48,6 +68,10 @@ namespace vital {
       virtual void addIdleProcessor(Processor* processor);
       virtual void removeProcessor(Processor* processor);
 
+      // Trades our copy of _global_processor_ with _local_processor_ without allocating. With no copy we
+      // run _global_processor_ itself, which is how voices share processors that have no state.
+      void swapLocalProcessor(const Processor* global_processor, std::unique_ptr<Processor>& local_processor);
+
       // Any time new dependencies are added into the ProcessorRouter graph, we
       // should call _connect_ on the destination Processor and source Output.
       void connect(Processor* destination, const Output* source, int index);
@@ -57,10 +81,24 @@ namespace vital {
 
       virtual bool isPolyphonic(const Processor* processor) const;
 
+      // Called when a child is switched on or off so every voice rebuilds its list of enabled processors.
+      force_inline void enabledChanged() { (*global_enables_)++; }
+
       virtual ProcessorRouter* getMonoRouter();
       virtual ProcessorRouter* getPolyRouter();
       virtual void resetFeedbacks(poly_mask reset_mask);
 
+      // Replaces runs of consecutive control-rate operators that feed each other with a single
+      // cr::FusedChain in this router and all routers below it. Call once the graph is built.
+      virtual void fuseOperatorChains();
+
+#if VITAL_PROFILING
+      // Appends this router and everything under it to _nodes_ in depth first order.
+      virtual void collectProfile(std::vector<ProfileNode>& nodes, const std::string& path,
+                                  const std::string& module, int depth) const;
+      static std::string getProfileName(const Processor* processor);
+#endif
+
     protected:
       // When we create a cycle into the ProcessorRouter graph, we must insert
       // a Feedback node and add it here.
@@ -74,6 +112,12 @@ namespace vital {
       // Ensures our local copies of all processors and feedback processors match the master order.
       virtual void updateAllProcessors();
 
+      // Collects the enabled processors of _local_order_ so disabled ones cost nothing per block.
+      void updateActiveProcessors();
+
+      // Grows _active_order_ with _local_order_ so updateActiveProcessors never allocates.
+      void reserveActiveOrder();
+
       force_inline bool shouldUpdate() { return local_changes_ != *global_changes_; }
 
       // Will create local copies of added processors. 
@@ -90,11 +134,15 @@ namespace vital {
       // Returns the processor for this voice from the globally created one.
       Processor* getLocalProcessor(const Processor* global_processor);
 
+      void fuseProcessors(int start, int end);
+
       std::shared_ptr<CircularQueue<Processor*>> global_order_;
       std::shared_ptr<CircularQueue<Processor*>> global_reorder_;
       CircularQueue<Processor*> local_order_;
+      CircularQueue<Processor*> active_order_;
       std::map<const Processor*, std::pair<int, std::unique_ptr<Processor>>> processors_;
       std::map<const Processor*, std::unique_ptr<Processor>> idle_processors_;
+      std::map<const Processor*, std::pair<Processor*, std::unique_ptr<Processor>>> fused_processors_;
 
       std::shared_ptr<std::vector<const Feedback*>> global_feedback_order_;
       std::vector<Feedback*> local_feedback_order_;
@@ -102,6 +150,9 @@ namespace vital {
 
       std::shared_ptr<int> global_changes_;
       int local_changes_;
+      std::shared_ptr<int> global_enables_;
+      int active_enables_;
+      int active_changes_;
 
       std::shared_ptr<CircularQueue<const Processor*>> dependencies_;
       std::shared_ptr<CircularQueue<const Processor*>> dependencies_visited_;
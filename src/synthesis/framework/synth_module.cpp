@@ -286,7 +286,10 @@ namespace vital {
   }
 
   void SynthModule::createStatusOutput(std::string name, Output* source) {
-    data_->status_outputs[name] = std::make_unique<StatusOutput>(source);
+    VITAL_ASSERT(data_->status_outputs.count(name) == 0);
+    std::unique_ptr<StatusOutput> status_output = std::make_unique<StatusOutput>(source);
+    data_->status_output_list.push_back(status_output.get());
+    data_->status_outputs[name] = std::move(status_output);
   }
 
   control_map SynthModule::getControls() {
@@ -325,6 +328,12 @@ namespace vital {
     return nullptr;
   }
 
+  void SynthModule::collectStatusOutputs(std::vector<StatusOutput*>& status_outputs) const {
+    status_outputs.insert(status_outputs.end(), data_->status_output_list.begin(), data_->status_output_list.end());
+    for (SynthModule* sub_module : data_->sub_modules)
+      sub_module->collectStatusOutputs(status_outputs);
+  }
+
   Processor* SynthModule::getModulationDestination(std::string name, bool poly) {
     Processor* poly_destination = getPolyModulationDestination(name);
 
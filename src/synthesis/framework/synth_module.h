@@ -18,6 +18,7 @@
 
 #include "synth_types.h"
 #include "processor_router.h"
+#include "telemetry_bus.h"
 
 #include <climits>
 #include <vector>
@@ -30,28 +31,41 @@ namespace vital {
     public:
       static constexpr float kClearValue = INT_MIN;
 
-      StatusOutput(Output* source) : source_(source), value_(0.0f) { }
+      StatusOutput(Output* source) : source_(source), bus_(nullptr), index_(-1),
+                                     value_(&local_value_), local_value_(0.0f) { }
 
-      force_inline poly_float value() const { return value_; }
+      // Values are then written into the bus and read back from its last published block.
+      void attach(TelemetryBus* bus, int index) {
+        bus_ = bus;
+        index_ = index;
+        value_ = bus->staging() + index;
+        *value_ = local_value_;
+      }
+
+      force_inline poly_float value() const { return bus_ ? bus_->read(index_) : *value_; }
+      force_inline int index() const { return index_; }
 
       force_inline void update(poly_mask voice_mask) {
         poly_float masked_value = source_->buffer[0] & voice_mask;
-        value_ = masked_value + utils::swapVoices(masked_value);
+        *value_ = masked_value + utils::swapVoices(masked_value);
       }
 
       force_inline void update() {
-        value_ = source_->buffer[0];
+        *value_ = source_->buffer[0];
       }
 
-      force_inline void clear() { value_ = kClearValue; }
+      force_inline void clear() { *value_ = kClearValue; }
       force_inline bool isClearValue(poly_float value) const { return poly_float::equal(value, kClearValue).anyMask(); }
       force_inline bool isClearValue(float value) const { return value == kClearValue; }
 
     private:
       Output* source_;
-      poly_float value_;
+      TelemetryBus* bus_;
+      int index_;
+      poly_float* value_;
+      poly_float local_value_;
 
-      JUCE_LEAK_DETECTOR(StatusOutput)
+      JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StatusOutput)
   };
 
   struct ModuleData {
@@ -61,6 +75,7 @@ namespace vital {
     control_map controls;
     output_map mod_sources;
     std::map<std::string, std::unique_ptr<StatusOutput>> status_outputs;
+    std::vector<StatusOutput*> status_output_list;
     input_map mono_mod_destinations;
     input_map poly_mod_destinations;
     output_map mono_modulation_readout;
@@ -79,11 +94,19 @@ namespace vital {
       }
       virtual ~SynthModule() { }
 
+#if VITAL_PROFILING
+      void collectProfile(std::vector<ProfileNode>& nodes, const std::string& path,
+                          const std::string& module, int depth) const override {
+        ProcessorRouter::collectProfile(nodes, path, getProfileName(this), depth);
+      }
+#endif
+
       // Returns a map of all controls of this module and all submodules.
       control_map getControls();
 
       Output* getModulationSource(std::string name);
       const StatusOutput* getStatusOutput(std::string name) const;
+      void collectStatusOutputs(std::vector<StatusOutput*>& status_outputs) const;
       Processor* getModulationDestination(std::string name, bool poly);
       Processor* getMonoModulationDestination(std::string name);
       Processor* getPolyModulationDestination(std::string name);
@@ -0,0 +1,84 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include <atomic>
+#include <memory>
+
+namespace vital {
+
+  // Dense, index addressed values written by the audio thread and published once per block.
+  // Publishing goes through a triple buffer so the reader always gets a complete block without ever blocking
+  // the writer. There is one reader which calls acquire() before reading a frame's worth of values.
+  class TelemetryBus {
+    public:
+      static constexpr int kNumBuffers = 3;
+
+      TelemetryBus(int num_values) : num_values_(num_values), back_(0), middle_(1), front_(2), published_(0) {
+        staging_ = std::make_unique<poly_float[]>(num_values);
+        for (int i = 0; i < kNumBuffers; ++i)
+          buffers_[i] = std::make_unique<poly_float[]>(num_values);
+      }
+
+      force_inline int numValues() const { return num_values_; }
+      force_inline poly_float* staging() { return staging_.get(); }
+
+      // Audio thread.
+      force_inline void publish() {
+        poly_float* back = buffers_[back_].get();
+        for (int i = 0; i < num_values_; ++i)
+          back[i] = staging_[i];
+
+        back_ = middle_.exchange(back_ | kFreshBit, std::memory_order_acq_rel) & kIndexMask;
+        published_.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      // Reader thread. Returns true if a newer block was published since the last call.
+      force_inline bool acquire() {
+        if ((middle_.load(std::memory_order_relaxed) & kFreshBit) == 0)
+          return false;
+
+        int front = front_.load(std::memory_order_relaxed);
+        front_.store(middle_.exchange(front, std::memory_order_acq_rel) & kIndexMask, std::memory_order_release);
+        return true;
+      }
+
+      force_inline poly_float read(int index) const {
+        VITAL_ASSERT(index >= 0 && index < num_values_);
+        return buffers_[front_.load(std::memory_order_acquire)][index];
+      }
+
+      force_inline unsigned int numPublished() const { return published_.load(std::memory_order_relaxed); }
+
+    private:
+      static constexpr int kFreshBit = 4;
+      static constexpr int kIndexMask = kFreshBit - 1;
+
+      int num_values_;
+      std::unique_ptr<poly_float[]> staging_;
+      std::unique_ptr<poly_float[]> buffers_[kNumBuffers];
+
+      int back_;
+      std::atomic<int> middle_;
+      std::atomic<int> front_;
+      std::atomic<unsigned int> published_;
+
+      JUCE_LEAK_DETECTOR(TelemetryBus)
+  };
+} // namespace vital
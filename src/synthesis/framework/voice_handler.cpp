@@ -310,6 +310,9 @@ namespace vital {
       active_aggregate_voices_.push_back(last_aggregate_voice);
     }
 
+    // Aggregate voices must render one at a time. Voice clones share their Input and Output objects,
+    // stateless operators aren't cloned at all and ValueSwitch aliases buffers, so every voice writes
+    // into the same buffers and accumulateOutputs reads them before the next voice overwrites them.
     for (AggregateVoice* aggregate_voice : active_aggregate_voices_) {
       prepareVoiceTriggers(aggregate_voice, num_samples);
       prepareVoiceValues(aggregate_voice);
@@ -779,6 +782,16 @@ namespace vital {
     polyphony_ = polyphony;
   }
 
+#if VITAL_PROFILING
+  void VoiceHandler::collectProfile(std::vector<ProfileNode>& nodes, const std::string& path,
+                                    const std::string& module, int depth) const {
+    std::string name = getProfileName(this);
+    nodes.push_back({ path, name, depth, state_ });
+    global_router_.collectProfile(nodes, path + "/global", name, depth + 1);
+    voice_router_.collectProfile(nodes, path + "/voice", name, depth + 1);
+  }
+#endif
+
   mono_float VoiceHandler::getLastActiveNote() const {
     if (active_voices_.size())
       return active_voices_.back()->state().tuned_note;
@@ -799,6 +812,27 @@ namespace vital {
     voice_router_.removeProcessor(processor);
   }
 
+  void VoiceHandler::createVoiceCopies(const Processor* processor,
+                                       std::vector<std::unique_ptr<Processor>>& copies) const {
+    reserveVoiceCopies(copies);
+    for (std::unique_ptr<Processor>& copy : copies)
+      copy.reset(processor->clone());
+  }
+
+  void VoiceHandler::reserveVoiceCopies(std::vector<std::unique_ptr<Processor>>& copies) const {
+    copies.clear();
+    copies.resize(all_aggregate_voices_.size());
+  }
+
+  void VoiceHandler::swapVoiceCopies(const Processor* processor, std::vector<std::unique_ptr<Processor>>& copies) {
+    // Voices added since the copies were built make their own copy on their next update.
+    int num_copies = std::min(static_cast<int>(copies.size()), all_aggregate_voices_.size());
+    for (int i = 0; i < num_copies; ++i) {
+      ProcessorRouter* voice_router = static_cast<ProcessorRouter*>(all_aggregate_voices_[i]->processor.get());
+      voice_router->swapLocalProcessor(processor, copies[i]);
+    }
+  }
+
   void VoiceHandler::addGlobalProcessor(Processor* processor) {
     global_router_.addProcessor(processor);
   }
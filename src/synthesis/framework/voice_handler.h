@@ -368,9 +368,26 @@ namespace vital {
       virtual ProcessorRouter* getMonoRouter() override { return &global_router_; }
       virtual ProcessorRouter* getPolyRouter() override { return &voice_router_; }
 
+      void fuseOperatorChains() override {
+        global_router_.fuseOperatorChains();
+        voice_router_.fuseOperatorChains();
+      }
+
+#if VITAL_PROFILING
+      void collectProfile(std::vector<ProfileNode>& nodes, const std::string& path,
+                          const std::string& module, int depth) const override;
+#endif
+
       void addProcessor(Processor* processor) override;
       void addIdleProcessor(Processor* processor) override;
       void removeProcessor(Processor* processor) override;
+
+      // Voices share _processor_ while it has no state. These build and trade their own copies so the
+      // audio thread never allocates: build on another thread, then swap under the processing lock.
+      void createVoiceCopies(const Processor* processor, std::vector<std::unique_ptr<Processor>>& copies) const;
+      void reserveVoiceCopies(std::vector<std::unique_ptr<Processor>>& copies) const;
+      void swapVoiceCopies(const Processor* processor, std::vector<std::unique_ptr<Processor>>& copies);
+
       void addGlobalProcessor(Processor* processor);
       void removeGlobalProcessor(Processor* processor);
       void resetFeedbacks(poly_mask reset_mask) override;
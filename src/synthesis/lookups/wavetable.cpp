@@ -25,7 +25,7 @@ namespace vital {
 
   Wavetable::Wavetable(int max_frames) :
       max_frames_(max_frames), current_data_(nullptr), 
-      active_audio_data_(nullptr), shepard_table_(false), fft_data_() {
+      active_audio_data_(nullptr), data_shared_(false), shepard_table_(false), fft_data_() {
     loadDefaultWavetable();
   }
 
@@ -41,19 +41,14 @@ namespace vital {
     if (data_ && num_frames == data_->num_frames)
       return;
 
-    int old_version = 0;
     int old_num_frames = 0;
-    if (data_) {
-      old_version = data_->version;
+    if (data_)
       old_num_frames = data_->num_frames;
-    }
 
-    std::unique_ptr<WavetableData> old_data = std::move(data_);
-    data_ = std::make_unique<WavetableData>(num_frames, old_version + 1);
-    data_->wave_data = std::make_unique<mono_float[][kWaveformSize]>(num_frames);
-    data_->frequency_amplitudes = std::make_unique<poly_float[][kPolyFrequencySize]>(num_frames);
-    data_->normalized_frequencies = std::make_unique<poly_float[][kPolyFrequencySize]>(num_frames);
-    data_->phases = std::make_unique<poly_float[][kPolyFrequencySize]>(num_frames);
+    std::shared_ptr<WavetableData> old_data = std::move(data_);
+    data_ = std::make_shared<WavetableData>(num_frames, nextVersion());
+    data_shared_ = false;
+    data_->allocate();
 
     int frame_size = kWaveformSize * sizeof(mono_float);
     int frequency_size = kPolyFrequencySize * sizeof(poly_float);
@@ -87,11 +82,67 @@ namespace vital {
       std::this_thread::yield(); // Wait for audio thread to finish using old_data.
   }
 
+  void Wavetable::swapData(Wavetable* other) {
+    VITAL_ASSERT(other->active_audio_data_.load() == nullptr);
+
+    data_.swap(other->data_);
+    current_data_ = data_.get();
+    other->current_data_ = other->data_.get();
+    std::swap(data_shared_, other->data_shared_);
+    std::swap(shepard_table_, other->shepard_table_);
+
+    while (active_audio_data_.load())
+      std::this_thread::yield(); // Wait for audio thread to finish using old data before handing it off.
+  }
+
+  void Wavetable::loadSharedData(std::shared_ptr<WavetableData> data) {
+    VITAL_ASSERT(data);
+    std::shared_ptr<WavetableData> old_data = std::move(data_);
+    data_ = std::move(data);
+    data_shared_ = true;
+
+    current_data_ = data_.get();
+    while (active_audio_data_.load())
+      std::this_thread::yield(); // Wait for audio thread to finish using old_data.
+  }
+
+  std::shared_ptr<Wavetable::WavetableData> Wavetable::shareData() {
+    data_shared_ = true;
+    return data_;
+  }
+
+  int Wavetable::nextVersion() {
+    // Versions are unique across tables so swapping in shared data always reads as a change.
+    static std::atomic<int> version(0);
+    return ++version;
+  }
+
+  void Wavetable::copyOnWrite() {
+    if (!data_shared_)
+      return;
+
+    int num_frames = data_->num_frames;
+    std::shared_ptr<WavetableData> old_data = std::move(data_);
+    data_ = std::make_shared<WavetableData>(num_frames, nextVersion());
+    data_->frequency_ratio = old_data->frequency_ratio;
+    data_->sample_rate = old_data->sample_rate;
+    data_->allocate();
+
+    memcpy(data_->frequency_amplitudes, old_data->frequency_amplitudes, data_->memorySize());
+    data_shared_ = false;
+
+    current_data_ = data_.get();
+    while (active_audio_data_.load())
+      std::this_thread::yield(); // Wait for audio thread to finish using old_data.
+  }
+
   void Wavetable::setFrequencyRatio(float frequency_ratio) {
+    copyOnWrite();
     current_data_->frequency_ratio = frequency_ratio;
   }
 
   void Wavetable::setSampleRate(float rate) {
+    copyOnWrite();
     current_data_->sample_rate = rate;
   }
 
@@ -103,6 +154,7 @@ namespace vital {
     if (to_index >= current_data_->num_frames)
       return;
 
+    copyOnWrite();
     loadFrequencyAmplitudes(wave_frame->frequency_domain, to_index);
     loadNormalizedFrequencies(wave_frame->frequency_domain, to_index);
     memcpy(current_data_->wave_data[to_index], wave_frame->time_domain, kWaveformSize * sizeof(mono_float));
@@ -111,6 +163,8 @@ namespace vital {
   void Wavetable::postProcess(float max_span) {
     static constexpr float kMinAmplitudePhase = 0.1f;
 
+    copyOnWrite();
+
     if (max_span > 0.0f) {
       float scale = 2.0f / max_span;
       for (int w = 0; w < current_data_->num_frames; ++w) {
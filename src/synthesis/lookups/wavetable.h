@@ -35,24 +35,51 @@ namespace vital {
 
       struct WavetableData {
         WavetableData(int frames, int table_version) :
-            num_frames(frames), frequency_ratio(1.0f), sample_rate(kDefaultSampleRate), version(table_version) { }
+            num_frames(frames), frequency_ratio(1.0f), sample_rate(kDefaultSampleRate), version(table_version),
+            wave_data(nullptr), frequency_amplitudes(nullptr), normalized_frequencies(nullptr), phases(nullptr) { }
+
+        // All frame arrays live in one block: amplitudes, normalized frequencies, phases then wave data.
+        size_t memorySize() const {
+          return num_frames * (3 * kPolyFrequencySize * sizeof(poly_float) + kWaveformSize * sizeof(mono_float));
+        }
+
+        void allocate() {
+          memory = std::make_unique<poly_float[]>(memorySize() / sizeof(poly_float));
+          useMemory(memory.get());
+        }
+
+        // Points the frame arrays into an external block of memorySize() bytes, like a mapped cache file.
+        void useMemory(void* block) {
+          frequency_amplitudes = static_cast<poly_float(*)[kPolyFrequencySize]>(block);
+          normalized_frequencies = frequency_amplitudes + num_frames;
+          phases = normalized_frequencies + num_frames;
+          wave_data = reinterpret_cast<mono_float(*)[kWaveformSize]>(phases + num_frames);
+        }
 
         int num_frames;
         mono_float frequency_ratio;
         mono_float sample_rate;
         int version;
-        std::unique_ptr<mono_float[][kWaveformSize]> wave_data;
-        std::unique_ptr<poly_float[][kPolyFrequencySize]> frequency_amplitudes;
-        std::unique_ptr<poly_float[][kPolyFrequencySize]> normalized_frequencies;
-        std::unique_ptr<poly_float[][kPolyFrequencySize]> phases;
+        mono_float (*wave_data)[kWaveformSize];
+        poly_float (*frequency_amplitudes)[kPolyFrequencySize];
+        poly_float (*normalized_frequencies)[kPolyFrequencySize];
+        poly_float (*phases)[kPolyFrequencySize];
+        std::unique_ptr<poly_float[]> memory;
+        std::unique_ptr<MemoryMappedFile> mapped_file;
       };
 
       static constexpr const mono_float* null_waveform() { return kZeroWaveform; }
+      static int nextVersion();
 
       Wavetable(int max_frames);
 
       void loadDefaultWavetable();
       void setNumFrames(int num_frames);
+      void swapData(Wavetable* other);
+
+      // Shared data is read only, the next edit to this table copies it first.
+      void loadSharedData(std::shared_ptr<WavetableData> data);
+      std::shared_ptr<WavetableData> shareData();
       void setFrequencyRatio(float frequency_ratio);
       void setSampleRate(float rate);
       std::string getName() { return name_; }
@@ -136,6 +163,8 @@ namespace vital {
 
     protected:
       Wavetable() = default;
+
+      void copyOnWrite();
     
       void loadFrequencyAmplitudes(const std::complex<float>* frequencies, int to_index);
       void loadNormalizedFrequencies(const std::complex<float>* frequencies, int to_index);
@@ -147,7 +176,8 @@ namespace vital {
       int max_frames_;
       WavetableData* current_data_;
       std::atomic<WavetableData*> active_audio_data_;
-      std::unique_ptr<WavetableData> data_;
+      std::shared_ptr<WavetableData> data_;
+      bool data_shared_;
       bool shepard_table_;
 
       mono_float fft_data_[2 * kWaveformSize];
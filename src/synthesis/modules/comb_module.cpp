@@ -45,4 +45,8 @@ namespace vital {
   void CombModule::hardReset() {
     getLocalProcessor(comb_filter_)->hardReset();
   }
+
+  void CombModule::releaseMemory() {
+    static_cast<CombFilter*>(getLocalProcessor(comb_filter_))->releaseMemory();
+  }
 } // namespace vital
@@ -45,6 +45,7 @@ namespace vital {
       void init() override;
       void reset(poly_mask reset_mask) override;
       void hardReset() override;
+      void releaseMemory();
       virtual Processor* clone() const override { return new CombModule(*this); }
 
     protected:
@@ -33,6 +33,7 @@ namespace vital {
       virtual void setSampleRate(int sample_rate) override;
       virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
       virtual Processor* clone() const override { return new DistortionModule(*this); }
+      virtual bool needsOversampling() const override { return true; }
 
     protected:
       Distortion* distortion_;
@@ -27,7 +27,7 @@ namespace vital {
       high_pass_(nullptr), low_shelf_(nullptr),
       notch_(nullptr), band_shelf_(nullptr),
       low_pass_(nullptr), high_shelf_(nullptr) {
-    audio_memory_ = std::make_shared<vital::StereoMemory>(vital::kAudioMemorySamples);
+    audio_memory_ = std::make_shared<vital::AudioCapture>(vital::kAudioMemorySamples);
   }
 
   void EqualizerModule::init() {
@@ -152,8 +152,7 @@ namespace vital {
     band_processor->processWithInput(low_processor->output()->buffer, num_samples);
     high_processor->processWithInput(band_processor->output()->buffer, num_samples);
 
-    const poly_float* output_buffer = high_processor->output()->buffer;
-    for (int i = 0; i < num_samples; ++i)
-      audio_memory_->push(output_buffer[i]);
+    if (audio_memory_->active())
+      audio_memory_->write(high_processor->output()->buffer, num_samples);
   }
 } // namespace vital
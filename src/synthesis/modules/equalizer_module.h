@@ -17,6 +17,7 @@
 #pragma once
 
 #include "synth_module.h"
+#include "audio_capture.h"
 
 namespace vital {
   class DigitalSvf;
@@ -34,7 +35,7 @@ namespace vital {
       void processWithInput(const poly_float* audio_in, int num_samples) override;
       Processor* clone() const override { return new EqualizerModule(*this); }
 
-      const StereoMemory* getAudioMemory() { return audio_memory_.get(); }
+      AudioCapture* getAudioMemory() { return audio_memory_.get(); }
 
     protected:
       Value* low_mode_;
@@ -48,7 +49,7 @@ namespace vital {
       DigitalSvf* low_pass_;
       DigitalSvf* high_shelf_;
 
-      std::shared_ptr<StereoMemory> audio_memory_;
+      std::shared_ptr<AudioCapture> audio_memory_;
 
       JUCE_LEAK_DETECTOR(EqualizerModule) 
   };
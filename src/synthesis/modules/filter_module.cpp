@@ -190,6 +190,9 @@ namespace vital {
     if (new_model == last_model_)
       return;
 
+    if (last_model_ == constants::kComb)
+      static_cast<CombModule*>(getLocalProcessor(comb_filter_))->releaseMemory();
+
     Processor* to_reset = nullptr;
     if (new_model == constants::kAnalog)
       to_reset = sallen_key_filter_;
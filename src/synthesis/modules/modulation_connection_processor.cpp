@@ -19,9 +19,11 @@
 
 namespace vital {
 
+  std::atomic<bool> ModulationConnectionProcessor::deferred_evaluation_(true);
+
   ModulationConnectionProcessor::ModulationConnectionProcessor(int index) :
-      SynthModule(kNumInputs, kNumOutputs), index_(index), polyphonic_(true), current_value_(nullptr),
-      bipolar_(nullptr), stereo_(nullptr) {
+      SynthModule(kNumInputs, kNumOutputs), index_(index), polyphonic_(true), deferred_(false),
+      current_value_(nullptr), bipolar_(nullptr), stereo_(nullptr), block_() {
     setControlRate(true);
 
     modulation_amount_ = 0.0f;
@@ -46,6 +48,11 @@ namespace vital {
     std::string bypass_name = "modulation_" + std::to_string(index_ + 1) + "_bypass";
     bypass_ = createBaseControl(bypass_name);
 
+    std::string number = std::to_string(index_ + 1);
+    createStatusOutput("modulation_source_" + number, output(kModulationSource));
+    createStatusOutput("modulation_amount_" + number, output(kModulationPreScale));
+    clearStatus();
+
     SynthModule::init();
   }
 
@@ -65,6 +72,7 @@ namespace vital {
   }
 
   void ModulationConnectionProcessor::processAudioRate(int num_samples, const Output* source) {
+    deferred_ = false;
     if (bypass_->value()) {
       output(kModulationOutput)->clearBuffer();
       output(kModulationOutput)->trigger_value = 0.0f;
@@ -73,176 +81,59 @@ namespace vital {
 
     poly_float power = -input(kModulationPower)->at(0);
     bool using_power = (poly_float::notEqual(0.0f, power) | poly_float::notEqual(0.0f, power_)).anyMask();
-    bool using_map = !map_generator_->linear();
-
-    if (using_power && using_map)
-      processAudioRateRemappedAndMorphed(num_samples, source, power);
-    else if (using_power)
-      processAudioRateMorphed(num_samples, source, power);
-    else if (using_map)
-      processAudioRateRemapped(num_samples, source);
-    else
-      processAudioRateLinear(num_samples, source);
-
-    power_ = power;
-  }
-
-  void ModulationConnectionProcessor::processAudioRateLinear(int num_samples, const Output* source) {
-    poly_float* dest = output(kModulationOutput)->buffer;
-    const poly_float* modulation_source = source->buffer;
-
-    poly_float bipolar_offset = -bipolar_->value() * 0.5f;
-    poly_float current_amount = modulation_amount_;
-    poly_float stereo_scale = poly_float(1.0f) - (constants::kRightOne * 2.0f * stereo_->value());
-    poly_float modulation_amount = utils::clamp(input(kModulationAmount)->at(0), -1.0f, 1.0f) * stereo_scale;
-    modulation_amount_ = modulation_amount * (*destination_scale_);
-    current_amount = utils::maskLoad(current_amount, modulation_amount_, getResetMask(kReset));
-    poly_float delta_amount = (modulation_amount_ - current_amount) * (1.0f / num_samples);
-
-    for (int i = 0; i < num_samples; ++i) {
-      current_amount += delta_amount;
-      poly_float modulation_value = modulation_source[i];
-      dest[i] = (modulation_value + bipolar_offset) * current_amount;
-    }
-
-    output(kModulationPreScale)->buffer[0] = (modulation_source[0] + bipolar_offset) * modulation_amount;
-    output(kModulationOutput)->trigger_value = dest[0];
-  }
-
-  void ModulationConnectionProcessor::processAudioRateMorphed(int num_samples, const Output* source,
-                                                              poly_float power) {
-    poly_float* dest = output(kModulationOutput)->buffer;
-    const poly_float* modulation_source = source->buffer;
-    poly_float bipolar_offset = -bipolar_->value() * 0.5f;
 
     poly_float bipolar = bipolar_->value();
-    poly_float polarity_pre_scale = bipolar + 1.0f;
-    poly_float polarity_post_scale = -bipolar * 0.5f + 1.0f;
-    polarity_post_scale *= poly_float(1.0f) - (constants::kRightOne * 2.0f * stereo_->value());
-
-    poly_float current_amount = modulation_amount_;
-    poly_float current_power = power_;
-
+    poly_float stereo_scale = poly_float(1.0f) - (constants::kRightOne * 2.0f * stereo_->value());
     poly_float modulation_amount = utils::clamp(input(kModulationAmount)->at(0), -1.0f, 1.0f);
-    modulation_amount_ = modulation_amount * (*destination_scale_);
-
-    poly_mask reset_mask = getResetMask(kReset);
-    current_amount = utils::maskLoad(current_amount, modulation_amount_, reset_mask);
-    current_power = utils::maskLoad(current_power, power, reset_mask);
-
-    float sample_inc = 1.0f / num_samples;
-    poly_float delta_amount = (modulation_amount_ - current_amount) * sample_inc;
-    poly_float delta_power = (power - current_power) * sample_inc;
 
-    for (int i = 0; i < num_samples; ++i) {
-      current_amount += delta_amount;
-      current_power += delta_power;
-
-      poly_float modulation_value = modulation_source[i];
-      poly_float modulation_shift = modulation_value * polarity_pre_scale - bipolar;
-      poly_float modulation_abs = poly_float::abs(modulation_shift);
-      poly_mask sign_mask = poly_float::sign_mask(modulation_shift);
-
-      poly_float shifted_modulation = futils::powerScale(modulation_abs, current_power);
-      poly_float pre_modulation = current_amount * shifted_modulation;
-      dest[i] = (pre_modulation ^ sign_mask) * polarity_post_scale;
+    block_.source = source->buffer;
+    block_.remap = !map_generator_->linear();
+    block_.morph = using_power;
+    block_.map = map_generator_->getCubicInterpolationBuffer();
+    block_.resolution = map_generator_->resolution();
+    if (using_power) {
+      block_.offset = -bipolar;
+      block_.pre_scale = bipolar + 1.0f;
+      block_.post_scale = (-bipolar * 0.5f + 1.0f) * stereo_scale;
+    }
+    else {
+      block_.offset = -bipolar * 0.5f;
+      modulation_amount *= stereo_scale;
     }
 
-    output(kModulationPreScale)->buffer[0] = dest[0] * (1.0f / (*destination_scale_));
-    output(kModulationOutput)->trigger_value = dest[0];
-  }
-
-  void ModulationConnectionProcessor::processAudioRateRemappedAndMorphed(int num_samples, const Output* source,
-                                                                         poly_float power) {
-    poly_float* dest = output(kModulationOutput)->buffer;
-    const poly_float* modulation_source = source->buffer;
-    poly_float bipolar_offset = -bipolar_->value() * 0.5f;
-
-    poly_float bipolar = bipolar_->value();
-    poly_float polarity_pre_scale = bipolar + 1.0f;
-    poly_float polarity_post_scale = -bipolar * 0.5f + 1.0f;
-    polarity_post_scale *= poly_float(1.0f) - (constants::kRightOne * 2.0f * stereo_->value());
-
+    poly_mask reset_mask = getResetMask(kReset);
     poly_float current_amount = modulation_amount_;
-    poly_float current_power = power_;
-
-    poly_float modulation_amount = utils::clamp(input(kModulationAmount)->at(0), -1.0f, 1.0f);
     modulation_amount_ = modulation_amount * (*destination_scale_);
-
-    poly_mask reset_mask = getResetMask(kReset);
     current_amount = utils::maskLoad(current_amount, modulation_amount_, reset_mask);
-    current_power = utils::maskLoad(current_power, power, reset_mask);
-
-    float sample_inc = 1.0f / num_samples;
-    poly_float delta_amount = (modulation_amount_ - current_amount) * sample_inc;
-    poly_float delta_power = (power - current_power) * sample_inc;
-
-    mono_float* buffer = map_generator_->getCubicInterpolationBuffer();
-    for (int i = 0; i < num_samples; ++i) {
-      current_amount += delta_amount;
-      current_power += delta_power;
-      poly_float modulation_value = modulation_source[i];
-
-      mono_float resolution = map_generator_->resolution();
-      poly_float boost = utils::clamp(modulation_value * resolution, 0.0f, resolution);
-      poly_int indices = utils::clamp(utils::toInt(boost), 0, resolution - 1);
-      poly_float t = boost - utils::toFloat(indices);
-
-      matrix interpolation_matrix = utils::getCatmullInterpolationMatrix(t);
-      matrix value_matrix = utils::getValueMatrix(buffer, indices);
-
-      value_matrix.transpose();
-      modulation_value = utils::clamp(interpolation_matrix.multiplyAndSumRows(value_matrix), -1.0f, 1.0f);
-
-      poly_float modulation_shift = modulation_value * polarity_pre_scale - bipolar;
-      poly_float modulation_abs = poly_float::abs(modulation_shift);
-      poly_mask sign_mask = poly_float::sign_mask(modulation_shift);
+    poly_float current_power = utils::maskLoad(power_, power, reset_mask);
+    power_ = power;
 
-      poly_float shifted_modulation = futils::powerScale(modulation_abs, current_power);
-      poly_float pre_modulation = current_amount * shifted_modulation;
-      dest[i] = (pre_modulation ^ sign_mask) * polarity_post_scale;
-    }
+    mono_float sample_inc = 1.0f / num_samples;
+    block_.amount = current_amount;
+    block_.delta_amount = (modulation_amount_ - current_amount) * sample_inc;
+    block_.power = current_power;
+    block_.delta_power = (power - current_power) * sample_inc;
 
-    output(kModulationPreScale)->buffer[0] = dest[0] * (1.0f / (*destination_scale_));
-    output(kModulationOutput)->trigger_value = dest[0];
-  }
+    poly_float first_value = block_.firstValue();
+    if (using_power)
+      output(kModulationPreScale)->buffer[0] = first_value * (1.0f / (*destination_scale_));
+    else
+      output(kModulationPreScale)->buffer[0] = (source->buffer[0] + block_.offset) * modulation_amount;
+    output(kModulationOutput)->trigger_value = first_value;
 
-  void ModulationConnectionProcessor::processAudioRateRemapped(int num_samples, const Output* source) {
     poly_float* dest = output(kModulationOutput)->buffer;
-    const poly_float* modulation_source = source->buffer;
-
-    poly_float bipolar_offset = -bipolar_->value() * 0.5f;
-    poly_float current_amount = modulation_amount_;
-    poly_float stereo_scale = poly_float(1.0f) - (constants::kRightOne * 2.0f * stereo_->value());
-    poly_float modulation_amount = utils::clamp(input(kModulationAmount)->at(0), -1.0f, 1.0f) * stereo_scale;
-    modulation_amount_ = modulation_amount * (*destination_scale_);
-    current_amount = utils::maskLoad(current_amount, modulation_amount_, getResetMask(kReset));
-    poly_float delta_amount = (modulation_amount_ - current_amount) * (1.0f / num_samples);
-
-    mono_float* buffer = map_generator_->getCubicInterpolationBuffer();
-    for (int i = 0; i < num_samples; ++i) {
-      current_amount += delta_amount;
-      poly_float modulation_value = modulation_source[i];
-
-      mono_float resolution = map_generator_->resolution();
-      poly_float boost = utils::clamp(modulation_value * resolution, 0.0f, resolution);
-      poly_int indices = utils::clamp(utils::toInt(boost), 0, resolution - 1);
-      poly_float t = boost - utils::toFloat(indices);
-
-      matrix interpolation_matrix = utils::getCatmullInterpolationMatrix(t);
-      matrix value_matrix = utils::getValueMatrix(buffer, indices);
-
-      value_matrix.transpose();
-
-      modulation_value = utils::clamp(interpolation_matrix.multiplyAndSumRows(value_matrix), -1.0f, 1.0f);
-      dest[i] = (modulation_value + bipolar_offset) * current_amount;
+    if (polyphonic_ && deferred_evaluation_.load(std::memory_order_relaxed)) {
+      deferred_ = true;
+      dest[0] = first_value;
+    }
+    else {
+      utils::zeroBuffer(dest, num_samples);
+      block_.accumulate(dest, num_samples);
     }
-
-    output(kModulationPreScale)->buffer[0] = (modulation_source[0] + bipolar_offset) * modulation_amount;
-    output(kModulationOutput)->trigger_value = dest[0];
   }
 
   void ModulationConnectionProcessor::processControlRate(const Output* source) {
+    deferred_ = false;
     if (bypass_->value()) {
       output(kModulationOutput)->buffer[0] = 0.0f;
       output(kModulationOutput)->trigger_value = 0.0f;
@@ -19,6 +19,7 @@
 #include "synth_module.h"
 #include "synth_constants.h"
 #include "line_generator.h"
+#include "operators.h"
 
 namespace vital {
   class ModulationConnectionProcessor : public SynthModule {
@@ -44,14 +45,20 @@ namespace vital {
       void init() override;
       void process(int num_samples) override;
       void processAudioRate(int num_samples, const Output* source);
-      void processAudioRateLinear(int num_samples, const Output* source);
-      void processAudioRateRemapped(int num_samples, const Output* source);
-      void processAudioRateMorphed(int num_samples, const Output* source, poly_float power);
-      void processAudioRateRemappedAndMorphed(int num_samples, const Output* source, poly_float power);
       void processControlRate(const Output* source);
 
       virtual Processor* clone() const override { return new ModulationConnectionProcessor(*this); }
 
+      // Unconnected slots never run, so voices share one copy until the slot is connected.
+      bool hasState() const override { return enabled(); }
+
+      // Polyphonic audio rate connections are summed by their destination without filling our buffer.
+      const ModulationBlock* modulationBlock() const override { return deferred_ ? &block_ : nullptr; }
+
+      // Turning this off makes every connection fill its own buffer again so benchmarks can compare both.
+      static void setDeferredEvaluation(bool deferred) { deferred_evaluation_ = deferred; }
+      static bool deferredEvaluation() { return deferred_evaluation_.load(); }
+
       void initializeBaseValue(Value* base_value) { current_value_ = base_value; }
       void initializeMapping() { map_generator_->initLinear(); }
 
@@ -70,9 +77,23 @@ namespace vital {
 
       LineGenerator* lineMapGenerator() { return map_generator_.get(); }
 
+      // Only enabled connections publish their source and amount readouts.
+      void updateStatus(poly_mask voice_mask) {
+        for (StatusOutput* status_output : data_->status_output_list)
+          status_output->update(voice_mask);
+      }
+
+      void clearStatus() {
+        for (StatusOutput* status_output : data_->status_output_list)
+          status_output->clear();
+      }
+
     protected:
+      static std::atomic<bool> deferred_evaluation_;
+
       int index_;
       bool polyphonic_;
+      bool deferred_;
       Value* current_value_;
       Value* bipolar_;
       Value* stereo_;
@@ -80,6 +101,7 @@ namespace vital {
 
       poly_float power_;
       poly_float modulation_amount_;
+      ModulationBlock block_;
 
       std::shared_ptr<mono_float> destination_scale_;
       mono_float last_destination_scale_;
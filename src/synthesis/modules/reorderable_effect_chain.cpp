@@ -18,6 +18,7 @@
 
 #include "chorus_module.h"
 #include "compressor_module.h"
+#include "decimator.h"
 #include "delay_module.h"
 #include "distortion_module.h"
 #include "equalizer_module.h"
@@ -26,6 +27,7 @@
 #include "phaser_module.h"
 #include "reverb_module.h"
 #include "synth_strings.h"
+#include "upsampler.h"
 
 namespace vital {
 
@@ -58,6 +60,8 @@ namespace vital {
         SynthModule::setOversampleAmount(oversampling);
       }
 
+      bool needsOversampling() const override { return true; }
+
     private:
       FilterModule* filter_;
       Output input_;
@@ -75,6 +79,17 @@ namespace vital {
       effects_on_[i] = createBaseControl(strings::kEffectOrder[i] + "_on");
       effects_[i] = effect_module;
       effect_order_[i] = i;
+
+      upsamplers_[i] = nullptr;
+      decimators_[i] = nullptr;
+      if (effect_module->needsOversampling()) {
+        upsamplers_[i] = new Upsampler(kMaxOversampleStages);
+        addProcessor(upsamplers_[i]);
+
+        decimators_[i] = new Decimator(kMaxOversampleStages);
+        decimators_[i]->plug(effect_module->output(), Decimator::kAudio);
+        addProcessor(decimators_[i]);
+      }
     }
 
     last_order_ = utils::encodeOrderToFloat(effect_order_, constants::kNumEffects);
@@ -125,10 +140,17 @@ namespace vital {
       int index = effect_order_[i];
       bool on = effects_on_[index]->value();
       bool enabled = effects_[index]->enabled();
-      if (on != enabled)
+      if (on != enabled) {
         effects_[index]->enable(on);
+        if (on && decimators_[index]) {
+          upsamplers_[index]->hardReset();
+          decimators_[index]->hardReset();
+        }
+      }
 
-      if (on) {
+      if (on && upsamplers_[index] && effects_[index]->getOversampleAmount() > 1)
+        audio_in = processOversampled(index, audio_in, num_samples);
+      else if (on) {
         effects_[index]->processWithInput(audio_in, num_samples);
         audio_in = effects_[index]->output(0)->buffer;
       }
@@ -138,9 +160,34 @@ namespace vital {
     utils::copyBuffer(output()->buffer, audio_in, num_samples);
   }
 
+  const poly_float* ReorderableEffectChain::processOversampled(int index, const poly_float* audio_in,
+                                                              int num_samples) {
+    upsamplers_[index]->processWithInput(audio_in, num_samples);
+    int oversampled_samples = num_samples * effects_[index]->getOversampleAmount();
+    effects_[index]->processWithInput(upsamplers_[index]->output()->buffer, oversampled_samples);
+    decimators_[index]->process(num_samples);
+    return decimators_[index]->output()->buffer;
+  }
+
+  void ReorderableEffectChain::setOversampleAmount(int oversample) {
+    // The chain runs at the base rate and only effects that alias get oversampled.
+    SynthModule::setOversampleAmount(1);
+    for (int i = 0; i < constants::kNumEffects; ++i) {
+      if (upsamplers_[i]) {
+        effects_[i]->setOversampleAmount(oversample);
+        upsamplers_[i]->setOversampleAmount(oversample);
+      }
+    }
+  }
+
   void ReorderableEffectChain::hardReset() {
-    for (int i = 0; i < constants::kNumEffects; ++i)
+    for (int i = 0; i < constants::kNumEffects; ++i) {
       effects_[i]->hardReset();
+      if (decimators_[i]) {
+        upsamplers_[i]->hardReset();
+        decimators_[i]->hardReset();
+      }
+    }
   }
 
   void ReorderableEffectChain::correctToTime(double seconds) {
@@ -22,7 +22,9 @@
 
 namespace vital {
 
-  class StereoMemory;
+  class AudioCapture;
+  class Decimator;
+  class Upsampler;
 
   class ReorderableEffectChain : public SynthModule {
     public:
@@ -37,20 +39,24 @@ namespace vital {
       virtual void process(int num_samples) override;
       virtual void hardReset() override;
       virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
+      virtual void setOversampleAmount(int oversample) override;
       virtual Processor* clone() const override { return new ReorderableEffectChain(*this); }
 
       virtual void correctToTime(double seconds) override;
 
       SynthModule* getEffect(constants::Effect effect) { return effects_[effect]; }
-      const StereoMemory* getEqualizerMemory() { return equalizer_memory_; }
+      AudioCapture* getEqualizerMemory() { return equalizer_memory_; }
 
     protected:
       SynthModule* createEffectModule(int index);
+      const poly_float* processOversampled(int index, const poly_float* audio_in, int num_samples);
 
-      const StereoMemory* equalizer_memory_;
+      AudioCapture* equalizer_memory_;
       const Output* beats_per_second_;
       const Output* keytrack_;
       SynthModule* effects_[constants::kNumEffects];
+      Upsampler* upsamplers_[constants::kNumEffects];
+      Decimator* decimators_[constants::kNumEffects];
       Value* effects_on_[constants::kNumEffects];
       int effect_order_[constants::kNumEffects];
       float last_order_;
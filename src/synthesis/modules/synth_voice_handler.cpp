@@ -119,17 +119,6 @@ namespace vital {
     createStatusOutput("stereo", stereo_->output());
     createStatusOutput("sample_phase", producers_->samplePhaseOutput());
     createStatusOutput("num_voices", &num_voices_);
-
-    std::string modulation_source_prefix = "modulation_source_";
-    std::string modulation_amount_prefix = "modulation_amount_";
-    for (int i = 0; i < vital::kMaxModulationConnections; ++i) {
-      ModulationConnectionProcessor* processor = modulation_bank_.atIndex(i)->modulation_processor.get();
-      std::string number = std::to_string(i + 1);
-      Output* source_output = processor->output(ModulationConnectionProcessor::kModulationSource);
-      Output* pre_scale_output = processor->output(ModulationConnectionProcessor::kModulationPreScale);
-      createStatusOutput(modulation_source_prefix + number, source_output);
-      createStatusOutput(modulation_amount_prefix + number, pre_scale_output);
-    }
   }
 
   void SynthVoiceHandler::prepareDestroy() {
@@ -315,15 +304,18 @@ namespace vital {
     note_retriggered_.clearTrigger();
 
     if (num_voices == 0) {
-      for (auto& status_source : data_->status_outputs)
-        status_source.second->clear();
+      for (StatusOutput* status_source : data_->status_output_list)
+        status_source->clear();
+      for (ModulationConnectionProcessor* processor : enabled_modulation_processors_)
+        processor->clearStatus();
     }
     else {
       last_active_voice_mask_ = getCurrentVoiceMask();
-      for (auto& status_source : data_->status_outputs)
-        status_source.second->update(last_active_voice_mask_);
+      for (StatusOutput* status_source : data_->status_output_list)
+        status_source->update(last_active_voice_mask_);
 
       for (ModulationConnectionProcessor* processor : enabled_modulation_processors_) {
+        processor->updateStatus(last_active_voice_mask_);
         poly_float* buffer = processor->output()->buffer;
         if (processor->isControlRate() || processor->isPolyphonicModulation()) {
           poly_float masked_value = buffer[0] & last_active_voice_mask_;
@@ -391,6 +383,7 @@ namespace vital {
 
   void SynthVoiceHandler::disableModulationConnection(ModulationConnectionProcessor* processor) {
     enabled_modulation_processors_.remove(processor);
+    processor->clearStatus();
   }
 
   void SynthVoiceHandler::setupPolyModulationReadouts() {
@@ -15,9 +15,13 @@
  */
 
 #include "sample_source.h"
+#include "asset_cache.h"
+#include "embedded_data.h"
 #include "futils.h"
 #include "synth_constants.h"
 
+#include <chrono>
+#include <condition_variable>
 #include <thread>
 
 namespace vital {
@@ -196,14 +200,13 @@ namespace vital {
         dest[i] = getFilteredLoopSample(original, 2 * i, original_size);
     }
 
-    void createBandLimitedBuffers(std::vector<std::unique_ptr<mono_float[]>>& destination,
-                                  std::vector<std::unique_ptr<mono_float[]>>& loop_destination,
-                                  const mono_float* buffer, int size) {
-      destination.push_back(std::make_unique<mono_float[]>(size + 2 * Sample::kBufferSamples));
-      loop_destination.push_back(std::make_unique<mono_float[]>(size + 2 * Sample::kBufferSamples));
+    void createOriginalBuffers(std::unique_ptr<mono_float[]>& play, std::unique_ptr<mono_float[]>& loop,
+                               const mono_float* buffer, int size) {
+      play = std::make_unique<mono_float[]>(size + 2 * Sample::kBufferSamples);
+      loop = std::make_unique<mono_float[]>(size + 2 * Sample::kBufferSamples);
 
-      mono_float* play_buffer = destination.back().get();
-      mono_float* loop_buffer = loop_destination.back().get();
+      mono_float* play_buffer = play.get();
+      mono_float* loop_buffer = loop.get();
       memcpy(play_buffer + Sample::kBufferSamples, buffer, size * sizeof(mono_float));
       memcpy(loop_buffer + Sample::kBufferSamples, buffer, size * sizeof(mono_float));
 
@@ -214,53 +217,458 @@ namespace vital {
         loop_buffer[i] = loop_buffer[size + i];
         loop_buffer[size + Sample::kBufferSamples + i] = loop_buffer[Sample::kBufferSamples + i];
       }
+    }
+
+    void createUpsampledBuffers(std::unique_ptr<mono_float[]>& play, std::unique_ptr<mono_float[]>& loop,
+                                const mono_float* source, int source_size) {
+      int upsampled_size = source_size * 2;
+      int num_samples = upsampled_size + 2 * Sample::kBufferSamples;
+      play = std::make_unique<mono_float[]>(num_samples);
+      loop = std::make_unique<mono_float[]>(num_samples);
+
+      upsample(source + Sample::kBufferSamples, play.get() + Sample::kBufferSamples, source_size, upsampled_size);
+      memcpy(loop.get(), play.get(), num_samples * sizeof(mono_float));
+    }
 
-      int current_size = size;
-      for (int i = 0; i < Sample::kUpsampleTimes; ++i) {
-        int upsampled_size = current_size * 2;
-        int num_samples = upsampled_size + 2 * Sample::kBufferSamples;
-        destination.insert(destination.begin(), std::make_unique<mono_float[]>(num_samples));
-        loop_destination.insert(loop_destination.begin(), std::make_unique<mono_float[]>(num_samples));
+    void createDownsampledBuffers(std::unique_ptr<mono_float[]>& play, std::unique_ptr<mono_float[]>& loop,
+                                  const mono_float* source, const mono_float* source_loop,
+                                  int source_size, int size) {
+      play = std::make_unique<mono_float[]>(size + 2 * Sample::kBufferSamples);
+      loop = std::make_unique<mono_float[]>(size + 2 * Sample::kBufferSamples);
 
-        mono_float* next_buffer = destination.front().get();
-        mono_float* next_loop_buffer = loop_destination.front().get();
+      mono_float* play_buffer = play.get();
+      mono_float* loop_buffer = loop.get();
+      downsample(source + Sample::kBufferSamples, play_buffer + Sample::kBufferSamples, source_size, size);
+      downsampleLoop(source_loop + Sample::kBufferSamples, loop_buffer + Sample::kBufferSamples,
+                     source_size, size);
+
+      for (int i = 0; i < Sample::kBufferSamples; ++i) {
+        play_buffer[i] = 0.0f;
+        play_buffer[size + Sample::kBufferSamples + i] = 0.0f;
 
-        upsample(play_buffer + Sample::kBufferSamples, next_buffer + Sample::kBufferSamples,
-                 current_size, upsampled_size);
-        memcpy(next_loop_buffer, next_buffer, num_samples * sizeof(mono_float));
-        current_size = upsampled_size;
+        loop_buffer[i] = source_loop[size + i];
+        loop_buffer[size + Sample::kBufferSamples + i] = loop_buffer[Sample::kBufferSamples + i];
       }
+    }
 
-      play_buffer = destination.back().get();
-      loop_buffer = loop_destination.back().get();
-      current_size = size;
+    void createLevel(std::vector<std::unique_ptr<mono_float[]>>& destination,
+                     std::vector<std::unique_ptr<mono_float[]>>& loop_destination,
+                     const std::vector<int>& level_sizes, int index) {
+      if (index < Sample::kUpsampleTimes) {
+        createUpsampledBuffers(destination[index], loop_destination[index],
+                               destination[index + 1].get(), level_sizes[index + 1]);
+      }
+      else {
+        createDownsampledBuffers(destination[index], loop_destination[index],
+                                 destination[index - 1].get(), loop_destination[index - 1].get(),
+                                 level_sizes[index - 1], level_sizes[index]);
+      }
+    }
+  }
 
-      while (current_size >= Sample::kMinSize) {
-        int next_size = (current_size + 1) / 2;
-        destination.push_back(std::make_unique<mono_float[]>(next_size + 2 * Sample::kBufferSamples));
-        loop_destination.push_back(std::make_unique<mono_float[]>(next_size + 2 * Sample::kBufferSamples));
+  namespace {
+    typedef AssetCache<Sample::SampleData> SampleCache;
+
+    AssetKey sampleKey(const mono_float* left_buffer, const mono_float* right_buffer, int size, int sample_rate) {
+      AssetKey key;
+      key.add(size).add(sample_rate).add(right_buffer != nullptr);
+      key.add(left_buffer, size * sizeof(mono_float));
+      if (right_buffer)
+        key.add(right_buffer, size * sizeof(mono_float));
+      return key;
+    }
+
+    // Wakes a worker thread from the audio thread. Notifying without the mutex means the audio thread never waits
+    // on a lock the worker holds. A wake racing the worker going to sleep can be missed so waits are bounded.
+    class WorkSignal {
+      public:
+        WorkSignal() : pending_(false) { }
+
+        void signal() {
+          pending_.store(true, std::memory_order_release);
+          condition_.notify_one();
+        }
+
+        // Returns whether the signal was raised, false if the wait timed out.
+        bool wait(int timeout_ms) {
+          std::unique_lock<std::mutex> lock(mutex_);
+          bool signaled = condition_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                              [this] { return pending_.load(); });
+          pending_.store(false);
+          return signaled;
+        }
 
-        mono_float* next_buffer = destination.back().get();
-        mono_float* next_loop_buffer = loop_destination.back().get();
+      private:
+        std::atomic<bool> pending_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+    };
+
+    // Builds the band limited levels playback has asked for. The audio thread only flags a level and raises a
+    // WorkSignal so it never allocates, filters audio or locks itself.
+    class SampleLevelBuilder : public Thread {
+      public:
+        static constexpr int kIdleWaitMs = 100;
+        static constexpr int kStopTimeoutMs = 1000;
+
+        static SampleLevelBuilder& instance() {
+          static SampleLevelBuilder builder;
+          return builder;
+        }
 
-        downsample(play_buffer + Sample::kBufferSamples, next_buffer + Sample::kBufferSamples,
-                   current_size, next_size);
-        downsampleLoop(loop_buffer + Sample::kBufferSamples, next_loop_buffer + Sample::kBufferSamples,
-                       current_size, next_size);
+        void requestBuild() { signal_.signal(); }
 
-        for (int i = 0; i < Sample::kBufferSamples; ++i) {
-          next_buffer[i] = 0.0f;
-          next_buffer[next_size + Sample::kBufferSamples + i] = 0.0f;
+        void run() override {
+          while (!threadShouldExit()) {
+            if (!signal_.wait(kIdleWaitMs))
+              continue;
 
-          next_loop_buffer[i] = loop_buffer[next_size + i];
-          next_loop_buffer[next_size + Sample::kBufferSamples + i] = next_loop_buffer[Sample::kBufferSamples + i];
+            for (std::shared_ptr<Sample::SampleData>& data : SampleCache::instance().entries()) {
+              if (threadShouldExit())
+                return;
+              data->buildRequestedLevels();
+            }
+          }
         }
 
-        play_buffer = next_buffer;
-        loop_buffer = next_loop_buffer;
-        current_size = next_size;
+      private:
+        SampleLevelBuilder() : Thread("Sample Level Builder") { startThread(); }
+        ~SampleLevelBuilder() {
+          signalThreadShouldExit();
+          signal_.signal();
+          stopThread(kStopTimeoutMs);
+        }
+
+        WorkSignal signal_;
+    };
+
+    // Keeps the rings of every live stream full. Polls while a cursor is playing and otherwise sleeps until a
+    // cursor is claimed or seeks.
+    class SampleStreamThread : public Thread {
+      public:
+        static constexpr int kPollMs = 2;
+        static constexpr int kIdleWaitMs = 100;
+        static constexpr int kStopTimeoutMs = 1000;
+
+        static SampleStreamThread& instance() {
+          static SampleStreamThread thread;
+          return thread;
+        }
+
+        void addStream(std::shared_ptr<SampleStream> stream) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          streams_.erase(std::remove_if(streams_.begin(), streams_.end(),
+                                        [](const std::weak_ptr<SampleStream>& s) { return s.expired(); }),
+                         streams_.end());
+          streams_.push_back(stream);
+          signal_.signal();
+        }
+
+        void wake() { signal_.signal(); }
+
+        void run() override {
+          while (!threadShouldExit()) {
+            std::vector<std::shared_ptr<SampleStream>> streams = liveStreams();
+            bool playing = false;
+            for (std::shared_ptr<SampleStream>& stream : streams)
+              playing = stream->fillCursors() || playing;
+
+            streams.clear();
+            signal_.wait(playing ? kPollMs : kIdleWaitMs);
+          }
+        }
+
+      private:
+        SampleStreamThread() : Thread("Sample Stream") { startThread(); }
+        ~SampleStreamThread() {
+          signalThreadShouldExit();
+          signal_.signal();
+          stopThread(kStopTimeoutMs);
+        }
+
+        std::vector<std::shared_ptr<SampleStream>> liveStreams() {
+          std::lock_guard<std::mutex> lock(mutex_);
+          std::vector<std::shared_ptr<SampleStream>> live;
+          for (std::weak_ptr<SampleStream>& stream : streams_) {
+            std::shared_ptr<SampleStream> locked = stream.lock();
+            if (locked)
+              live.push_back(std::move(locked));
+          }
+          return live;
+        }
+
+        WorkSignal signal_;
+        std::mutex mutex_;
+        std::vector<std::weak_ptr<SampleStream>> streams_;
+    };
+
+    // Head levels are built with clamped filter edges so the last samples before the cut aren't exact.
+    constexpr int kStreamHeadMargin = SampleSource::kNumDownsampleTaps + Sample::kBufferSamples;
+
+    std::atomic<int> next_stream_id(1);
+
+    void readPcmField(const json& value, mono_float* buffer, int length) {
+      MemoryOutputStream decoded;
+      const void* pcm_data = nullptr;
+      size_t size = 0;
+      int num_samples = 0;
+      if (EmbeddedData::read(value, decoded, pcm_data, size))
+        num_samples = std::min<int>(length, size / sizeof(int16_t));
+
+      utils::pcmToFloatData(buffer, static_cast<const int16_t*>(pcm_data), num_samples);
+      std::fill(buffer + num_samples, buffer + length, 0.0f);
+    }
+  } // namespace
+
+  SampleStream::Cursor::Cursor() : stream_(nullptr), claimed_(false), generation_(0), request_index_(0),
+                                   request_level_(0), request_loop_(false), play_position_(0), read_count_(0),
+                                   write_count_(0), fill_generation_(0), fill_level_(0), fill_loop_(false),
+                                   fill_index_(0), fill_play_position_(0) {
+    blocks_ = std::make_unique<Block[]>(kNumBlocks);
+  }
+
+  void SampleStream::Cursor::seek(int64_t index, int level, bool loop) {
+    // Everything in the ring is stale now. Freeing it here instead of in findBlock lets the stream thread refill
+    // while the voice still plays from the in memory head.
+    read_count_.store(write_count_.load(std::memory_order_acquire), std::memory_order_release);
+    request_index_.store(index);
+    request_level_.store(level);
+    request_loop_.store(loop);
+    play_position_.store(index);
+    generation_.store(generation_.load() + 1, std::memory_order_release);
+    stream_->wakeStreaming();
+  }
+
+  const SampleStream::Block* SampleStream::Cursor::findBlock(int64_t index) {
+    int generation = generation_.load(std::memory_order_relaxed);
+    int64_t read = read_count_.load(std::memory_order_relaxed);
+    int64_t write = write_count_.load(std::memory_order_acquire);
+
+    const Block* found = nullptr;
+    for (; read < write; ++read) {
+      const Block& block = blocks_[read % kNumBlocks];
+      if (block.generation == generation && index < block.start + kBlockSize) {
+        if (index >= block.start)
+          found = &block;
+        break;
       }
     }
+
+    read_count_.store(read, std::memory_order_release);
+    return found;
+  }
+
+  void SampleStream::startStreaming(std::shared_ptr<SampleStream> stream) {
+    stream->streaming_.store(true);
+    SampleStreamThread::instance().addStream(std::move(stream));
+  }
+
+  SampleStream::SampleStream(std::unique_ptr<Reader> reader, const std::string& path) :
+      reader_(std::move(reader)), path_(path), id_(next_stream_id++), underruns_(0), streaming_(false) {
+    length_ = reader_->length();
+    sample_rate_ = reader_->sampleRate();
+    stereo_ = reader_->stereo();
+    cursors_ = std::make_unique<Cursor[]>(kMaxCursors);
+    for (int i = 0; i < kMaxCursors; ++i)
+      cursors_[i].stream_ = this;
+    setHeadLength(0);
+  }
+
+  void SampleStream::wakeStreaming() {
+    // Streams the thread doesn't know about are filled by whoever owns their cursors.
+    if (streaming_.load())
+      SampleStreamThread::instance().wake();
+  }
+
+  void SampleStream::setHeadLength(int head_length) {
+    int margin = head_length < length_ ? kStreamHeadMargin : 0;
+    for (int i = 0; i < kNumLevels; ++i)
+      head_ends_[i] = std::max(0, (head_length >> i) - margin);
+  }
+
+  void SampleStream::readHead(mono_float* left, mono_float* right, int head_length) {
+    render(0, 0, head_length, false, left, right);
+  }
+
+  SampleStream::Cursor* SampleStream::claimCursor() {
+    for (int i = 0; i < kMaxCursors; ++i) {
+      bool claimed = false;
+      if (cursors_[i].claimed_.compare_exchange_strong(claimed, true)) {
+        wakeStreaming();
+        return &cursors_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  bool SampleStream::fillCursor(Cursor* cursor) {
+    std::lock_guard<std::mutex> lock(cursor->fill_mutex_);
+
+    int generation = cursor->generation_.load(std::memory_order_acquire);
+    if (generation == 0)
+      return false;
+
+    // A cursor whose voice stopped moving has nothing left to consume, its next seek wakes the thread again.
+    int64_t play_position = cursor->play_position_.load();
+    bool playing = generation != cursor->fill_generation_ || play_position != cursor->fill_play_position_;
+    cursor->fill_play_position_ = play_position;
+
+    if (generation != cursor->fill_generation_) {
+      cursor->fill_generation_ = generation;
+      cursor->fill_index_ = cursor->request_index_.load();
+      cursor->fill_level_ = cursor->request_level_.load();
+      cursor->fill_loop_ = cursor->request_loop_.load();
+    }
+
+    // Skip ahead if playback got past the ring, e.g. after an underrun.
+    if (cursor->fill_index_ + kBlockSize <= play_position)
+      cursor->fill_index_ = play_position;
+
+    int64_t level_length = (length_ + (1LL << cursor->fill_level_) - 1) >> cursor->fill_level_;
+    int64_t write = cursor->write_count_.load(std::memory_order_relaxed);
+    while (write - cursor->read_count_.load(std::memory_order_acquire) < kNumBlocks) {
+      if (generation != cursor->generation_.load() || (!cursor->fill_loop_ && cursor->fill_index_ >= level_length))
+        return playing;
+
+      Block& block = cursor->blocks_[write % kNumBlocks];
+      block.start = cursor->fill_index_;
+      block.generation = generation;
+      render(cursor->fill_level_, block.start - kBlockPadding, kBlockSize + 2 * kBlockPadding, cursor->fill_loop_,
+             block.left, stereo_ ? block.right : nullptr);
+
+      // Don't publish a block the seek during rendering already made stale.
+      if (generation != cursor->generation_.load(std::memory_order_acquire))
+        return playing;
+
+      cursor->write_count_.store(++write, std::memory_order_release);
+      cursor->fill_index_ += kBlockSize;
+    }
+    return playing;
+  }
+
+  bool SampleStream::fillCursors() {
+    bool playing = false;
+    for (int i = 0; i < kMaxCursors; ++i) {
+      if (cursors_[i].claimed_.load())
+        playing = fillCursor(&cursors_[i]) || playing;
+    }
+    return playing;
+  }
+
+  void SampleStream::render(int level, int64_t start, int num_samples, bool loop,
+                            mono_float* left, mono_float* right) {
+    if (level == 0) {
+      readSource(start, num_samples, loop, left, right);
+      return;
+    }
+
+    // Same filter as the in memory levels, with enough context read around the block that edges are exact.
+    int radius = SampleSource::kNumDownsampleTaps / 2;
+    int source_samples = 2 * num_samples + 2 * radius;
+    std::unique_ptr<mono_float[]> source_left = std::make_unique<mono_float[]>(source_samples);
+    std::unique_ptr<mono_float[]> source_right;
+    if (right)
+      source_right = std::make_unique<mono_float[]>(source_samples);
+
+    render(level - 1, 2 * start - radius, source_samples, loop, source_left.get(), source_right.get());
+    for (int i = 0; i < num_samples; ++i)
+      left[i] = getFilteredSample(source_left.get(), 2 * i + radius, source_samples);
+    if (right) {
+      for (int i = 0; i < num_samples; ++i)
+        right[i] = getFilteredSample(source_right.get(), 2 * i + radius, source_samples);
+    }
+  }
+
+  void SampleStream::readSource(int64_t start, int num_samples, bool loop, mono_float* left, mono_float* right) {
+    // Cursors fill on the stream thread and, without background loading, on the audio thread too.
+    std::lock_guard<std::mutex> lock(read_mutex_);
+    if (!loop || length_ <= 0) {
+      reader_->read(left, right, start, num_samples);
+      return;
+    }
+
+    int done = 0;
+    while (done < num_samples) {
+      int64_t position = ((start + done) % length_ + length_) % length_;
+      int samples = static_cast<int>(std::min<int64_t>(num_samples - done, length_ - position));
+      reader_->read(left + done, right ? right + done : nullptr, position, samples);
+      done += samples;
+    }
+  }
+
+  std::atomic<bool> Sample::background_loading_(true);
+
+  Sample::SampleData::SampleData(int l, int sr, bool s) : length(l), sample_rate(sr), stereo(s) {
+    level_sizes.resize(kUpsampleTimes + 1);
+    for (int i = 0; i <= kUpsampleTimes; ++i)
+      level_sizes[i] = length * (1 << (kUpsampleTimes - i));
+
+    int current_size = length;
+    while (current_size >= kMinSize) {
+      current_size = (current_size + 1) / 2;
+      level_sizes.push_back(current_size);
+    }
+
+    num_levels = static_cast<int>(level_sizes.size());
+    left_buffers.resize(num_levels);
+    left_loop_buffers.resize(num_levels);
+    right_buffers.resize(num_levels);
+    right_loop_buffers.resize(num_levels);
+    ready_levels = std::make_unique<std::atomic<bool>[]>(num_levels);
+    requested_levels = std::make_unique<std::atomic<bool>[]>(num_levels);
+    for (int i = 0; i < num_levels; ++i) {
+      ready_levels[i] = false;
+      requested_levels[i] = false;
+    }
+  }
+
+  void Sample::SampleData::createOriginalLevel(const mono_float* left_buffer, const mono_float* right_buffer) {
+    createOriginalBuffers(left_buffers[kUpsampleTimes], left_loop_buffers[kUpsampleTimes], left_buffer, length);
+    if (stereo) {
+      createOriginalBuffers(right_buffers[kUpsampleTimes], right_loop_buffers[kUpsampleTimes],
+                            right_buffer, length);
+    }
+    ready_levels[kUpsampleTimes].store(true, std::memory_order_release);
+  }
+
+  void Sample::SampleData::buildLevel(int index) {
+    std::lock_guard<std::mutex> lock(build_mutex);
+
+    // Each level is filtered from its neighbor closer to the original so build outward from there.
+    int direction = index < kUpsampleTimes ? -1 : 1;
+    for (int i = kUpsampleTimes + direction; i * direction <= index * direction; i += direction) {
+      if (isLevelReady(i))
+        continue;
+
+      createLevel(left_buffers, left_loop_buffers, level_sizes, i);
+      if (stereo)
+        createLevel(right_buffers, right_loop_buffers, level_sizes, i);
+      ready_levels[i].store(true, std::memory_order_release);
+    }
+  }
+
+  void Sample::SampleData::buildRequestedLevels() {
+    for (int i = 0; i < num_levels; ++i) {
+      if (requested_levels[i].load() && !isLevelReady(i))
+        buildLevel(i);
+    }
+  }
+
+  int Sample::requestLevel(SampleData* data, int index) {
+    if (!background_loading_.load()) {
+      data->buildLevel(index);
+      return index;
+    }
+
+    if (!data->requested_levels[index].exchange(true))
+      SampleLevelBuilder::instance().requestBuild();
+
+    // Play the closest ready level until the requested one is built.
+    for (int i = index - 1; i > kUpsampleTimes; --i) {
+      if (data->isLevelReady(i))
+        return i;
+    }
+    return kUpsampleTimes;
   }
 
   Sample::Sample() : name_(kDefaultName), current_data_(nullptr), active_audio_data_(nullptr) {
@@ -273,24 +681,75 @@ namespace vital {
     VITAL_ASSERT(active_audio_data_.is_lock_free());
 
     size = std::min(size, kMaxSize);
-    std::unique_ptr<SampleData> old_data = std::move(data_);
-    data_ = std::make_unique<SampleData>(size, sample_rate, false);
-    createBandLimitedBuffers(data_->left_buffers, data_->left_loop_buffers, buffer, size);
+    AssetKey key = sampleKey(buffer, nullptr, size, sample_rate);
+    std::shared_ptr<SampleData> data = SampleCache::instance().find(key);
+    if (data == nullptr) {
+      data = std::make_shared<SampleData>(size, sample_rate, false);
+      data->createOriginalLevel(buffer, nullptr);
+      data = SampleCache::instance().insert(key, data);
+    }
+
+    loadData(data);
+  }
+
+  void Sample::loadSample(const mono_float* left_buffer, const mono_float* right_buffer, int size, int sample_rate) {
+    AssetKey key = sampleKey(left_buffer, right_buffer, size, sample_rate);
+    std::shared_ptr<SampleData> data = SampleCache::instance().find(key);
+    if (data == nullptr) {
+      data = std::make_shared<SampleData>(size, sample_rate, true);
+      data->createOriginalLevel(left_buffer, right_buffer);
+      data = SampleCache::instance().insert(key, data);
+    }
+
+    loadData(data);
+  }
+
+  void Sample::loadStream(std::unique_ptr<SampleStream::Reader> reader, const std::string& path) {
+    std::shared_ptr<SampleStream> stream = std::make_shared<SampleStream>(std::move(reader), path);
+
+    // The start of the audio stays in memory so notes starting there play before the stream thread catches up.
+    int head_length = static_cast<int>(std::min<int64_t>(stream->length(), SampleStream::kHeadSamples));
+    head_length = std::max(head_length, static_cast<int>(kMinSize));
+    std::unique_ptr<mono_float[]> left = std::make_unique<mono_float[]>(head_length);
+    std::unique_ptr<mono_float[]> right;
+    if (stream->stereo())
+      right = std::make_unique<mono_float[]>(head_length);
+    stream->readHead(left.get(), right.get(), head_length);
+    stream->setHeadLength(head_length);
+
+    std::shared_ptr<SampleData> data = std::make_shared<SampleData>(head_length, stream->sampleRate(), stream->stereo());
+    data->createOriginalLevel(left.get(), right.get());
+    data->buildLevel(std::min(kUpsampleTimes + SampleStream::kNumLevels, data->num_levels) - 1);
+    data->stream = stream;
+
+    // Without background loading the audio thread fills its own cursors.
+    if (backgroundLoading())
+      SampleStream::startStreaming(stream);
+    loadData(data);
+  }
+
+  void Sample::loadData(std::shared_ptr<SampleData> data) {
+    SampleLevelBuilder::instance(); // Start the builder here instead of on the audio thread.
+
+    // Sample data is never edited in place so instances loading the same audio share it.
+    std::shared_ptr<SampleData> old_data = std::move(data_);
+    data_ = std::move(data);
 
     current_data_ = data_.get();
     while (active_audio_data_.load())
       std::this_thread::yield(); // Wait for audio thread to finish using old_data.
   }
 
-  void Sample::loadSample(const mono_float* left_buffer, const mono_float* right_buffer, int size, int sample_rate) {
-    std::unique_ptr<SampleData> old_data = std::move(data_);
-    data_ = std::make_unique<SampleData>(size, sample_rate, true);
-    createBandLimitedBuffers(data_->left_buffers, data_->left_loop_buffers, left_buffer, size);
-    createBandLimitedBuffers(data_->right_buffers, data_->right_loop_buffers, right_buffer, size);
+  void Sample::swapData(Sample* other) {
+    VITAL_ASSERT(other->active_audio_data_.load() == nullptr);
 
+    data_.swap(other->data_);
     current_data_ = data_.get();
+    other->current_data_ = other->data_.get();
+    name_.swap(other->name_);
+
     while (active_audio_data_.load())
-      std::this_thread::yield(); // Wait for audio thread to finish using old_data.
+      std::this_thread::yield(); // Wait for audio thread to finish using old data before handing it off.
   }
 
   void Sample::init() {
@@ -307,6 +766,13 @@ namespace vital {
   json Sample::stateToJson() {
     json data;
     data["name"] = name_;
+    if (data_->stream) {
+      data["stream_file"] = data_->stream->getPath();
+      data["length"] = data_->stream->length();
+      data["sample_rate"] = data_->stream->sampleRate();
+      return data;
+    }
+
     data["length"] = data_->length;
     data["sample_rate"] = data_->sample_rate;
     std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(data_->length);
@@ -326,26 +792,23 @@ namespace vital {
     if (data.count("name"))
       name_ = data["name"].get<std::string>();
 
+    // Streamed audio is opened by whoever knows how to read files, without it there's nothing to play.
+    if (data.count("samples") == 0) {
+      std::string name = name_;
+      init();
+      name_ = name;
+      return;
+    }
+
     int length = data["length"];
     int sample_rate = data["sample_rate"];
 
-    MemoryOutputStream decoded(length * sizeof(int16_t));
-    std::string wave_data = data["samples"];
-    Base64::convertFromBase64(decoded, wave_data);
-    std::unique_ptr<int16_t[]> pcm_data = std::make_unique<int16_t[]>(length);
-    memcpy(pcm_data.get(), decoded.getData(), length * sizeof(int16_t));
     std::unique_ptr<mono_float[]> buffer = std::make_unique<mono_float[]>(length);
-    utils::pcmToFloatData(buffer.get(), pcm_data.get(), length);
+    readPcmField(data["samples"], buffer.get(), length);
 
     if (data.count("samples_stereo")) {
-      MemoryOutputStream decoded_stereo(length * sizeof(int16_t));
-      std::string wave_data_stereo = data["samples_stereo"];
-      Base64::convertFromBase64(decoded_stereo, wave_data_stereo);
-      std::unique_ptr<int16_t[]> pcm_data_stereo = std::make_unique<int16_t[]>(length);
-      memcpy(pcm_data_stereo.get(), decoded_stereo.getData(), length * sizeof(int16_t));
-
       std::unique_ptr<mono_float[]> buffer_stereo = std::make_unique<mono_float[]>(length);
-      utils::pcmToFloatData(buffer_stereo.get(), pcm_data_stereo.get(), length);
+      readPcmField(data["samples_stereo"], buffer_stereo.get(), length);
       loadSample(buffer.get(), buffer_stereo.get(), length, sample_rate);
     }
     else
@@ -363,9 +826,27 @@ namespace vital {
     phase_output_ = std::make_shared<cr::Output>();
   }
 
+  SampleSource::~SampleSource() {
+    SampleStream* stream = sample_->getStream();
+    if (stream == nullptr || stream->id() != stream_state_.stream_id)
+      return;
+
+    for (int i = 0; i < kNumStreamVoices; ++i) {
+      if (stream_state_.cursors[i])
+        stream->releaseCursor(stream_state_.cursors[i]);
+    }
+  }
+
   void SampleSource::process(int num_samples) {
     sample_->markUsed();
 
+    SampleStream* stream = sample_->getActiveStream();
+    if (stream) {
+      processStream(stream, num_samples);
+      sample_->markUnused();
+      return;
+    }
+
     poly_float current_pan_amplitude = pan_amplitude_;
     poly_float input_pan = utils::clamp(input(kPan)->at(0), -1.0f, 1.0f);
     pan_amplitude_ = futils::panAmplitude(input_pan);
@@ -483,6 +964,174 @@ namespace vital {
     if (reset_mask.anyMask())
       clearOutputBufferForReset(reset_mask, kReset, kRaw);
 
+    processLevelled(current_pan_amplitude, delta_pan_amplitude, num_samples);
+
+    sample_index_ = current_index;
+    sample_fraction_ = current_fraction;
+    poly_float phase = utils::maskLoad(sample_index_, poly_float(audio_length) - sample_index_, bounce_mask_);
+    phase = phase * (1.0f / audio_length);
+    phase_output_->buffer[0] = utils::encodePhaseAndVoice(phase, input(kNoteCount)->at(0));
+
+    sample_->markUnused();
+  }
+
+  void SampleSource::processStream(SampleStream* stream, int num_samples) {
+    static const mono_float kSilence[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    if (stream->id() != stream_state_.stream_id)
+      claimStreamCursors(stream);
+
+    poly_float current_pan_amplitude = pan_amplitude_;
+    poly_float input_pan = utils::clamp(input(kPan)->at(0), -1.0f, 1.0f);
+    pan_amplitude_ = futils::panAmplitude(input_pan);
+
+    poly_float input_midi = 0.0f;
+    if (input(kKeytrack)->at(0)[0])
+      input_midi = input(kMidi)->at(0) - kMidiTrackCenter;
+
+    int transpose_quantize = static_cast<int>(input(kTransposeQuantize)->at(0)[0]);
+    poly_float transpose = snapTranspose(input_midi, input(kTranspose)->at(0), transpose_quantize);
+    transpose = utils::clamp(transpose + input(kTune)->at(0), kMinTranspose, kMaxTranspose);
+
+    // Stream positions count frames of the original audio, there's no upsampled level.
+    mono_float sample_rate_ratio = (1.0f * stream->sampleRate()) / getSampleRate();
+    poly_float current_phase_inc = phase_inc_;
+    phase_inc_ = utils::centsToRatio(transpose * kCentsPerNote) * sample_rate_ratio;
+
+    poly_mask reset_mask = getResetMask(kReset);
+    poly_float reset_offset = utils::toFloat(input(kReset)->source->trigger_offset);
+    current_pan_amplitude = utils::maskLoad(current_pan_amplitude, pan_amplitude_, reset_mask);
+    current_phase_inc = utils::maskLoad(current_phase_inc, phase_inc_, reset_mask);
+    reset_offset *= current_phase_inc;
+
+    // Streams only read forward so bounce loops instead.
+    bool loop = input(kLoop)->at(0)[0] != 0.0f || input(kBounce)->at(0)[0] != 0.0f;
+    bool random_phase = input(kRandomPhase)->at(0)[0] != 0.0f;
+    double length = stream->length();
+
+    for (int v = 0; v < kNumStreamVoices; ++v) {
+      int lane = 2 * v;
+      bool reset = reset_mask[lane];
+      if (reset) {
+        double start = random_phase ? random_generator_.next() * length : 0.0;
+        stream_state_.positions[v] = start - reset_offset[lane];
+      }
+
+      int level = utils::iclamp(utils::ilog2(std::max<int>(phase_inc_[lane], 1)), 0, SampleStream::kNumLevels - 1);
+      if (reset || level != stream_state_.levels[v] || loop != stream_state_.loop[v])
+        seekStream(stream, v, level, loop);
+    }
+
+    mono_float sample_inc = 1.0f / num_samples;
+    poly_float delta_pan_amplitude = (pan_amplitude_ - current_pan_amplitude) * sample_inc;
+    poly_float delta_phase_inc = (phase_inc_ - current_phase_inc) * sample_inc;
+
+    bool underrun[kNumStreamVoices] = {};
+    poly_float* raw_output = output(kRaw)->buffer;
+    for (int i = 0; i < num_samples; ++i) {
+      current_phase_inc += delta_phase_inc;
+
+      const mono_float* audio_buffers[poly_float::kSize];
+      poly_float t = 0.0f;
+      for (int v = 0; v < kNumStreamVoices; ++v) {
+        double position = stream_state_.positions[v];
+        stream_state_.positions[v] = position + current_phase_inc[2 * v];
+        audio_buffers[2 * v] = kSilence;
+        audio_buffers[2 * v + 1] = kSilence;
+        SampleStream::Cursor* cursor = stream_state_.cursors[v];
+        if (cursor == nullptr || (!stream_state_.loop[v] && position >= length)) {
+          underrun[v] = underrun[v] || cursor == nullptr;
+          continue;
+        }
+
+        int level = stream_state_.levels[v];
+        double level_position = position * (1.0 / (1 << level));
+        double rounded_down = std::floor(level_position);
+        int64_t index = static_cast<int64_t>(rounded_down);
+        t.set(2 * v, level_position - rounded_down);
+        t.set(2 * v + 1, level_position - rounded_down);
+
+        if (position < length && index + 2 < stream->headEnd(level)) {
+          if (index > -Sample::kBufferSamples) {
+            int head_index = Sample::kBufferSamples + static_cast<int>(index) - 1;
+            audio_buffers[2 * v] = sample_->getActiveLeftBuffer(Sample::kUpsampleTimes + level) + head_index;
+            audio_buffers[2 * v + 1] = sample_->getActiveRightBuffer(Sample::kUpsampleTimes + level) + head_index;
+          }
+          continue;
+        }
+
+        const SampleStream::Block* block = cursor->findBlock(index);
+        if (block == nullptr && !Sample::backgroundLoading()) {
+          cursor->setPlayPosition(index);
+          stream->fillCursor(cursor);
+          block = cursor->findBlock(index);
+        }
+
+        if (block == nullptr) {
+          underrun[v] = true;
+          continue;
+        }
+
+        int block_index = static_cast<int>(index - block->start) + SampleStream::kBlockPadding - 1;
+        audio_buffers[2 * v] = block->left + block_index;
+        audio_buffers[2 * v + 1] = (stream->stereo() ? block->right : block->left) + block_index;
+      }
+
+      matrix interpolation_matrix = utils::getCatmullInterpolationMatrix(t);
+      matrix value_matrix = utils::getValueMatrix(audio_buffers, 0);
+      value_matrix.transpose();
+      raw_output[i] = interpolation_matrix.multiplyAndSumRows(value_matrix);
+      VITAL_ASSERT(utils::isContained(raw_output[i]));
+    }
+
+    if (reset_mask.anyMask())
+      clearOutputBufferForReset(reset_mask, kReset, kRaw);
+
+    processLevelled(current_pan_amplitude, delta_pan_amplitude, num_samples);
+
+    poly_float phase = 0.0f;
+    for (int v = 0; v < kNumStreamVoices; ++v) {
+      if (underrun[v])
+        stream->addUnderrun();
+
+      double position = std::max(0.0, stream_state_.positions[v]);
+      if (stream_state_.cursors[v])
+        stream_state_.cursors[v]->setPlayPosition(static_cast<int64_t>(position) >> stream_state_.levels[v]);
+
+      double voice_phase = stream_state_.loop[v] ? std::fmod(position, length) : std::min(position, length);
+      phase.set(2 * v, voice_phase / length);
+      phase.set(2 * v + 1, voice_phase / length);
+    }
+    phase_output_->buffer[0] = utils::encodePhaseAndVoice(phase, input(kNoteCount)->at(0));
+  }
+
+  void SampleSource::claimStreamCursors(SampleStream* stream) {
+    // Cursors of a previous stream went away with it, only claim new ones.
+    stream_state_.stream_id = stream->id();
+    for (int i = 0; i < kNumStreamVoices; ++i) {
+      stream_state_.cursors[i] = stream->claimCursor();
+      stream_state_.levels[i] = -1;
+    }
+  }
+
+  void SampleSource::seekStream(SampleStream* stream, int voice, int level, bool loop) {
+    stream_state_.levels[voice] = level;
+    stream_state_.loop[voice] = loop;
+    SampleStream::Cursor* cursor = stream_state_.cursors[voice];
+    if (cursor == nullptr)
+      return;
+
+    // Positions still in the head read from memory so the ring starts where the head ends.
+    double position = std::max(0.0, stream_state_.positions[voice]);
+    int64_t index = static_cast<int64_t>(position) >> level;
+    if (position < stream->length())
+      index = std::max(index, stream->headEnd(level));
+    cursor->seek(index, level, loop);
+  }
+
+  void SampleSource::processLevelled(poly_float current_pan_amplitude, poly_float delta_pan_amplitude,
+                                     int num_samples) {
+    const poly_float* raw_output = output(kRaw)->buffer;
     const poly_float* level_input = input(kLevel)->source->buffer;
     poly_float* levelled_output = output(kLevelled)->buffer;
     poly_float zero = 0.0f;
@@ -492,14 +1141,6 @@ namespace vital {
       poly_float level = utils::clamp(level_input[i], zero, max);
       levelled_output[i] = current_pan_amplitude * level * level * raw_output[i];
     }
-
-    sample_index_ = current_index;
-    sample_fraction_ = current_fraction;
-    poly_float phase = utils::maskLoad(sample_index_, poly_float(audio_length) - sample_index_, bounce_mask_);
-    phase = phase * (1.0f / audio_length);
-    phase_output_->buffer[0] = utils::encodePhaseAndVoice(phase, input(kNoteCount)->at(0));
-
-    sample_->markUnused();
   }
 
   force_inline poly_float SampleSource::snapTranspose(poly_float input_midi, poly_float transpose, int quantize) {
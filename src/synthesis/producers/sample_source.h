@@ -20,10 +20,120 @@
 #include "json/json.h"
 #include "utils.h"
 
+#include <mutex>
+
 using json = nlohmann::json;
 
 namespace vital {
 
+  // Plays audio too long to keep in memory, e.g. a file on disk. A shared stream thread reads and band limits
+  // blocks ahead of every playing voice into a lock free ring, so the audio thread only copies ready memory.
+  class SampleStream {
+    public:
+      static constexpr int kBlockSize = 1024;
+      static constexpr int kNumBlocks = 16;
+      static constexpr int kBlockPadding = 2;
+      static constexpr int kNumLevels = 5;
+      static constexpr int kHeadSamples = 1 << 15;
+      static constexpr int kMaxCursors = 40;
+
+      class Reader {
+        public:
+          virtual ~Reader() = default;
+
+          virtual int64_t length() const = 0;
+          virtual int sampleRate() const = 0;
+          virtual bool stereo() const = 0;
+
+          // Reads num_samples frames from start. Frames outside of the audio read as zero and right is null for
+          // mono audio. Only ever called from one thread at a time.
+          virtual void read(mono_float* left, mono_float* right, int64_t start, int num_samples) = 0;
+      };
+
+      struct Block {
+        int64_t start;
+        int generation;
+        mono_float left[kBlockSize + 2 * kBlockPadding];
+        mono_float right[kBlockSize + 2 * kBlockPadding];
+      };
+
+      // Blocks ahead of one voice at one band limited level. The audio thread consumes and seeks, the stream
+      // thread produces. Every seek starts a new generation and blocks from older generations are skipped.
+      class Cursor {
+        public:
+          Cursor();
+
+          void seek(int64_t index, int level, bool loop);
+          const Block* findBlock(int64_t index);
+          void setPlayPosition(int64_t index) { play_position_.store(index); }
+
+        private:
+          friend class SampleStream;
+
+          SampleStream* stream_;
+          std::atomic<bool> claimed_;
+          std::atomic<int> generation_;
+          std::atomic<int64_t> request_index_;
+          std::atomic<int> request_level_;
+          std::atomic<bool> request_loop_;
+          std::atomic<int64_t> play_position_;
+          std::atomic<int64_t> read_count_;
+          std::atomic<int64_t> write_count_;
+          std::unique_ptr<Block[]> blocks_;
+
+          std::mutex fill_mutex_;
+          int fill_generation_;
+          int fill_level_;
+          bool fill_loop_;
+          int64_t fill_index_;
+          int64_t fill_play_position_;
+
+          JUCE_DECLARE_NON_COPYABLE(Cursor)
+      };
+
+      static void startStreaming(std::shared_ptr<SampleStream> stream);
+
+      SampleStream(std::unique_ptr<Reader> reader, const std::string& path);
+
+      int64_t length() const { return length_; }
+      int sampleRate() const { return sample_rate_; }
+      bool stereo() const { return stereo_; }
+      int id() const { return id_; }
+      std::string getPath() const { return path_; }
+
+      void setHeadLength(int head_length);
+      int64_t headEnd(int level) const { return head_ends_[level]; }
+      void readHead(mono_float* left, mono_float* right, int head_length);
+
+      Cursor* claimCursor();
+      void releaseCursor(Cursor* cursor) { cursor->claimed_.store(false); }
+      // Both return whether a cursor is still playing and needs the stream thread to keep polling.
+      bool fillCursor(Cursor* cursor);
+      bool fillCursors();
+
+      int underruns() const { return underruns_.load(); }
+      void addUnderrun() { underruns_++; }
+
+    private:
+      void wakeStreaming();
+      void render(int level, int64_t start, int num_samples, bool loop, mono_float* left, mono_float* right);
+      void readSource(int64_t start, int num_samples, bool loop, mono_float* left, mono_float* right);
+
+      std::unique_ptr<Reader> reader_;
+      std::mutex read_mutex_;
+      std::string path_;
+      int64_t length_;
+      int sample_rate_;
+      bool stereo_;
+      int id_;
+      int64_t head_ends_[kNumLevels];
+      std::atomic<int> underruns_;
+      std::atomic<bool> streaming_;
+      std::unique_ptr<Cursor[]> cursors_;
+
+      JUCE_LEAK_DETECTOR(SampleStream)
+  };
+
   class Sample {
     public:
       static constexpr int kDefaultSampleLength = 44100;
@@ -31,24 +141,45 @@ namespace vital {
       static constexpr int kBufferSamples = 4;
       static constexpr int kMinSize = 4;
 
+      // Band limited copies of the audio, one level per octave of playback speed. Only the original level is
+      // created on load, the others are built the first time playback needs them.
       struct SampleData {
-        SampleData(int l, int sr, bool s) : length(l), sample_rate(sr), stereo(s) { }
-        
+        SampleData(int l, int sr, bool s);
+
+        force_inline bool isLevelReady(int index) const {
+          return ready_levels[index].load(std::memory_order_acquire);
+        }
+
+        void createOriginalLevel(const mono_float* left_buffer, const mono_float* right_buffer);
+        void buildLevel(int index);
+        void buildRequestedLevels();
+
         int length;
         int sample_rate;
         bool stereo;
+        int num_levels;
+        std::vector<int> level_sizes;
         std::vector<std::unique_ptr<mono_float[]>> left_buffers;
         std::vector<std::unique_ptr<mono_float[]>> left_loop_buffers;
         std::vector<std::unique_ptr<mono_float[]>> right_buffers;
         std::vector<std::unique_ptr<mono_float[]>> right_loop_buffers;
+        std::unique_ptr<std::atomic<bool>[]> ready_levels;
+        std::unique_ptr<std::atomic<bool>[]> requested_levels;
+        std::mutex build_mutex;
+        std::shared_ptr<SampleStream> stream;
 
         JUCE_LEAK_DETECTOR(SampleData)
       };
+
+      static void setBackgroundLoading(bool background) { background_loading_ = background; }
+      static bool backgroundLoading() { return background_loading_.load(); }
     
       Sample();
 
       void loadSample(const mono_float* buffer, int size, int sample_rate);
       void loadSample(const mono_float* left_buffer, const mono_float* right_buffer, int size, int sample_rate);
+      void loadStream(std::unique_ptr<SampleStream::Reader> reader, const std::string& path);
+      void swapData(Sample* other);
       void setName(const std::string& name) { name_ = name; }
       std::string getName() const { return name_; }
       void setLastBrowsedFile(const std::string& path) { last_browsed_file_ = path; }
@@ -58,6 +189,9 @@ namespace vital {
       force_inline int upsampleLength() { return originalLength() * (1 << kUpsampleTimes); }
       force_inline int sampleRate() const { return current_data_->sample_rate; }
 
+      SampleStream* getStream() const { return current_data_->stream.get(); }
+      force_inline SampleStream* getActiveStream() const { return active_audio_data_.load()->stream.get(); }
+
       force_inline int activeLength() const { return active_audio_data_.load()->length * (1 << kUpsampleTimes); }
       force_inline int activeSampleRate() const { return active_audio_data_.load()->sample_rate; }
 
@@ -65,8 +199,12 @@ namespace vital {
       void init();
 
       int getActiveIndex(mono_float delta) {
+        SampleData* data = active_audio_data_.load();
         int octaves = utils::ilog2(std::max<int>(delta, 1));
-        return std::min(octaves, (int)active_audio_data_.load()->left_buffers.size() - 1);
+        int index = std::min(octaves, data->num_levels - 1);
+        if (data->isLevelReady(index))
+          return index;
+        return requestLevel(data, index);
       }
 
       force_inline const mono_float* getActiveLeftBuffer(int index) {
@@ -104,11 +242,16 @@ namespace vital {
       void jsonToState(json data);
 
     protected:
+      static int requestLevel(SampleData* data, int index);
+      static std::atomic<bool> background_loading_;
+
+      void loadData(std::shared_ptr<SampleData> data);
+
       std::string name_;
       std::string last_browsed_file_;
       SampleData* current_data_;
       std::atomic<SampleData*> active_audio_data_;
-      std::unique_ptr<SampleData> data_;
+      std::shared_ptr<SampleData> data_;
 
       JUCE_LEAK_DETECTOR(Sample)
   };
@@ -145,6 +288,7 @@ namespace vital {
       };
 
       SampleSource();
+      virtual ~SampleSource();
 
       virtual void process(int num_samples) override;
       virtual Processor* clone() const override { return new SampleSource(*this); }
@@ -152,6 +296,31 @@ namespace vital {
       force_inline Output* getPhaseOutput() const { return phase_output_.get(); }
 
     private:
+      static constexpr int kNumStreamVoices = poly_float::kSize / 2;
+
+      // Stream playback position of each voice. Copies start without cursors so every voice clone claims its own.
+      struct StreamState {
+        StreamState() : stream_id(0) {
+          for (int i = 0; i < kNumStreamVoices; ++i) {
+            cursors[i] = nullptr;
+            positions[i] = 0.0;
+            levels[i] = -1;
+            loop[i] = false;
+          }
+        }
+        StreamState(const StreamState& other) : StreamState() { }
+
+        int stream_id;
+        SampleStream::Cursor* cursors[kNumStreamVoices];
+        double positions[kNumStreamVoices];
+        int levels[kNumStreamVoices];
+        bool loop[kNumStreamVoices];
+      };
+
+      void processStream(SampleStream* stream, int num_samples);
+      void claimStreamCursors(SampleStream* stream);
+      void seekStream(SampleStream* stream, int voice, int level, bool loop);
+      void processLevelled(poly_float current_pan_amplitude, poly_float delta_pan_amplitude, int num_samples);
       poly_float snapTranspose(poly_float input_midi, poly_float transpose, int quantize);
 
       poly_float pan_amplitude_;
@@ -165,6 +334,7 @@ namespace vital {
       utils::RandomGenerator random_generator_;
 
       std::shared_ptr<Sample> sample_;
+      StreamState stream_state_;
 
       JUCE_LEAK_DETECTOR(SampleSource)
   };
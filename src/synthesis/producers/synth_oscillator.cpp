@@ -534,7 +534,7 @@ namespace vital {
       Processor(kNumInputs, kNumOutputs), random_generator_(-1.0f, 1.0f),
       transpose_quantize_(0), last_quantized_transpose_(0.0f), last_quantize_ratio_(1.0f),
       unison_(1), active_oscillators_(2), wavetable_(wavetable), wavetable_version_(wavetable->getVersion()),
-      first_mod_oscillator_(nullptr), second_mod_oscillator_(nullptr), sample_(nullptr),
+      first_mod_oscillator_(nullptr), second_mod_oscillator_(nullptr), sample_(nullptr), num_spectral_frames_(0),
       fourier_frames1_(), fourier_frames2_() {
     pan_amplitude_ = 0.0f;
     center_amplitude_ = 0.0f;
@@ -790,9 +790,21 @@ namespace vital {
       int last_harmonic = std::max<int>(0, WaveFrame::kWaveformSize * futils::exp2(-bin_shift));
       last_harmonic = std::min(last_harmonic, WaveFrame::kWaveformSize / 2);
 
-      spectralMorph(wavetable_data, table_index, fourier_buffer,
-                    fourier_transform_.get(), shift, last_harmonic, RandomValues::instance()->buffer());
-      wave_buffers_[buffer_index] = ((mono_float*)fourier_buffer) + poly_float::kSize - 1;
+      const mono_float* cached_buffer = nullptr;
+      for (int f = 0; f < num_spectral_frames_ && cached_buffer == nullptr; ++f) {
+        const SpectralFrame& frame = spectral_frames_[f];
+        if (frame.wave_index == table_index && frame.last_harmonic == last_harmonic && frame.shift == shift)
+          cached_buffer = frame.buffer;
+      }
+
+      if (cached_buffer)
+        wave_buffers_[buffer_index] = cached_buffer;
+      else {
+        spectralMorph(wavetable_data, table_index, fourier_buffer,
+                      fourier_transform_.get(), shift, last_harmonic, RandomValues::instance()->buffer());
+        wave_buffers_[buffer_index] = ((mono_float*)fourier_buffer) + poly_float::kSize - 1;
+        spectral_frames_[num_spectral_frames_++] = { table_index, last_harmonic, shift, wave_buffers_[buffer_index] };
+      }
 
       if (i == index && morph_amount[i] == morph_amount[i + 1] && wave_index[i] == wave_index[i + 1]) {
         last_buffers_[buffer_index + 1] = wave_buffers_[buffer_index + 1];
@@ -818,6 +830,10 @@ namespace vital {
       distortion_mult = kMaxSync;
     }
 
+    // Frames morphed in this update are shared between unison pairs that request the same frame.
+    // Each buffer still double buffers its own frames so earlier frames stay valid while in use.
+    num_spectral_frames_ = 0;
+
     SpectralMorph spectral_morph = static_cast<SpectralMorph>((int)input(kSpectralMorphType)->at(0)[0]);
     poly_mask spectral_unison_mask = poly_float::notEqual(input(kSpectralUnison)->at(0), 0.0f);
     poly_mask spectral_morph_mask = poly_float::notEqual(spectral_morph_values_[0], spectral_morph_values_[1]);
@@ -194,6 +194,13 @@ namespace vital {
         const mono_float* to_buffers[poly_float::kSize];
       };
 
+      struct SpectralFrame {
+        int wave_index;
+        int last_harmonic;
+        float shift;
+        const mono_float* buffer;
+      };
+
       static void setDistortionValues(DistortionType distortion_type, poly_float* values, int num_values, bool spread);
       static void setSpectralMorphValues(SpectralMorph spectral_morph,
                                          poly_float* values, int num_values, bool spread);
@@ -309,6 +316,8 @@ namespace vital {
       Output* second_mod_oscillator_;
       Output* sample_;
     
+      SpectralFrame spectral_frames_[kNumBuffers];
+      int num_spectral_frames_;
       poly_float fourier_frames1_[kNumBuffers + 1][kSpectralBufferSize];
       poly_float fourier_frames2_[kNumBuffers + 1][kSpectralBufferSize];
       std::shared_ptr<FourierTransform> fourier_transform_;
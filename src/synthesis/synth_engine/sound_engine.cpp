@@ -22,6 +22,7 @@
 #include "decimator.h"
 #include "modulation_connection_processor.h"
 #include "synth_constants.h"
+#include "synth_parameters.h"
 #include "synth_voice_handler.h"
 #include "peak_meter.h"
 #include "operators.h"
@@ -32,7 +33,8 @@ namespace vital {
 
   SoundEngine::SoundEngine() : SynthModule(0, 1), voice_handler_(nullptr), effect_chain_(nullptr),
                                output_total_(nullptr), last_oversampling_amount_(-1), last_sample_rate_(-1),
-                               oversampling_(nullptr), legato_(nullptr), decimator_(nullptr), peak_meter_(nullptr) {
+                               oversampling_(nullptr), legato_(nullptr), decimator_(nullptr),
+                               direct_decimator_(nullptr), peak_meter_(nullptr) {
     SoundEngine::init();
     bps_ = data_->controls["beats_per_minute"];
     modulation_processors_.reserve(kMaxModulationConnections);
@@ -72,11 +74,15 @@ namespace vital {
     createBaseControl("pitch_wheel");
     createBaseControl("mod_wheel");
 
+    decimator_ = new Decimator(kMaxOversampleStages);
+    decimator_->plug(voice_handler_);
+    addProcessor(decimator_);
+
     Value* effect_chain_order = createBaseControl("effect_chain_order");
     effect_chain_ = new ReorderableEffectChain(beats_per_second, voice_handler_->midi_offset_output());
     addSubmodule(effect_chain_);
     addProcessor(effect_chain_);
-    effect_chain_->plug(voice_handler_, ReorderableEffectChain::kAudio);
+    effect_chain_->plug(decimator_, ReorderableEffectChain::kAudio);
     effect_chain_->plug(effect_chain_order, ReorderableEffectChain::kOrder);
 
     SynthModule* compressor = effect_chain_->getEffect(constants::kCompressor);
@@ -97,17 +103,17 @@ namespace vital {
     SynthModule* flanger = effect_chain_->getEffect(constants::kFlanger);
     createStatusOutput("flanger_delay_frequency", flanger->output(FlangerModule::kFrequencyOutput));
 
+    direct_decimator_ = new Decimator(kMaxOversampleStages);
+    direct_decimator_->plug(voice_handler_->getDirectOutput());
+    addProcessor(direct_decimator_);
+
     output_total_ = new Add();
     output_total_->plug(effect_chain_, 0);
-    output_total_->plug(voice_handler_->getDirectOutput(), 1);
+    output_total_->plug(direct_decimator_, 1);
     addProcessor(output_total_);
 
-    decimator_ = new Decimator(3);
-    decimator_->plug(output_total_);
-    addProcessor(decimator_);
-
     StereoEncoder* decoder = new StereoEncoder(true);
-    decoder->plug(decimator_, StereoEncoder::kAudio);
+    decoder->plug(output_total_, StereoEncoder::kAudio);
     decoder->plug(stereo_routing, StereoEncoder::kEncodingValue);
     decoder->plug(stereo_mode, StereoEncoder::kMode);
     addProcessor(decoder);
@@ -132,7 +138,10 @@ namespace vital {
     clamp->useOutput(output());
 
     SynthModule::init();
+    attachTelemetry();
+    createControlList();
     disableUnnecessaryModSources();
+    fuseOperatorChains();
     setOversamplingAmount(kDefaultOversamplingAmount, kDefaultSampleRate);
   }
 
@@ -145,6 +154,7 @@ namespace vital {
     bool polyphonic = change.source->owner->isPolyphonic() && change.poly_destination;
     change.modulation_processor->setPolyphonicModulation(polyphonic);
     voice_handler_->enableModulationConnection(change.modulation_processor);
+    swapVoiceCopies(change, polyphonic);
     if (polyphonic) {
       destination = change.poly_destination;
       voice_handler_->setActiveNonaccumulatedOutput(change.poly_destination->output());
@@ -167,6 +177,27 @@ namespace vital {
     modulation_processors_.push_back(change.modulation_processor);
   }
 
+  void SoundEngine::prepareVoiceCopies(const modulation_change& change) {
+    if (change.voice_copies == nullptr)
+      return;
+
+    if (change.disconnecting)
+      voice_handler_->reserveVoiceCopies(change.voice_copies->processors);
+    else
+      voice_handler_->createVoiceCopies(change.modulation_processor, change.voice_copies->processors);
+  }
+
+  void SoundEngine::swapVoiceCopies(const modulation_change& change, bool polyphonic) {
+    if (change.voice_copies == nullptr)
+      return;
+
+    for (std::unique_ptr<Processor>& copy : change.voice_copies->processors) {
+      if (copy)
+        static_cast<ModulationConnectionProcessor*>(copy.get())->setPolyphonicModulation(polyphonic);
+    }
+    voice_handler_->swapVoiceCopies(change.modulation_processor, change.voice_copies->processors);
+  }
+
   int SoundEngine::getNumPressedNotes() {
     return voice_handler_->getNumPressedNotes();
   }
@@ -180,6 +211,7 @@ namespace vital {
 
     destination->unplug(change.modulation_processor);
     voice_handler_->disableModulationConnection(change.modulation_processor);
+    swapVoiceCopies(change, false);
 
     if (change.mono_destination->connectedInputs() == 1 &&
         (change.poly_destination == nullptr || change.poly_destination->connectedInputs() == 0)) {
@@ -207,6 +239,10 @@ namespace vital {
     return voice_handler_->getModulationBank();
   }
 
+  ProcessorRouter* SoundEngine::getVoiceRouter() {
+    return voice_handler_->getPolyRouter();
+  }
+
   mono_float SoundEngine::getLastActiveNote() const {
     return voice_handler_->getLastActiveNote();
   }
@@ -234,7 +270,6 @@ namespace vital {
     }
     voice_handler_->setOversampleAmount(oversample);
     effect_chain_->setOversampleAmount(oversample);
-    output_total_->setOversampleAmount(oversample);
     last_oversampling_amount_ = oversampling_amount;
     last_sample_rate_ = sample_rate;
   }
@@ -250,12 +285,32 @@ namespace vital {
       CircularQueue<ModulationConnectionProcessor*>& connections = voice_handler_->enabledModulationConnection();
       for (ModulationConnectionProcessor* modulation : connections) {
         if (!modulation->isInputSourcePolyphonic())
-          modulation->process(num_samples);
+          modulation->process(num_samples * modulation->getOversampleAmount());
       }
     }
 
-    for (auto& status_source : data_->status_outputs)
-      status_source.second->update();
+    for (StatusOutput* status_source : data_->status_output_list)
+      status_source->update();
+
+    telemetry_->publish();
+  }
+
+  void SoundEngine::createControlList() {
+    control_list_.assign(Parameters::getNumParameters(), nullptr);
+    for (auto& control : getControls()) {
+      int id = Parameters::getId(control.first);
+      if (id >= 0)
+        control_list_[id] = control.second;
+    }
+  }
+
+  void SoundEngine::attachTelemetry() {
+    std::vector<StatusOutput*> status_outputs;
+    collectStatusOutputs(status_outputs);
+
+    telemetry_ = std::make_unique<TelemetryBus>(static_cast<int>(status_outputs.size()));
+    for (int i = 0; i < status_outputs.size(); ++i)
+      status_outputs[i]->attach(telemetry_.get(), i);
   }
 
   void SoundEngine::correctToTime(double seconds) {
@@ -267,6 +322,7 @@ namespace vital {
     voice_handler_->allSoundsOff();
     effect_chain_->hardReset();
     decimator_->hardReset();
+    direct_decimator_->hardReset();
   }
 
   void SoundEngine::allNotesOff(int sample) {
@@ -321,7 +377,7 @@ namespace vital {
     return getModulationSource(source)->owner->enabled();
   }
 
-  const StereoMemory* SoundEngine::getEqualizerMemory() {
+  AudioCapture* SoundEngine::getEqualizerMemory() {
     return effect_chain_->getEqualizerMemory();
   }
 
@@ -24,11 +24,11 @@ class LineGenerator;
 class Tuning;
 
 namespace vital {
+  class AudioCapture;
   class Decimator;
   class PeakMeter;
   class Sample;
   class ReorderableEffectChain;
-  class StereoMemory;
   class SynthVoiceHandler;
   class SynthLfo;
   class Value;
@@ -51,8 +51,12 @@ namespace vital {
       int getNumPressedNotes();
       void connectModulation(const modulation_change& change);
       void disconnectModulation(const modulation_change& change);
+
+      // Builds the voice copies _change_ hands to or takes from the voices. Call off the audio thread.
+      void prepareVoiceCopies(const modulation_change& change);
       int getNumActiveVoices();
       ModulationConnectionBank& getModulationBank();
+      ProcessorRouter* getVoiceRouter();
       mono_float getLastActiveNote() const;
 
       void setTuning(const Tuning* tuning);
@@ -72,7 +76,7 @@ namespace vital {
       void enableModSource(const std::string& source);
       void disableModSource(const std::string& source);
       bool isModSourceEnabled(const std::string& source);
-      const StereoMemory* getEqualizerMemory();
+      AudioCapture* getEqualizerMemory();
 
       void setBpm(mono_float bpm);
       void setAftertouch(mono_float note, mono_float value, int sample, int channel);
@@ -94,15 +98,27 @@ namespace vital {
       void sostenutoOnRange(int from_channel, int to_channel);
       void sostenutoOffRange(int sample, int from_channel, int to_channel);
       force_inline int getOversamplingAmount() const { return last_oversampling_amount_; }
+      TelemetryBus* getTelemetry() { return telemetry_.get(); }
+
+      // Controls by parameter id, null for parameters the engine doesn't have.
+      force_inline Value* getControl(int id) const {
+        VITAL_ASSERT(id >= 0 && id < control_list_.size());
+        return control_list_[id];
+      }
 
       void checkOversampling();
 
     private:
       void setOversamplingAmount(int oversampling_amount, int sample_rate);
+      void swapVoiceCopies(const modulation_change& change, bool polyphonic);
+      void attachTelemetry();
+      void createControlList();
     
       SynthVoiceHandler* voice_handler_;
       ReorderableEffectChain* effect_chain_;
       Add* output_total_;
+      std::unique_ptr<TelemetryBus> telemetry_;
+      std::vector<Value*> control_list_;
 
       int last_oversampling_amount_;
       int last_sample_rate_;
@@ -110,6 +126,7 @@ namespace vital {
       Value* bps_;
       Value* legato_;
       Decimator* decimator_;
+      Decimator* direct_decimator_;
       PeakMeter* peak_meter_;
 
       CircularQueue<Processor*> modulation_processors_;
@@ -25,6 +25,8 @@
 #include "synth_gui_interface.cpp"
 #include "synth_parameters.cpp"
 #include "load_save.cpp"
+#include "preset_index.cpp"
+#include "binary_preset.cpp"
 #include "synth_types.cpp"
 #include "synth_base.cpp"
 #include "wavetable_component_factory.cpp"
@@ -35,6 +37,7 @@
 #include "wave_fold_modifier.cpp"
 #include "phase_modifier.cpp"
 #include "wavetable_creator.cpp"
+#include "wavetable_cache.cpp"
 #include "wave_line_source.cpp"
 #include "wave_source.cpp"
 #include "wavetable_group.cpp"
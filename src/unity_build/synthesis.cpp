@@ -28,6 +28,7 @@
 #include "formant_manager.cpp"
 #include "dirty_filter.cpp"
 #include "iir_halfband_decimator.cpp"
+#include "iir_halfband_interpolator.cpp"
 #include "sallen_key_filter.cpp"
 #include "phaser_filter.cpp"
 #include "ladder_filter.cpp"
@@ -40,6 +40,7 @@ namespace {
     change.poly_modulation_switch = engine->getPolyModulationSwitch(connection->destination_name);
     change.poly_destination = engine->getPolyModulationDestination(connection->destination_name);
     change.modulation_processor = connection->modulation_processor.get();
+    change.voice_copies = nullptr;
     return change;
   }
 
@@ -0,0 +1,169 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "binary_preset_test.h"
+#include "binary_preset.h"
+#include "embedded_data.h"
+#include "sample_source.h"
+
+namespace {
+  constexpr int kBinaryTestSampleLength = 3001;
+  constexpr int kBinaryTestSampleRate = 44100;
+
+  json createSampleState() {
+    std::vector<vital::mono_float> left(kBinaryTestSampleLength);
+    std::vector<vital::mono_float> right(kBinaryTestSampleLength);
+    for (int i = 0; i < kBinaryTestSampleLength; ++i) {
+      left[i] = sinf(0.01f * i);
+      right[i] = 0.5f * cosf(0.03f * i);
+    }
+
+    vital::Sample sample;
+    sample.loadSample(left.data(), right.data(), kBinaryTestSampleLength, kBinaryTestSampleRate);
+    sample.setName("Binary Test");
+    return sample.stateToJson();
+  }
+
+  json createBinaryTestState() {
+    json state;
+    state["synth_version"] = ProjectInfo::versionString;
+    state["author"] = "Someone";
+    state["preset_style"] = "Bass";
+    state["settings"]["volume"] = 0.5f;
+    state["settings"]["sample"] = createSampleState();
+    json keyframe;
+    keyframe["position"] = 0;
+    keyframe["wave_data"] = Base64::toBase64("abcdefgh", 8).toStdString();
+    state["settings"]["wavetables"][0]["groups"][0]["components"][0]["keyframes"].push_back(keyframe);
+    state["settings"]["wavetables"][0]["groups"][0]["components"][0]["audio_file"] = "";
+    return state;
+  }
+} // namespace
+
+void BinaryPresetTest::runTest() {
+  testJsonRoundTrip();
+  testEmbeddedLoad();
+  testUpgradeVersion();
+  testCorruptedData();
+}
+
+void BinaryPresetTest::testJsonRoundTrip() {
+  beginTest("Json Round Trip");
+  json state = createBinaryTestState();
+  MemoryBlock data = BinaryPreset::fromJson(state);
+  expect(BinaryPreset::isBinary(data.getData(), data.getSize()));
+  expect(data.getSize() < state.dump().size());
+
+  json restored;
+  expect(BinaryPreset::toJson(data.getData(), data.getSize(), restored));
+  expect(restored == state);
+
+  json metadata;
+  expect(BinaryPreset::readState(data.getData(), data.getSize(), metadata));
+  expect(metadata["author"] == "Someone");
+  expect(metadata["settings"]["sample"]["samples"].is_number_integer());
+
+  json text_state = state;
+  text_state["settings"]["sample"]["samples"] = "not base64!";
+  data = BinaryPreset::fromJson(text_state);
+  expect(BinaryPreset::toJson(data.getData(), data.getSize(), restored));
+  expect(restored == text_state);
+
+  json ambiguous_state = state;
+  ambiguous_state["settings"]["sample"]["samples"] = 0;
+  expectEquals((int)BinaryPreset::fromJson(ambiguous_state).getSize(), 0);
+}
+
+void BinaryPresetTest::testEmbeddedLoad() {
+  beginTest("Embedded Load");
+  json state = createBinaryTestState();
+  TemporaryFile temporary_file(".vital");
+  File file = temporary_file.getFile();
+  expect(BinaryPreset::writeFile(file, state));
+  expect(BinaryPreset::isBinary(file));
+
+  json reference;
+  {
+    BinaryPreset preset;
+    expect(preset.open(file));
+    const json& sample_state = preset.getState()["settings"]["sample"];
+    expect(sample_state["samples"].is_object());
+    reference = sample_state["samples"];
+
+    vital::Sample embedded_sample;
+    embedded_sample.jsonToState(sample_state);
+    vital::Sample text_sample;
+    text_sample.jsonToState(state["settings"]["sample"]);
+    expect(embedded_sample.stateToJson() == text_sample.stateToJson());
+    expectEquals(embedded_sample.originalLength(), kBinaryTestSampleLength);
+  }
+
+  MemoryOutputStream decoded;
+  const void* data = nullptr;
+  size_t size = 0;
+  expect(!vital::EmbeddedData::read(reference, decoded, data, size));
+
+  File json_file = file.getSiblingFile("binary_preset_test_copy.vital");
+  expect(BinaryPreset::convertFile(file, json_file));
+  expect(!BinaryPreset::isBinary(json_file));
+  expect(json::parse(json_file.loadFileAsString().toStdString()) == state);
+  json_file.deleteFile();
+}
+
+void BinaryPresetTest::testUpgradeVersion() {
+  beginTest("Upgrade Version");
+  TemporaryFile temporary_file(".vital");
+  File file = temporary_file.getFile();
+
+  json upgraded_state = createBinaryTestState();
+  upgraded_state["synth_version"] = "0.3.8";
+  expect(BinaryPreset::writeFile(file, upgraded_state));
+  {
+    BinaryPreset preset;
+    expect(preset.open(file));
+    expect(preset.getState() == upgraded_state);
+  }
+
+  json current_state = createBinaryTestState();
+  current_state["synth_version"] = "0.3.9";
+  expect(BinaryPreset::writeFile(file, current_state));
+  {
+    BinaryPreset preset;
+    expect(preset.open(file));
+    const json& settings = preset.getState()["settings"];
+    expect(settings["sample"]["samples"].is_object());
+    expect(settings["wavetables"][0]["groups"][0]["components"][0]["keyframes"][0]["wave_data"].is_object());
+  }
+}
+
+void BinaryPresetTest::testCorruptedData() {
+  beginTest("Corrupted Data");
+  MemoryBlock data = BinaryPreset::fromJson(createBinaryTestState());
+  json state;
+  expect(!BinaryPreset::toJson(data.getData(), data.getSize() - 1, state));
+  expect(!BinaryPreset::toJson(data.getData(), 12, state));
+
+  MemoryBlock bad_version = data;
+  static_cast<char*>(bad_version.getData())[4] = 99;
+  expect(!BinaryPreset::readState(bad_version.getData(), bad_version.getSize(), state));
+
+  const char* text = "{\"author\": \"Someone\"}";
+  expect(!BinaryPreset::isBinary(text, strlen(text)));
+  expect(!BinaryPreset::readState(text, strlen(text), state));
+}
+
+static BinaryPresetTest binary_preset_test;
@@ -0,0 +1,130 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "control_event_test.h"
+#include "midi_manager.h"
+#include "sound_engine.h"
+#include "synth_base.h"
+#include "synth_parameters.h"
+
+namespace {
+  constexpr int kControlBlockSize = 1500;
+  constexpr int kLearnedController = 21;
+
+  class ControlEventSynth : public HeadlessSynth {
+    public:
+      void processBlock(AudioSampleBuffer& buffer, MidiBuffer& midi_messages) {
+        processAudioAndMidi(&buffer, vital::kNumChannels, buffer.getNumSamples(), midi_messages, seconds_time_);
+      }
+
+      void learnController(const std::string& name) {
+        MidiManager::midi_map midi_learn_map;
+        midi_learn_map[kLearnedController][name] = &vital::Parameters::getDetails(name);
+        midi_manager_->setMidiLearnMap(midi_learn_map);
+      }
+
+      // Silences the output and lets the volume smoothing settle before a note.
+      void silence(AudioSampleBuffer& buffer) {
+        controls_["volume"]->set(vital::Parameters::getDetails("volume").min);
+        MidiBuffer no_messages;
+        processBlock(buffer, no_messages);
+        buffer.clear();
+      }
+
+    private:
+      double seconds_time_ = 0.0;
+  };
+
+  bool isSilent(const AudioSampleBuffer& buffer, int start, int end) {
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+      for (int i = start; i < end; ++i) {
+        if (buffer.getSample(channel, i) != 0.0f)
+          return false;
+      }
+    }
+    return true;
+  }
+} // namespace
+
+void ControlEventTest::runTest() {
+  testEventSplits();
+  testMidiLearnSplits();
+  testUnknownParameter();
+}
+
+void ControlEventTest::testEventSplits() {
+  beginTest("Event Splits");
+  ControlEventSynth synth;
+  const vital::ValueDetails& details = vital::Parameters::getDetails("volume");
+  AudioSampleBuffer buffer(vital::kNumChannels, kControlBlockSize);
+  synth.silence(buffer);
+
+  static constexpr int kEventSample = 700;
+  int id = vital::Parameters::getId("volume");
+  synth.addControlEvent(id, details.max, kEventSample);
+  synth.addControlEvent(-1, details.max, 37);
+  synth.addControlEvent(id, details.min, 37);
+  synth.addControlEvent(id, details.default_value, kControlBlockSize + 10);
+  synth.addControlEvent(id, details.min, kEventSample);
+  synth.addControlEvent(id, details.max, kEventSample);
+
+  MidiBuffer midi_messages;
+  midi_messages.addEvent(MidiMessage::noteOn(1, 60, 1.0f), 0);
+  synth.processBlock(buffer, midi_messages);
+
+  expect(isSilent(buffer, 0, kEventSample), "Control event changed the volume before its sample.");
+  expect(!isSilent(buffer, kEventSample, kControlBlockSize), "Events on the same sample should apply in order.");
+  expectEquals(synth.getControls()["volume"]->value(), details.default_value,
+               "Events past the block should apply at its end.");
+
+  synth.getControls()["volume"]->set(details.min);
+  synth.processBlock(buffer, midi_messages);
+  expectEquals(synth.getControls()["volume"]->value(), details.min, "Events should be cleared after each block.");
+}
+
+void ControlEventTest::testMidiLearnSplits() {
+  beginTest("Midi Learn Splits");
+  ControlEventSynth synth;
+  synth.learnController("volume");
+
+  const vital::ValueDetails& details = vital::Parameters::getDetails("volume");
+  AudioSampleBuffer buffer(vital::kNumChannels, kControlBlockSize);
+  synth.silence(buffer);
+
+  static constexpr int kLearnedSample = 123;
+  MidiBuffer midi_messages;
+  midi_messages.addEvent(MidiMessage::noteOn(1, 60, 1.0f), 0);
+  midi_messages.addEvent(MidiMessage::controllerEvent(1, kLearnedController + 1, 127), 50);
+  midi_messages.addEvent(MidiMessage::controllerEvent(1, kLearnedController, 127), kLearnedSample);
+  synth.processBlock(buffer, midi_messages);
+
+  expect(isSilent(buffer, 0, kLearnedSample), "Learned controller changed the volume before its sample.");
+  expect(!isSilent(buffer, kLearnedSample, kControlBlockSize), "Learned controller never raised the volume.");
+  expectEquals(synth.getControls()["volume"]->value(), details.max);
+}
+
+void ControlEventTest::testUnknownParameter() {
+  beginTest("Unknown Parameter");
+  ControlEventSynth synth;
+  synth.valueChanged("not_a_parameter", 1.0f);
+  synth.valueChanged(-1, 1.0f);
+  synth.valueChanged(vital::Parameters::getNumParameters(), 1.0f);
+
+  synth.valueChanged("volume", 0.25f);
+  expectEquals(synth.getControls()["volume"]->value(), 0.25f);
+}
+
+static ControlEventTest control_event_test;
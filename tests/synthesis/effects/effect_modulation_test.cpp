@@ -0,0 +1,93 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "effect_modulation_test.h"
+#include "modulation_connection_processor.h"
+#include "sound_engine.h"
+#include "synth_parameters.h"
+#include "synth_types.h"
+
+namespace {
+  constexpr float kTwoTimesOversampling = 1.0f;
+  constexpr int kModulationBlockSize = 64;
+  constexpr int kModulationSettleBlocks = 4;
+  constexpr int kModulationBlocks = 40;
+  constexpr float kMaxBoundaryStepRatio = 4.0f;
+
+  void connectModulation(vital::SoundEngine& engine, const std::string& source, const std::string& destination) {
+    vital::ModulationConnection* connection = engine.getModulationBank().createConnection(source, destination);
+
+    vital::modulation_change change;
+    change.source = engine.getModulationSource(source);
+    change.mono_destination = engine.getMonoModulationDestination(destination);
+    change.mono_modulation_switch = engine.getMonoModulationSwitch(destination);
+    change.poly_destination = engine.getPolyModulationDestination(destination);
+    change.poly_modulation_switch = engine.getPolyModulationSwitch(destination);
+    change.destination_scale = vital::Parameters::getParameterRange(destination);
+    change.modulation_processor = connection->modulation_processor.get();
+    change.disconnecting = false;
+    change.num_audio_rate = 0;
+    change.voice_copies = nullptr;
+    engine.connectModulation(change);
+
+    int index = connection->modulation_processor->index() + 1;
+    engine.getControls()["modulation_" + std::to_string(index) + "_amount"]->set(1.0f);
+  }
+} // namespace
+
+void EffectModulationTest::runTest() {
+  testContinuousModulation("eq_band_cutoff");
+  testContinuousModulation("phaser_center");
+}
+
+void EffectModulationTest::testContinuousModulation(const std::string& destination) {
+  beginTest("Continuous " + destination);
+  vital::SoundEngine engine;
+  engine.getControls()["oversampling"]->set(kTwoTimesOversampling);
+  engine.checkOversampling();
+  engine.getControls()["eq_on"]->set(1.0f);
+  engine.getControls()["phaser_on"]->set(1.0f);
+  connectModulation(engine, "lfo_1", destination);
+  engine.noteOn(60, 1.0f, 0, 0);
+
+  // The effects run at the base rate while the LFO runs at the voice rate. Steps across block boundaries
+  // should look like steps within a block, not a jump over the half of the LFO block that wasn't read.
+  const vital::Output* modulated = engine.getMonoModulationDestination(destination)->output();
+  float max_step = 0.0f;
+  float max_boundary_step = 0.0f;
+  float last_value = 0.0f;
+  for (int b = 0; b < kModulationBlocks; ++b) {
+    engine.process(kModulationBlockSize);
+    for (int i = 0; i < kModulationBlockSize; ++i) {
+      float value = modulated->buffer[i][0];
+      float step = std::abs(value - last_value);
+      last_value = value;
+      if (b < kModulationSettleBlocks)
+        continue;
+
+      if (i == 0)
+        max_boundary_step = std::max(max_boundary_step, step);
+      else
+        max_step = std::max(max_step, step);
+    }
+  }
+
+  expect(max_step > 0.0f, "LFO didn't modulate " + destination);
+  expect(max_boundary_step <= kMaxBoundaryStepRatio * max_step,
+         "Modulation of " + destination + " jumps at block boundaries");
+}
+
+static EffectModulationTest effect_modulation_test;
@@ -24,11 +24,17 @@ void CombFilterTest::runTest() {
   ignored_inputs.insert(vital::CombFilter::kStyle);
   vital::Value style;
   comb_filter.plug(&style, vital::CombFilter::kStyle);
+  expect(!comb_filter.hasMemory());
   
   for (int i = 0; i < vital::CombFilter::kNumFilterTypes; ++i) {
     style.set(i);
     runInputBoundsTest(&comb_filter, ignored_inputs, std::set<int>());
   }
+
+  expect(comb_filter.hasMemory());
+  comb_filter.releaseMemory();
+  comb_filter.hardReset();
+  expect(!comb_filter.hasMemory());
 }
 
 static CombFilterTest comb_filter_test;
@@ -0,0 +1,106 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "upsampler_test.h"
+#include "upsampler.h"
+
+namespace {
+  constexpr int kNumBlocks = 64;
+  constexpr int kSettleSamples = 2048;
+  constexpr float kMaxDcError = 0.0001f;
+  constexpr float kMaxGainErrorDb = 0.1f;
+  constexpr float kMinImageRejectionDb = 90.0f;
+
+  // Hann windowed magnitude of a single frequency, in cycles per sample.
+  double magnitude(const std::vector<float>& signal, double frequency) {
+    double real = 0.0;
+    double imaginary = 0.0;
+    int size = static_cast<int>(signal.size());
+    for (int i = 0; i < size; ++i) {
+      double window = 0.5 - 0.5 * cos(2.0 * vital::kPi * i / (size - 1));
+      double phase = 2.0 * vital::kPi * frequency * i;
+      real += window * signal[i] * cos(phase);
+      imaginary += window * signal[i] * sin(phase);
+    }
+    return sqrt(real * real + imaginary * imaginary);
+  }
+
+  std::vector<float> upsampleSine(int oversample, double frequency) {
+    vital::Upsampler upsampler(vital::kMaxOversampleStages);
+    upsampler.setOversampleAmount(oversample);
+
+    std::vector<float> result;
+    vital::poly_float audio[vital::kMaxBufferSize];
+    for (int b = 0; b < kNumBlocks; ++b) {
+      for (int i = 0; i < vital::kMaxBufferSize; ++i) {
+        float value = sin(2.0 * vital::kPi * frequency * (b * vital::kMaxBufferSize + i));
+        audio[i] = vital::poly_float(value, -value);
+      }
+
+      upsampler.processWithInput(audio, vital::kMaxBufferSize);
+      const vital::poly_float* output = upsampler.output()->buffer;
+      for (int i = 0; i < vital::kMaxBufferSize * oversample; ++i)
+        result.push_back(output[i][0]);
+    }
+
+    return std::vector<float>(result.begin() + kSettleSamples, result.end());
+  }
+} // namespace
+
+void UpsamplerTest::runTest() {
+  vital::Upsampler upsampler(vital::kMaxOversampleStages);
+  runInputBoundsTest(&upsampler);
+
+  testDcGain();
+  testAliasRejection();
+}
+
+void UpsamplerTest::testDcGain() {
+  beginTest("Dc Gain");
+  for (int oversample = 2; oversample <= vital::kMaxOversample; oversample *= 2) {
+    vital::Upsampler upsampler(vital::kMaxOversampleStages);
+    upsampler.setOversampleAmount(oversample);
+
+    vital::poly_float audio[vital::kMaxBufferSize];
+    for (int i = 0; i < vital::kMaxBufferSize; ++i)
+      audio[i] = vital::poly_float(1.0f, -0.5f);
+
+    for (int b = 0; b < kNumBlocks; ++b)
+      upsampler.processWithInput(audio, vital::kMaxBufferSize);
+
+    vital::poly_float last = upsampler.output()->buffer[vital::kMaxBufferSize * oversample - 1];
+    expect(std::abs(last[0] - 1.0f) < kMaxDcError);
+    expect(std::abs(last[1] + 0.5f) < kMaxDcError);
+  }
+}
+
+void UpsamplerTest::testAliasRejection() {
+  beginTest("Alias Rejection");
+  const double frequencies[] = { 0.05, 0.2, 0.4 };
+  for (int oversample = 2; oversample <= vital::kMaxOversample; oversample *= 2) {
+    for (double frequency : frequencies) {
+      std::vector<float> upsampled = upsampleSine(oversample, frequency);
+      double expected = (upsampled.size() - 1) / 4.0;
+      double fundamental = magnitude(upsampled, frequency / oversample);
+      double image = magnitude(upsampled, (1.0 - frequency) / oversample);
+
+      expect(std::abs(20.0 * log10(fundamental / expected)) < kMaxGainErrorDb);
+      expect(20.0 * log10(fundamental / image) > kMinImageRejectionDb);
+    }
+  }
+}
+
+static UpsamplerTest upsampler_test;
@@ -0,0 +1,167 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "asset_cache_test.h"
+#include "asset_cache.h"
+#include "sample_source.h"
+#include "synth_constants.h"
+#include "wave_frame.h"
+#include "wavetable.h"
+#include "wavetable_cache.h"
+
+namespace {
+  constexpr int kSampleLength = 2000;
+  constexpr int kSampleRate = 44100;
+
+  void fillSample(vital::mono_float* buffer, float scale) {
+    for (int i = 0; i < kSampleLength; ++i)
+      buffer[i] = scale * sinf(i * 0.01f);
+  }
+} // namespace
+
+void AssetCacheTest::runTest() {
+  testReleasedEntries();
+  testSharedSamples();
+  testWavetableCopyOnWrite();
+  testWavetableFileCache();
+  testWavetableFileCacheLimit();
+}
+
+void AssetCacheTest::testReleasedEntries() {
+  beginTest("Released Entries");
+  vital::AssetCache<int>& cache = vital::AssetCache<int>::instance();
+  int value = 7;
+  vital::AssetKey key;
+  key.add(value);
+  vital::AssetKey other_key;
+  other_key.add(value + 1);
+
+  std::shared_ptr<int> first = cache.insert(key, std::make_shared<int>(value));
+  std::shared_ptr<int> second = cache.insert(key, std::make_shared<int>(value));
+  expect(first == second);
+  expect(cache.find(key) == first);
+  expect(cache.find(other_key) == nullptr);
+  expect(cache.size() == 1);
+
+  first = nullptr;
+  second = nullptr;
+  expect(cache.find(key) == nullptr);
+  expect(cache.size() == 0);
+}
+
+void AssetCacheTest::testSharedSamples() {
+  beginTest("Shared Samples");
+  vital::mono_float buffer[kSampleLength];
+  fillSample(buffer, 0.5f);
+
+  vital::Sample first;
+  vital::Sample second;
+  first.loadSample(buffer, kSampleLength, kSampleRate);
+  second.loadSample(buffer, kSampleLength, kSampleRate);
+  expect(first.buffer() == second.buffer());
+  expect(first.originalLength() == kSampleLength);
+
+  fillSample(buffer, 0.25f);
+  second.loadSample(buffer, kSampleLength, kSampleRate);
+  expect(first.buffer() != second.buffer());
+  expect(first.originalLength() == second.originalLength());
+}
+
+void AssetCacheTest::testWavetableCopyOnWrite() {
+  beginTest("Wavetable Copy On Write");
+  vital::Wavetable first(vital::kNumOscillatorWaveFrames);
+  vital::Wavetable second(vital::kNumOscillatorWaveFrames);
+  second.loadSharedData(first.shareData());
+  expect(first.getBuffer(0) == second.getBuffer(0));
+
+  vital::mono_float original = first.getBuffer(0)[1];
+  vital::WaveFrame wave_frame;
+  for (int i = 0; i < vital::WaveFrame::kWaveformSize; ++i)
+    wave_frame.time_domain[i] = original + 1.0f;
+  wave_frame.toFrequencyDomain();
+  second.loadWaveFrame(&wave_frame, 0);
+
+  expect(first.getBuffer(0) != second.getBuffer(0));
+  expect(first.getBuffer(0)[1] == original);
+  expect(second.getBuffer(0)[1] == original + 1.0f);
+  expect(first.getVersion() != second.getVersion());
+}
+
+void AssetCacheTest::testWavetableFileCache() {
+  beginTest("Wavetable File Cache");
+  File original_directory = WavetableCache::getDirectory();
+  TemporaryFile temporary_directory;
+  WavetableCache::setDirectory(temporary_directory.getFile());
+  expect(WavetableCache::load("missing") == nullptr);
+
+  vital::Wavetable wavetable(vital::kNumOscillatorWaveFrames);
+  wavetable.setNumFrames(3);
+  wavetable.setFrequencyRatio(2.0f);
+  wavetable.getBuffer(2)[5] = 0.75f;
+  expect(WavetableCache::save("table", wavetable.getAllData()));
+
+  std::shared_ptr<vital::Wavetable::WavetableData> loaded = WavetableCache::load("table");
+  expect(loaded != nullptr);
+  if (loaded) {
+    expect(loaded->num_frames == 3);
+    expect(loaded->frequency_ratio == 2.0f);
+    expect(loaded->wave_data[2][5] == 0.75f);
+    expect(loaded->version != wavetable.getVersion());
+
+    vital::Wavetable mapped(vital::kNumOscillatorWaveFrames);
+    mapped.loadSharedData(loaded);
+    mapped.setFrequencyRatio(1.0f);
+    expect(loaded->frequency_ratio == 2.0f);
+  }
+
+  temporary_directory.getFile().deleteRecursively();
+  WavetableCache::setDirectory(original_directory);
+}
+
+void AssetCacheTest::testWavetableFileCacheLimit() {
+  beginTest("Wavetable File Cache Limit");
+  File original_directory = WavetableCache::getDirectory();
+  int64 original_max_size = WavetableCache::getMaxSize();
+  TemporaryFile temporary_directory;
+  File directory = temporary_directory.getFile();
+  WavetableCache::setDirectory(directory);
+
+  vital::Wavetable wavetable(vital::kNumOscillatorWaveFrames);
+  wavetable.setNumFrames(2);
+  expect(WavetableCache::save("first", wavetable.getAllData()));
+  expect(WavetableCache::save("second", wavetable.getAllData()));
+
+  File first = directory.getChildFile("first" + String(WavetableCache::kExtension));
+  File second = directory.getChildFile("second" + String(WavetableCache::kExtension));
+  expect(first.existsAsFile() && second.existsAsFile());
+  WavetableCache::setMaxSize(first.getSize() * 5 / 2);
+
+  Time now = Time::getCurrentTime();
+  first.setLastAccessTime(now - RelativeTime::hours(2));
+  second.setLastAccessTime(now - RelativeTime::hours(1));
+  expect(WavetableCache::load("first") != nullptr);
+
+  expect(WavetableCache::save("third", wavetable.getAllData()));
+  expect(first.existsAsFile());
+  expect(!second.existsAsFile());
+  expect(directory.getChildFile("third" + String(WavetableCache::kExtension)).existsAsFile());
+
+  directory.deleteRecursively();
+  WavetableCache::setMaxSize(original_max_size);
+  WavetableCache::setDirectory(original_directory);
+}
+
+static AssetCacheTest asset_cache_test;
@@ -0,0 +1,111 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "audio_capture_test.h"
+#include "audio_capture.h"
+
+namespace {
+  constexpr int kCaptureSize = 64;
+  constexpr int kCaptureBlockSize = 24;
+
+  void fillRamp(vital::poly_float* block, int num_samples, int start) {
+    for (int i = 0; i < num_samples; ++i)
+      block[i] = vital::poly_float(start + i, -(start + i), 0.0f, 0.0f);
+  }
+} // namespace
+
+void AudioCaptureTest::runTest() {
+  testWrapping();
+  testLongBlock();
+  testAlignedStart();
+}
+
+void AudioCaptureTest::testWrapping() {
+  beginTest("Wrapping");
+  vital::AudioCapture capture(kCaptureSize);
+  expect(!capture.active());
+  capture.addConsumer();
+  expect(capture.active());
+
+  vital::poly_float block[kCaptureBlockSize];
+  for (int b = 0; b < 5; ++b) {
+    fillRamp(block, kCaptureBlockSize, b * kCaptureBlockSize);
+    capture.write(block, kCaptureBlockSize);
+  }
+  expect(capture.position() == 5 * kCaptureBlockSize);
+
+  vital::mono_float left[kCaptureSize];
+  vital::mono_float right[kCaptureSize];
+  capture.readSamples(left, kCaptureSize, 0, 0);
+  capture.readSamples(right, kCaptureSize, 0, 1);
+  int first = 5 * kCaptureBlockSize - kCaptureSize;
+  for (int i = 0; i < kCaptureSize; ++i) {
+    expectEquals(left[i], first + i * 1.0f);
+    expectEquals(right[i], -(first + i) * 1.0f);
+  }
+
+  capture.readSamples(left, 8, 10, 0);
+  expectEquals(left[7], 5.0f * kCaptureBlockSize - 11.0f);
+
+  capture.removeConsumer();
+  expect(!capture.active());
+}
+
+void AudioCaptureTest::testLongBlock() {
+  beginTest("Long Block");
+  vital::AudioCapture capture(kCaptureSize);
+  vital::poly_float block[3 * kCaptureSize];
+  fillRamp(block, 3 * kCaptureSize, 0);
+  capture.write(block, 3 * kCaptureSize);
+
+  vital::poly_float frames[kCaptureSize];
+  capture.readFrames(frames, kCaptureSize, 2 * kCaptureSize);
+  for (int i = 0; i < kCaptureSize; ++i)
+    expectEquals(frames[i][0], 2.0f * kCaptureSize + i);
+
+  capture.readFrames(frames, kCaptureSize / 4, 2 * kCaptureSize, 4);
+  expectEquals(frames[3][0], 2.0f * kCaptureSize + 12.0f);
+}
+
+void AudioCaptureTest::testAlignedStart() {
+  static constexpr int kWindow = 10;
+  static constexpr float kPeriod = 7.0f;
+
+  beginTest("Aligned Start");
+  vital::AudioCapture capture(kCaptureSize);
+  expect(capture.alignedStart(kWindow) == 0);
+
+  vital::poly_float block[kCaptureBlockSize];
+  fillRamp(block, kCaptureBlockSize, 0);
+  capture.write(block, kCaptureBlockSize);
+  expect(capture.alignedStart(kWindow) == kCaptureBlockSize - kWindow);
+
+  capture.trigger(kPeriod);
+  capture.write(block, 5);
+  expect(capture.alignedStart(kWindow) == kCaptureBlockSize + 5 - kWindow);
+
+  for (int i = 0; i < 4; ++i) {
+    capture.write(block, 9);
+    uint64_t start = capture.alignedStart(kWindow);
+    uint64_t since_trigger = start - kCaptureBlockSize;
+    expect(since_trigger % 14 == 0);
+    expect(start + kWindow <= capture.position());
+    expect(start + kWindow + 14 > capture.position());
+  }
+}
+
+static AudioCaptureTest audio_capture_test;
@@ -0,0 +1,166 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "modulation_block_test.h"
+#include "operators.h"
+
+#include <memory>
+#include <vector>
+
+namespace {
+  constexpr int kNumLinearBlocks = 11;
+  constexpr int kMapResolution = 16;
+  constexpr float kBlockEpsilon = 0.0001f;
+
+  class BlockSource : public vital::Processor {
+    public:
+      BlockSource(const vital::ModulationBlock& block) : vital::Processor(0, 1), block_(block) { }
+
+      vital::Processor* clone() const override { return new BlockSource(*this); }
+      void process(int num_samples) override { }
+      const vital::ModulationBlock* modulationBlock() const override { return &block_; }
+
+    private:
+      vital::ModulationBlock block_;
+  };
+
+  class BufferSource : public vital::Processor {
+    public:
+      BufferSource() : vital::Processor(0, 1) { }
+
+      vital::Processor* clone() const override { return new BufferSource(*this); }
+      void process(int num_samples) override { }
+  };
+
+  vital::ModulationBlock createBlock(const vital::poly_float* source, float amount, float delta, float offset) {
+    vital::ModulationBlock block = {};
+    block.source = source;
+    block.amount = amount;
+    block.delta_amount = delta;
+    block.offset = offset;
+    block.pre_scale = 1.0f;
+    block.post_scale = 1.0f;
+    return block;
+  }
+
+  float sourceValue(int index, int sample) {
+    return 0.5f + 0.45f * sinf(0.05f * sample + index);
+  }
+
+  float morphValue(const vital::ModulationBlock& block, float value, float amount, float power) {
+    float shift = value * block.pre_scale[0] + block.offset[0];
+    float scaled = amount * vital::futils::powerScale(fabsf(shift), power);
+    return (shift < 0.0f ? -scaled : scaled) * block.post_scale[0];
+  }
+
+  void processSum(vital::ModulationSum& sum, const std::vector<std::unique_ptr<vital::Processor>>& sources) {
+    for (auto& source : sources)
+      sum.plugNext(source.get());
+    sum.process(vital::kMaxBufferSize);
+  }
+} // namespace
+
+void ModulationBlockTest::runTest() {
+  testLinearBatch();
+  testRemappedAndMorphed();
+  testFirstValue();
+}
+
+void ModulationBlockTest::testLinearBatch() {
+  beginTest("Linear Batch");
+  vital::poly_float buffers[kNumLinearBlocks][vital::kMaxBufferSize];
+  std::vector<std::unique_ptr<vital::Processor>> sources;
+  for (int b = 0; b < kNumLinearBlocks; ++b) {
+    for (int i = 0; i < vital::kMaxBufferSize; ++i)
+      buffers[b][i] = sourceValue(b, i);
+
+    float amount = 0.1f * (b - 5);
+    vital::ModulationBlock block = createBlock(buffers[b], amount, 0.001f * b, -0.5f * (b % 2));
+    sources.push_back(std::make_unique<BlockSource>(block));
+  }
+
+  BufferSource* plain = new BufferSource();
+  for (int i = 0; i < vital::kMaxBufferSize; ++i)
+    plain->output()->buffer[i] = 0.01f * i;
+  sources.push_back(std::unique_ptr<vital::Processor>(plain));
+
+  vital::ModulationSum sum;
+  processSum(sum, sources);
+  for (int i = 0; i < vital::kMaxBufferSize; ++i) {
+    float expected = 0.01f * i;
+    for (int b = 0; b < kNumLinearBlocks; ++b) {
+      float amount = 0.1f * (b - 5) + 0.001f * b * (i + 1);
+      expected += (sourceValue(b, i) - 0.5f * (b % 2)) * amount;
+    }
+    expect(std::abs(sum.output()->buffer[i][0] - expected) < kBlockEpsilon, "Batched sum differs from reference.");
+  }
+}
+
+void ModulationBlockTest::testRemappedAndMorphed() {
+  beginTest("Remapped And Morphed");
+  vital::mono_float map[kMapResolution + 2 * vital::poly_float::kSize];
+  for (int i = 0; i < kMapResolution + 2 * vital::poly_float::kSize; ++i)
+    map[i] = (i - 1.0f) / kMapResolution;
+
+  vital::poly_float buffer[vital::kMaxBufferSize];
+  for (int i = 0; i < vital::kMaxBufferSize; ++i)
+    buffer[i] = sourceValue(0, i);
+
+  vital::ModulationBlock morphed = createBlock(buffer, 0.8f, 0.0f, -1.0f);
+  morphed.morph = true;
+  morphed.power = 2.0f;
+  morphed.delta_power = 0.01f;
+  morphed.pre_scale = 2.0f;
+  morphed.post_scale = 0.5f;
+
+  vital::ModulationBlock remapped = morphed;
+  remapped.remap = true;
+  remapped.map = map;
+  remapped.resolution = kMapResolution;
+
+  vital::poly_float morphed_out[vital::kMaxBufferSize];
+  vital::poly_float remapped_out[vital::kMaxBufferSize];
+  vital::utils::zeroBuffer(morphed_out, vital::kMaxBufferSize);
+  vital::utils::zeroBuffer(remapped_out, vital::kMaxBufferSize);
+  morphed.accumulate(morphed_out, vital::kMaxBufferSize);
+  remapped.accumulate(remapped_out, vital::kMaxBufferSize);
+
+  for (int i = 0; i < vital::kMaxBufferSize; ++i) {
+    float power = 2.0f + 0.01f * (i + 1);
+    float expected = morphValue(morphed, sourceValue(0, i), 0.8f, power);
+    expect(std::abs(morphed_out[i][0] - expected) < kBlockEpsilon, "Morphed modulation differs from reference.");
+    expect(std::abs(remapped_out[i][0] - expected) < kBlockEpsilon, "Identity map changed the modulation.");
+  }
+}
+
+void ModulationBlockTest::testFirstValue() {
+  beginTest("First Value");
+  vital::poly_float buffer[vital::kMaxBufferSize];
+  for (int i = 0; i < vital::kMaxBufferSize; ++i)
+    buffer[i] = sourceValue(3, i);
+
+  vital::ModulationBlock block = createBlock(buffer, -0.3f, 0.002f, -0.5f);
+  for (int morph = 0; morph < 2; ++morph) {
+    block.morph = morph;
+    block.power = -1.5f;
+    vital::poly_float dest[vital::kMaxBufferSize];
+    vital::utils::zeroBuffer(dest, vital::kMaxBufferSize);
+    block.accumulate(dest, vital::kMaxBufferSize);
+    expect(std::abs(block.firstValue()[0] - dest[0][0]) < kBlockEpsilon);
+  }
+}
+
+static ModulationBlockTest modulation_block_test;
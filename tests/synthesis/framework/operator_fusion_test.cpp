@@ -0,0 +1,145 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "operator_fusion_test.h"
+#include "feedback.h"
+#include "operators.h"
+#include "processor_router.h"
+#include "value.h"
+
+namespace {
+  constexpr float kEpsilon = 0.00001f;
+
+  struct FusionGraph {
+    FusionGraph() {
+      first = new vital::cr::Value(1.5f);
+      second = new vital::cr::Value(0.25f);
+      third = std::make_unique<vital::cr::Value>(-0.5f);
+      sum = new vital::cr::VariableAdd();
+      add = new vital::cr::Add();
+      square = new vital::cr::Square();
+      modulator = new vital::cr::FrequencyToPhase();
+
+      sum->plugNext(first);
+      sum->plugNext(second);
+      add->plug(sum, 0);
+      add->plug(third.get(), 1);
+      square->plug(add);
+      modulator->plug(square);
+
+      router.addProcessor(first);
+      router.addProcessor(second);
+      router.addProcessor(sum);
+      router.addProcessor(add);
+      router.addProcessor(square);
+      router.addProcessor(modulator);
+    }
+
+    float result() {
+      router.process(1);
+      return square->output()->buffer[0][0];
+    }
+
+    vital::ProcessorRouter router;
+    vital::cr::Value* first;
+    vital::cr::Value* second;
+    // Owned outside the router like a control from a parent, so the sum and add are adjacent and fuse.
+    std::unique_ptr<vital::cr::Value> third;
+    vital::cr::VariableAdd* sum;
+    vital::cr::Add* add;
+    vital::cr::Square* square;
+    vital::cr::FrequencyToPhase* modulator;
+  };
+
+  bool readsThroughFeedback(const vital::Processor* destination, int index) {
+    return dynamic_cast<const vital::Feedback*>(destination->input(index)->source->owner) != nullptr;
+  }
+
+  float expected(float first, float second, float third) {
+    float total = first + second + third;
+    return total * total;
+  }
+} // namespace
+
+void OperatorFusionTest::runTest() {
+  testFusedOutput();
+  testFusedChangedInput();
+  testFusedDisabled();
+  testFusedCyclicModulation();
+}
+
+void OperatorFusionTest::testFusedOutput() {
+  beginTest("Fused Output");
+  FusionGraph graph;
+  float unfused = graph.result();
+  expect(std::abs(unfused - expected(1.5f, 0.25f, -0.5f)) < kEpsilon);
+
+  graph.router.fuseOperatorChains();
+  expect(graph.result() == unfused);
+  expect(std::abs(graph.add->output()->buffer[0][0] - 1.25f) < kEpsilon);
+}
+
+void OperatorFusionTest::testFusedChangedInput() {
+  beginTest("Fused Changed Input");
+  FusionGraph graph;
+  graph.router.fuseOperatorChains();
+  graph.result();
+
+  graph.first->set(3.0f);
+  graph.third->set(1.0f);
+  expect(std::abs(graph.result() - expected(3.0f, 0.25f, 1.0f)) < kEpsilon);
+  expect(std::abs(graph.sum->output()->buffer[0][0] - 3.25f) < kEpsilon);
+}
+
+void OperatorFusionTest::testFusedDisabled() {
+  beginTest("Fused Disabled");
+  FusionGraph unfused_graph;
+  FusionGraph fused_graph;
+  fused_graph.router.fuseOperatorChains();
+
+  unfused_graph.add->enable(false);
+  fused_graph.add->enable(false);
+  expect(fused_graph.result() == unfused_graph.result());
+
+  unfused_graph.add->enable(true);
+  fused_graph.add->enable(true);
+  expect(fused_graph.result() == unfused_graph.result());
+  expect(std::abs(fused_graph.result() - expected(1.5f, 0.25f, -0.5f)) < kEpsilon);
+}
+
+void OperatorFusionTest::testFusedCyclicModulation() {
+  beginTest("Fused Cyclic Modulation");
+  FusionGraph unfused_graph;
+  FusionGraph fused_graph;
+  fused_graph.router.fuseOperatorChains();
+
+  // The modulator reads the chain's output, so modulating the chain's input with it is a cycle.
+  unfused_graph.sum->plugNext(unfused_graph.modulator);
+  fused_graph.sum->plugNext(fused_graph.modulator);
+  expect(readsThroughFeedback(unfused_graph.sum, 2));
+  expect(readsThroughFeedback(fused_graph.sum, 2));
+
+  // A cycle that stays inside the fused chain.
+  unfused_graph.sum->plugNext(unfused_graph.square);
+  fused_graph.sum->plugNext(fused_graph.square);
+  expect(readsThroughFeedback(unfused_graph.sum, 3));
+  expect(readsThroughFeedback(fused_graph.sum, 3));
+
+  for (int i = 0; i < 4; ++i)
+    expect(fused_graph.result() == unfused_graph.result());
+}
+
+static OperatorFusionTest operator_fusion_test;
@@ -0,0 +1,109 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "processor_router_test.h"
+#include "processor_router.h"
+#include "sound_engine.h"
+#include "synth_module.h"
+
+#include <memory>
+#include <vector>
+
+namespace {
+  constexpr int kNumRouterProcessors = 200;
+
+  class CountingProcessor : public vital::Processor {
+    public:
+      CountingProcessor(std::shared_ptr<int> count) : vital::Processor(0, 1, true), count_(std::move(count)) { }
+
+      vital::Processor* clone() const override { return new CountingProcessor(*this); }
+      void process(int num_samples) override { (*count_)++; }
+
+    private:
+      std::shared_ptr<int> count_;
+  };
+
+  struct CountingRouter {
+    CountingRouter() : count(std::make_shared<int>(0)) {
+      for (int i = 0; i < kNumRouterProcessors; ++i) {
+        CountingProcessor* processor = new CountingProcessor(count);
+        router.addProcessor(processor);
+        processors.push_back(processor);
+        processor->enable(i % 50 == 0);
+      }
+    }
+
+    vital::ProcessorRouter router;
+    std::vector<CountingProcessor*> processors;
+    std::shared_ptr<int> count;
+  };
+} // namespace
+
+void ProcessorRouterTest::runTest() {
+  testActiveOrder();
+  testClonedActiveOrder();
+  testModulationSlots();
+}
+
+void ProcessorRouterTest::testActiveOrder() {
+  beginTest("Active Order");
+  CountingRouter counting;
+  counting.router.process(1);
+  expectEquals(*counting.count, kNumRouterProcessors / 50);
+
+  counting.processors[1]->enable(true);
+  counting.processors[0]->enable(false);
+  *counting.count = 0;
+  counting.router.process(1);
+  expectEquals(*counting.count, kNumRouterProcessors / 50);
+
+  for (CountingProcessor* processor : counting.processors)
+    processor->enable(false);
+  *counting.count = 0;
+  counting.router.process(1);
+  expectEquals(*counting.count, 0);
+}
+
+void ProcessorRouterTest::testClonedActiveOrder() {
+  beginTest("Cloned Active Order");
+  CountingRouter counting;
+  std::unique_ptr<vital::Processor> voice(counting.router.clone());
+  voice->process(1);
+  expectEquals(*counting.count, kNumRouterProcessors / 50);
+
+  for (int i = 0; i < 10; ++i)
+    counting.processors[i]->enable(true);
+  *counting.count = 0;
+  voice->process(1);
+  expectEquals(*counting.count, kNumRouterProcessors / 50 + 9, "Clone didn't see enabled processors.");
+}
+
+void ProcessorRouterTest::testModulationSlots() {
+  beginTest("Modulation Slots");
+  vital::SoundEngine engine;
+  std::string last = std::to_string(vital::kMaxModulationConnections);
+  const vital::StatusOutput* amount = engine.getStatusOutput("modulation_amount_" + last);
+  const vital::StatusOutput* source = engine.getStatusOutput("modulation_source_" + last);
+  expect(amount != nullptr && source != nullptr);
+  expect(engine.getControls().count("modulation_" + last + "_amount") > 0);
+
+  engine.noteOn(60, 1.0f, 0, 0);
+  engine.process(vital::kMaxBufferSize);
+  engine.getTelemetry()->acquire();
+  expect(amount->isClearValue(amount->value()), "Unused modulation slot published a readout.");
+}
+
+static ProcessorRouterTest processor_router_test;
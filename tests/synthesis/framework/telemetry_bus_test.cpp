@@ -0,0 +1,119 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "telemetry_bus_test.h"
+#include "telemetry_bus.h"
+#include "sound_engine.h"
+
+#include <thread>
+
+namespace {
+  constexpr int kNumTelemetryValues = 300;
+  constexpr int kNumTelemetryBlocks = 20000;
+} // namespace
+
+void TelemetryBusTest::runTest() {
+  testPublishAcquire();
+  testConcurrentSnapshots();
+  testEngineStatusOutputs();
+}
+
+void TelemetryBusTest::testPublishAcquire() {
+  beginTest("Publish Acquire");
+  vital::TelemetryBus bus(kNumTelemetryValues);
+  expect(!bus.acquire(), "Nothing was published yet.");
+  expectEquals(bus.read(0)[0], 0.0f);
+
+  for (int i = 0; i < kNumTelemetryValues; ++i)
+    bus.staging()[i] = i;
+  expectEquals(bus.read(5)[0], 0.0f, "Staged values were read before publishing.");
+
+  bus.publish();
+  expect(bus.acquire());
+  expect(!bus.acquire(), "Acquired the same block twice.");
+  for (int i = 0; i < kNumTelemetryValues; ++i)
+    expectEquals(bus.read(i)[0], static_cast<float>(i));
+
+  // Only the latest block is kept.
+  bus.staging()[5] = 1.0f;
+  bus.publish();
+  bus.staging()[5] = 2.0f;
+  bus.publish();
+  expectEquals(bus.read(5)[0], 5.0f);
+  expect(bus.acquire());
+  expectEquals(bus.read(5)[0], 2.0f);
+  expectEquals(bus.read(6)[0], 6.0f);
+  expect(bus.numPublished() == 3);
+}
+
+void TelemetryBusTest::testConcurrentSnapshots() {
+  beginTest("Concurrent Snapshots");
+  vital::TelemetryBus bus(kNumTelemetryValues);
+
+  std::thread writer([&bus] {
+    for (int block = 1; block <= kNumTelemetryBlocks; ++block) {
+      for (int i = 0; i < kNumTelemetryValues; ++i)
+        bus.staging()[i] = block;
+      bus.publish();
+    }
+  });
+
+  int torn = 0;
+  float last_block = 0.0f;
+  bool backwards = false;
+  while (last_block < kNumTelemetryBlocks) {
+    if (!bus.acquire())
+      continue;
+
+    float block = bus.read(0)[0];
+    for (int i = 1; i < kNumTelemetryValues; ++i) {
+      if (bus.read(i)[0] != block)
+        torn++;
+    }
+    backwards = backwards || block < last_block;
+    last_block = block;
+  }
+  writer.join();
+
+  expect(torn == 0, "Snapshot mixed values from different blocks.");
+  expect(!backwards, "Snapshots went back in time.");
+}
+
+void TelemetryBusTest::testEngineStatusOutputs() {
+  beginTest("Engine Status Outputs");
+  vital::SoundEngine engine;
+  vital::TelemetryBus* bus = engine.getTelemetry();
+  const vital::StatusOutput* num_voices = engine.getStatusOutput("num_voices");
+  const vital::StatusOutput* peak_meter = engine.getStatusOutput("peak_meter");
+  expect(bus != nullptr);
+  expect(num_voices != nullptr && peak_meter != nullptr);
+  expect(num_voices->index() >= 0 && num_voices->index() < bus->numValues());
+  expect(num_voices->index() != peak_meter->index());
+
+  engine.noteOn(60, 1.0f, 0, 0);
+  engine.process(vital::kMaxBufferSize);
+  expectEquals(num_voices->value()[0], 0.0f, "Status outputs changed before being acquired.");
+
+  expect(bus->acquire());
+  expectEquals(num_voices->value()[0], 1.0f);
+
+  engine.noteOff(60, 0.0f, 0, 0);
+  engine.allSoundsOff();
+  engine.process(vital::kMaxBufferSize);
+  expectEquals(num_voices->value()[0], 1.0f);
+}
+
+static TelemetryBusTest telemetry_bus_test;
@@ -0,0 +1,93 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pitch_detector_test.h"
+#include "file_source.h"
+#include "pitch_detector.h"
+
+namespace {
+  constexpr int kSignalSize = FileSource::kPitchDetectMaxPeriod;
+  constexpr int kNumHarmonics = 24;
+  constexpr float kMaxPeriodError = 0.05f;
+
+  void createHarmonicSignal(float* signal, float period) {
+    vital::utils::RandomGenerator random(0.0f, vital::kPi);
+    float phases[kNumHarmonics];
+    for (int h = 0; h < kNumHarmonics; ++h)
+      phases[h] = random.next();
+
+    for (int i = 0; i < kSignalSize; ++i) {
+      signal[i] = 0.0f;
+      for (int h = 1; h <= kNumHarmonics; ++h)
+        signal[i] += sinf(2.0f * vital::kPi * h * i / period + phases[h - 1]) / h;
+    }
+  }
+} // namespace
+
+void PitchDetectorTest::runTest() {
+  testKnownPeriods();
+  testMatchesErrorSearch();
+  testMaxPeriod();
+}
+
+void PitchDetectorTest::testKnownPeriods() {
+  beginTest("Known Periods");
+
+  static constexpr float kPeriods[] = { 301.5f, 440.0f, 611.5f, 1000.25f, 1337.75f, 2000.0f };
+  float signal[kSignalSize];
+  for (float period : kPeriods) {
+    createHarmonicSignal(signal, period);
+    PitchDetector detector;
+    detector.loadSignal(signal, kSignalSize);
+    float match = detector.findYinPeriod(vital::WaveFrame::kWaveformSize);
+    expect(std::abs(match - period) < kMaxPeriodError,
+           "Detected period " + String(match) + " for signal with period " + String(period));
+  }
+}
+
+void PitchDetectorTest::testMatchesErrorSearch() {
+  beginTest("Matches Error Search");
+
+  static constexpr float kPeriods[] = { 523.0f, 1111.5f };
+  float signal[kSignalSize];
+  for (float period : kPeriods) {
+    createHarmonicSignal(signal, period);
+    PitchDetector detector;
+    detector.loadSignal(signal, kSignalSize);
+    float yin_match = detector.findYinPeriod(vital::WaveFrame::kWaveformSize);
+    float error_match = detector.findErrorPeriod(vital::WaveFrame::kWaveformSize);
+    expect(std::abs(yin_match - error_match) < 2.0f * kMaxPeriodError,
+           "Fft search found " + String(yin_match) + " but error search found " + String(error_match));
+  }
+}
+
+void PitchDetectorTest::testMaxPeriod() {
+  beginTest("Max Period");
+
+  // Periods shorter than the minimum are matched to their first multiple within the search range.
+  static constexpr float kPeriod = 110.25f;
+  static constexpr int kMaxPeriod = 882;
+  float signal[kSignalSize];
+  createHarmonicSignal(signal, kPeriod);
+  PitchDetector detector;
+  detector.loadSignal(signal, kSignalSize);
+  float match = detector.findYinPeriod(kMaxPeriod);
+  expect(match < kMaxPeriod, "Period was outside of the search range.");
+  expect(std::abs(match - 3.0f * kPeriod) < 3.0f * kMaxPeriodError,
+         "Detected period " + String(match) + " for signal with period " + String(kPeriod));
+}
+
+static PitchDetectorTest pitch_detector_test;
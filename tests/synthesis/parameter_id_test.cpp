@@ -0,0 +1,62 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "parameter_id_test.h"
+#include "sound_engine.h"
+#include "synth_parameters.h"
+
+void ParameterIdTest::runTest() {
+  testDenseIds();
+  testEngineControls();
+}
+
+void ParameterIdTest::testDenseIds() {
+  beginTest("Dense Ids");
+  int num_parameters = vital::Parameters::getNumParameters();
+  expect(num_parameters > 0);
+
+  for (int i = 0; i < num_parameters; ++i) {
+    const vital::ValueDetails* details = vital::Parameters::getDetails(i);
+    expectEquals(details->id, i);
+    expectEquals(vital::Parameters::getId(details->name), i);
+    expectEquals(vital::Parameters::getDetails(details->name).id, i);
+  }
+
+  expectEquals(vital::Parameters::getId("not_a_parameter"), -1);
+  expect(vital::Parameters::getDetails("osc_1_on").default_value == 1.0f);
+  expect(vital::Parameters::getDetails(vital::Parameters::getId("osc_1_on"))->default_value == 1.0f);
+}
+
+void ParameterIdTest::testEngineControls() {
+  beginTest("Engine Controls");
+  vital::SoundEngine engine;
+  vital::control_map controls = engine.getControls();
+  for (auto& control : controls) {
+    int id = vital::Parameters::getId(control.first);
+    expect(id >= 0, "Control " + control.first + " isn't a parameter.");
+    if (id >= 0)
+      expect(engine.getControl(id) == control.second);
+  }
+
+  int num_controls = 0;
+  for (int i = 0; i < vital::Parameters::getNumParameters(); ++i) {
+    if (engine.getControl(i))
+      num_controls++;
+  }
+  expectEquals(num_controls, static_cast<int>(controls.size()));
+}
+
+static ParameterIdTest parameter_id_test;
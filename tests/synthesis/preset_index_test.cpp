@@ -0,0 +1,138 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "preset_index_test.h"
+#include "load_save.h"
+#include "preset_index.h"
+
+namespace {
+  void writeIndexedPreset(const File& file, const std::string& author, const std::string& style,
+                          const std::string& comments) {
+    json data;
+    data["author"] = author;
+    data["preset_style"] = style;
+    data["comments"] = comments;
+    data["settings"] = json::object();
+    file.getParentDirectory().createDirectory();
+    file.replaceWithText(data.dump());
+  }
+
+  int countPresets(PresetIndex& index, const File& folder) {
+    Array<File> presets;
+    if (!index.getPresets(folder, presets))
+      return -1;
+    return presets.size();
+  }
+} // namespace
+
+void PresetIndexTest::runTest() {
+  testIncrementalUpdate();
+  testSaveAndLoad();
+}
+
+void PresetIndexTest::testIncrementalUpdate() {
+  beginTest("Incremental Update");
+  TemporaryFile temporary_directory;
+  File root = temporary_directory.getFile();
+  File bass = root.getChildFile("Bass").getChildFile("Deep Sub.vital");
+  File pad = root.getChildFile("Pads").getChildFile("Glass Pad.vital");
+  File sibling = root.getChildFile("Bass Extra").getChildFile("Other.vital");
+  writeIndexedPreset(bass, "Someone", "Bass", "Rumbles nicely");
+  writeIndexedPreset(pad, "Another Author", "Pad", "");
+  writeIndexedPreset(sibling, "Someone", "Bass", "");
+  root.getChildFile("notes.txt").replaceWithText("not a preset");
+
+  PresetIndex index;
+  expect(!index.hasScanned());
+  expectEquals(countPresets(index, File()), -1);
+
+  std::vector<File> roots = { root };
+  expect(index.update(roots));
+  expectEquals(countPresets(index, File()), 3);
+  expectEquals(countPresets(index, root.getChildFile("Bass")), 1);
+  expectEquals(countPresets(index, root), 3);
+  expectEquals(countPresets(index, File::getSpecialLocation(File::tempDirectory)), -1);
+
+  std::shared_ptr<const PresetIndex::EntryMap> entries = index.entries();
+  const PresetIndex::Entry& bass_entry = entries->at(bass.getFullPathName().toStdString());
+  expect(bass_entry.name == "Deep Sub");
+  expect(bass_entry.author == "Someone");
+  expect(bass_entry.style == "bass");
+  expect(bass_entry.size == bass.getSize());
+  expect(!bass_entry.hash.empty());
+
+  StringArray search;
+  search.addTokens("sub rumble", " ", "");
+  expect(bass_entry.matches(search));
+  search.add("pad");
+  expect(!bass_entry.matches(search));
+
+  expect(!index.update(roots));
+  expect(index.entries() == entries);
+
+  writeIndexedPreset(bass, "Someone Else", "Bass", "");
+  index.invalidate(bass);
+  expect(index.update(roots));
+  expect(index.entries()->at(bass.getFullPathName().toStdString()).author == "Someone Else");
+  expect(index.entries()->at(pad.getFullPathName().toStdString()).author == "Another Author");
+
+  pad.deleteFile();
+  index.invalidate(pad);
+  expect(index.update(roots));
+  expectEquals(countPresets(index, File()), 2);
+
+  root.deleteRecursively();
+}
+
+void PresetIndexTest::testSaveAndLoad() {
+  beginTest("Save And Load");
+  TemporaryFile temporary_directory;
+  File root = temporary_directory.getFile();
+  File preset = root.getChildFile("Keys").getChildFile("Electric.vital");
+  writeIndexedPreset(preset, "Writer", "Keys", "Warm tines");
+
+  PresetIndex index;
+  std::vector<File> roots = { root };
+  index.update(roots);
+
+  TemporaryFile index_file;
+  expect(index.save(index_file.getFile()));
+
+  PresetIndex loaded;
+  expect(loaded.load(index_file.getFile()));
+  expect(loaded.hasScanned());
+  expectEquals(countPresets(loaded, root.getChildFile("Keys")), 1);
+
+  const PresetIndex::Entry& entry = loaded.entries()->at(preset.getFullPathName().toStdString());
+  const PresetIndex::Entry& original = index.entries()->at(preset.getFullPathName().toStdString());
+  expect(entry.author == "Writer");
+  expect(entry.style == "keys");
+  expect(entry.modified == original.modified);
+  expect(entry.hash == original.hash);
+  expect(entry.tokens == original.tokens);
+  expect(!loaded.update(roots));
+
+  MemoryBlock data;
+  index_file.getFile().loadFileAsData(data);
+  index_file.getFile().replaceWithData(data.getData(), data.getSize() / 2);
+  PresetIndex truncated;
+  expect(!truncated.load(index_file.getFile()));
+  expect(!truncated.hasScanned());
+
+  root.deleteRecursively();
+}
+
+static PresetIndexTest preset_index_test;
@@ -15,11 +15,323 @@
  */
 
 #include "sample_source_test.h"
+#include "load_save.h"
 #include "sample_source.h"
 
+namespace {
+  constexpr int kTestSampleLength = 4096;
+  constexpr int kTestSampleRate = 44100;
+  constexpr int kMaxBuildWaitMs = 2000;
+  constexpr vital::mono_float kOctavesUpDelta = 8.0f * (1 << vital::Sample::kUpsampleTimes);
+
+  // Each test loads different audio so levels built by another test aren't shared through the sample cache.
+  void fillTestSample(vital::mono_float* buffer, vital::mono_float seed) {
+    for (int i = 0; i < kTestSampleLength; ++i)
+      buffer[i] = sinf(seed * i) * 0.5f + seed;
+  }
+
+  constexpr int kStreamLength = 200000;
+
+  vital::mono_float streamValue(int64_t index) {
+    return sinf(0.01f * index) * 0.5f + 0.25f * sinf(0.37f * index);
+  }
+
+  class TestStreamReader : public vital::SampleStream::Reader {
+    public:
+      int64_t length() const override { return kStreamLength; }
+      int sampleRate() const override { return kTestSampleRate; }
+      bool stereo() const override { return false; }
+
+      void read(vital::mono_float* left, vital::mono_float* right, int64_t start, int num_samples) override {
+        for (int i = 0; i < num_samples; ++i) {
+          int64_t index = start + i;
+          left[i] = index >= 0 && index < kStreamLength ? streamValue(index) : 0.0f;
+        }
+      }
+  };
+
+  // Records whether two threads were ever inside read at once.
+  class OverlapStreamReader : public TestStreamReader {
+    public:
+      OverlapStreamReader(std::atomic<bool>* overlapped) : overlapped_(overlapped), active_(0) { }
+
+      void read(vital::mono_float* left, vital::mono_float* right, int64_t start, int num_samples) override {
+        if (active_++)
+          overlapped_->store(true);
+        Thread::sleep(1);
+        TestStreamReader::read(left, right, start, num_samples);
+        active_--;
+      }
+
+    private:
+      std::atomic<bool>* overlapped_;
+      std::atomic<int> active_;
+  };
+
+  class CursorFillThread : public Thread {
+    public:
+      CursorFillThread(vital::SampleStream* stream, vital::SampleStream::Cursor* cursor) :
+          Thread("Cursor Fill"), stream_(stream), cursor_(cursor) { }
+
+      void run() override {
+        stream_->fillCursor(cursor_);
+      }
+
+    private:
+      vital::SampleStream* stream_;
+      vital::SampleStream::Cursor* cursor_;
+  };
+} // namespace
+
+class TestSample : public vital::Sample {
+  public:
+    int numReadyLevels() {
+      int ready = 0;
+      for (int i = 0; i < current_data_->num_levels; ++i)
+        ready += current_data_->isLevelReady(i) ? 1 : 0;
+      return ready;
+    }
+};
+
 void SampleSourceTest::runTest() {
   vital::SampleSource sample_source;
   runInputBoundsTest(&sample_source);
+
+  testLazyLevels();
+  testInlineLevels();
+  testStreamBlocks();
+  testStreamUnderrun();
+  testStreamIdle();
+  testStreamRetrigger();
+  testStreamConcurrentReads();
+  testStreamPlayback();
+}
+
+void SampleSourceTest::testLazyLevels() {
+  beginTest("Lazy Levels");
+  vital::mono_float buffer[kTestSampleLength];
+  fillTestSample(buffer, 0.1f);
+
+  TestSample sample;
+  sample.loadSample(buffer, kTestSampleLength, kTestSampleRate);
+  expect(sample.numReadyLevels() == 1, "Only the original level should exist after loading.");
+
+  sample.markUsed();
+  int requested = vital::utils::ilog2(kOctavesUpDelta);
+  int fallback = sample.getActiveIndex(kOctavesUpDelta);
+  expect(fallback >= vital::Sample::kUpsampleTimes && fallback <= requested);
+  expect(sample.getActiveLeftBuffer(fallback) != nullptr);
+
+  int index = fallback;
+  for (int i = 0; i < kMaxBuildWaitMs && index != requested; ++i) {
+    Thread::sleep(1);
+    index = sample.getActiveIndex(kOctavesUpDelta);
+  }
+  sample.markUnused();
+
+  expect(index == requested, "Background builder never finished the requested level.");
+  expect(sample.numReadyLevels() == requested - vital::Sample::kUpsampleTimes + 1,
+         "Only the levels between the original and the requested one should be built.");
+}
+
+void SampleSourceTest::testInlineLevels() {
+  beginTest("Inline Levels");
+  vital::mono_float buffer[kTestSampleLength];
+  fillTestSample(buffer, 0.2f);
+
+  vital::Sample::setBackgroundLoading(false);
+  TestSample sample;
+  sample.loadSample(buffer, kTestSampleLength, kTestSampleRate);
+
+  sample.markUsed();
+  expect(sample.getActiveIndex(0.5f) == 0);
+  expect(sample.getActiveIndex(kOctavesUpDelta) == vital::utils::ilog2(kOctavesUpDelta));
+  sample.markUnused();
+  vital::Sample::setBackgroundLoading(true);
+
+  expect(sample.numReadyLevels() == vital::utils::ilog2(kOctavesUpDelta) + 1);
+}
+
+void SampleSourceTest::testStreamBlocks() {
+  beginTest("Stream Blocks");
+
+  vital::SampleStream stream(std::make_unique<TestStreamReader>(), "");
+  vital::SampleStream::Cursor* cursor = stream.claimCursor();
+  expect(cursor != nullptr);
+
+  static constexpr int kStart = 5000;
+  cursor->seek(kStart, 0, false);
+  stream.fillCursor(cursor);
+  for (int i = kStart; i < kStart + vital::SampleStream::kNumBlocks * vital::SampleStream::kBlockSize; i += 97) {
+    const vital::SampleStream::Block* block = cursor->findBlock(i);
+    expect(block != nullptr, "Filled ring is missing a block.");
+    if (block)
+      expectEquals(block->left[i - block->start + vital::SampleStream::kBlockPadding], streamValue(i));
+  }
+
+  // Band limited blocks match the levels built for samples held in memory.
+  std::unique_ptr<vital::mono_float[]> audio = std::make_unique<vital::mono_float[]>(kStreamLength);
+  for (int i = 0; i < kStreamLength; ++i)
+    audio[i] = streamValue(i);
+  TestSample sample;
+  sample.loadSample(audio.get(), kStreamLength, kTestSampleRate);
+  static constexpr int kLevel = 2;
+  sample.markUsed();
+  vital::Sample::setBackgroundLoading(false);
+  int index = sample.getActiveIndex((1 << (vital::Sample::kUpsampleTimes + kLevel)) + 0.5f);
+  vital::Sample::setBackgroundLoading(true);
+  const vital::mono_float* level_buffer = sample.getActiveLeftBuffer(index) + vital::Sample::kBufferSamples;
+
+  cursor->seek(kStart, kLevel, false);
+  stream.fillCursor(cursor);
+  for (int i = kStart; i < kStart + 2 * vital::SampleStream::kBlockSize; i += 31) {
+    const vital::SampleStream::Block* block = cursor->findBlock(i);
+    expect(block != nullptr);
+    if (block) {
+      vital::mono_float value = block->left[i - block->start + vital::SampleStream::kBlockPadding];
+      expect(std::abs(value - level_buffer[i]) < 1e-5f, "Streamed level doesn't match the in memory level.");
+    }
+  }
+  sample.markUnused();
+  stream.releaseCursor(cursor);
+}
+
+void SampleSourceTest::testStreamIdle() {
+  beginTest("Stream Idle");
+
+  vital::SampleStream stream(std::make_unique<TestStreamReader>(), "");
+  expect(!stream.fillCursors(), "A stream without cursors shouldn't keep the thread polling.");
+
+  vital::SampleStream::Cursor* cursor = stream.claimCursor();
+  expect(!stream.fillCursors(), "A cursor that never seeked shouldn't keep the thread polling.");
+
+  cursor->seek(0, 0, false);
+  expect(stream.fillCursors(), "A seek should keep the thread polling.");
+  expect(!stream.fillCursors(), "A cursor that stopped moving shouldn't keep the thread polling.");
+
+  cursor->setPlayPosition(vital::SampleStream::kBlockSize);
+  expect(stream.fillCursors(), "A playing cursor should keep the thread polling.");
+  expect(!stream.fillCursors());
+  stream.releaseCursor(cursor);
+}
+
+void SampleSourceTest::testStreamUnderrun() {
+  beginTest("Stream Underrun");
+
+  vital::SampleStream stream(std::make_unique<TestStreamReader>(), "");
+  vital::SampleStream::Cursor* cursor = stream.claimCursor();
+  cursor->seek(0, 0, false);
+  expect(cursor->findBlock(0) == nullptr, "Nothing should be readable before the stream thread fills the ring.");
+
+  stream.fillCursor(cursor);
+  expect(cursor->findBlock(100) != nullptr);
+
+  // A seek invalidates everything already in the ring.
+  static constexpr int kSeek = 100000;
+  cursor->seek(kSeek, 0, false);
+  expect(cursor->findBlock(kSeek) == nullptr, "Blocks from before a seek should be skipped.");
+  stream.fillCursor(cursor);
+  expect(cursor->findBlock(kSeek) != nullptr);
+
+  // Playback that ran past the ring during an underrun is where filling resumes.
+  static constexpr int kAhead = kSeek + 40 * vital::SampleStream::kBlockSize;
+  expect(cursor->findBlock(kAhead) == nullptr);
+  cursor->setPlayPosition(kAhead);
+  stream.fillCursor(cursor);
+  expect(cursor->findBlock(kAhead) != nullptr, "Filling didn't catch up to playback.");
+
+  // Non looping streams stop filling at the end of the audio.
+  cursor->seek(kStreamLength - 10, 0, false);
+  expect(cursor->findBlock(kStreamLength - 10) == nullptr);
+  stream.fillCursor(cursor);
+  expect(cursor->findBlock(kStreamLength - 5) != nullptr);
+  expect(cursor->findBlock(kStreamLength + vital::SampleStream::kBlockSize) == nullptr);
+
+  // Looping streams wrap around.
+  cursor->seek(kStreamLength - 10, 0, true);
+  expect(cursor->findBlock(kStreamLength - 10) == nullptr);
+  stream.fillCursor(cursor);
+  const vital::SampleStream::Block* block = cursor->findBlock(kStreamLength + 10);
+  expect(block != nullptr);
+  if (block)
+    expectEquals(block->left[kStreamLength + 10 - block->start + vital::SampleStream::kBlockPadding], streamValue(10));
+
+  for (int i = 1; i < vital::SampleStream::kMaxCursors; ++i)
+    expect(stream.claimCursor() != nullptr);
+  expect(stream.claimCursor() == nullptr, "Claimed more cursors than the stream has.");
+}
+
+void SampleSourceTest::testStreamRetrigger() {
+  beginTest("Stream Retrigger");
+
+  vital::SampleStream stream(std::make_unique<TestStreamReader>(), "");
+  stream.setHeadLength(vital::SampleStream::kHeadSamples);
+  int64_t head_end = stream.headEnd(0);
+  vital::SampleStream::Cursor* cursor = stream.claimCursor();
+
+  // Voices playing from the head never read the ring, so a retrigger finds it still full.
+  cursor->seek(head_end, 0, false);
+  stream.fillCursor(cursor);
+  cursor->seek(head_end, 0, false);
+  stream.fillCursor(cursor);
+
+  int underruns = 0;
+  for (int64_t i = head_end; i < head_end + 4 * vital::SampleStream::kBlockSize; ++i) {
+    const vital::SampleStream::Block* block = cursor->findBlock(i);
+    if (block == nullptr)
+      underruns++;
+    else if (block->left[i - block->start + vital::SampleStream::kBlockPadding] != streamValue(i))
+      underruns++;
+  }
+  expect(underruns == 0, "Retriggered voice underran where the head ends.");
+  stream.releaseCursor(cursor);
+}
+
+void SampleSourceTest::testStreamConcurrentReads() {
+  beginTest("Stream Concurrent Reads");
+
+  static constexpr int kStreamThreadTimeoutMs = 5000;
+  std::atomic<bool> overlapped(false);
+  vital::SampleStream stream(std::make_unique<OverlapStreamReader>(&overlapped), "");
+  vital::SampleStream::Cursor* stream_thread_cursor = stream.claimCursor();
+  vital::SampleStream::Cursor* audio_thread_cursor = stream.claimCursor();
+  stream_thread_cursor->seek(0, 0, false);
+  audio_thread_cursor->seek(kStreamLength / 2, 0, false);
+
+  // The audio thread fills its own cursor when background loading is off, while another cursor may be filling.
+  CursorFillThread fill_thread(&stream, stream_thread_cursor);
+  fill_thread.startThread();
+  stream.fillCursor(audio_thread_cursor);
+  fill_thread.stopThread(kStreamThreadTimeoutMs);
+
+  expect(!overlapped.load(), "Stream reader was called from two threads at once.");
+  expect(stream_thread_cursor->findBlock(0) != nullptr);
+  expect(audio_thread_cursor->findBlock(kStreamLength / 2) != nullptr);
+  stream.releaseCursor(stream_thread_cursor);
+  stream.releaseCursor(audio_thread_cursor);
+}
+
+void SampleSourceTest::testStreamPlayback() {
+  beginTest("Stream Playback");
+
+  vital::SampleSource sample_source;
+  sample_source.getSample()->loadStream(std::make_unique<TestStreamReader>(), "");
+  expect(sample_source.getSample()->getStream() != nullptr);
+  expect(sample_source.getSample()->originalLength() == vital::SampleStream::kHeadSamples);
+  expect(sample_source.getSample()->stateToJson().count("stream_file") == 1);
+  runInputBoundsTest(&sample_source);
+
+  // Streamed audio that can't be found is reported and the default sample loads in its place.
+  vital::Sample missing;
+  json missing_state;
+  missing_state["name"] = "Missing Stream";
+  missing_state["stream_file"] = File::getSpecialLocation(File::tempDirectory)
+                                     .getNonexistentChildFile("missing_stream", ".wav").getFullPathName().toStdString();
+  missing_state["length"] = kStreamLength;
+  missing_state["sample_rate"] = kTestSampleRate;
+  expect(!LoadSave::loadSampleState(&missing, missing_state), "Missing stream file wasn't reported.");
+  expect(missing.getStream() == nullptr);
+  expect(missing.getName() == "Missing Stream");
 }
 
 static SampleSourceTest sample_source_test;
@@ -22,5 +22,14 @@ class SampleSourceTest : public ProcessorTest {
   public:
     SampleSourceTest() : ProcessorTest("Sample Source") { }
     void runTest() override;
+
+    void testLazyLevels();
+    void testInlineLevels();
+    void testStreamBlocks();
+    void testStreamUnderrun();
+    void testStreamIdle();
+    void testStreamRetrigger();
+    void testStreamConcurrentReads();
+    void testStreamPlayback();
 };
 
@@ -15,21 +15,34 @@
  */
 
 #include "synthesis/note_handler_test.cpp"
+#include "synthesis/parameter_id_test.cpp"
+#include "synthesis/preset_index_test.cpp"
+#include "synthesis/binary_preset_test.cpp"
+#include "synthesis/control_event_test.cpp"
 #include "synthesis/processor_test.cpp"
 #include "synthesis/poly_utils_test.cpp"
 #include "synthesis/framework/circular_queue_test.cpp"
+#include "synthesis/framework/audio_capture_test.cpp"
 #include "synthesis/framework/matrix_test.cpp"
 #include "synthesis/framework/poly_values_test.cpp"
+#include "synthesis/framework/operator_fusion_test.cpp"
+#include "synthesis/framework/asset_cache_test.cpp"
+#include "synthesis/framework/telemetry_bus_test.cpp"
+#include "synthesis/framework/modulation_block_test.cpp"
+#include "synthesis/framework/processor_router_test.cpp"
 #include "synthesis/lookups/wave_frame_test.cpp"
+#include "synthesis/lookups/pitch_detector_test.cpp"
 #include "synthesis/producers/synth_oscillator_test.cpp"
 #include "synthesis/producers/sample_source_test.cpp"
 #include "synthesis/effects/distortion_test.cpp"
 #include "synthesis/effects/compressor_test.cpp"
 #include "synthesis/effects/phaser_test.cpp"
+#include "synthesis/effects/effect_modulation_test.cpp"
 #include "synthesis/effects/delay_test.cpp"
 #include "synthesis/effects/reverb_test.cpp"
 #include "synthesis/filters/comb_filter_test.cpp"
 #include "synthesis/filters/decimator_test.cpp"
+#include "synthesis/filters/upsampler_test.cpp"
 #include "synthesis/filters/fir_halfband_decimator_test.cpp"
 #include "synthesis/filters/dc_filter_test.cpp"
 #include "synthesis/filters/linkwitz_riley_filter_test.cpp"